@@ -0,0 +1,32 @@
+/**
+ * @file voice_arena.c
+ * @brief W.I.T. Static Allocation Arena Implementation
+ */
+
+#include "voice_arena.h"
+#include <string.h>
+
+/* Initialize arena */
+void voice_arena_init(voice_arena_t* arena, void* memory, size_t size) {
+    uintptr_t start = (uintptr_t)memory;
+    uintptr_t aligned = (start + VOICE_ARENA_ALIGN - 1) &
+                        ~(uintptr_t)(VOICE_ARENA_ALIGN - 1);
+    size_t skip = aligned - start;
+
+    arena->base = (uint8_t*)aligned;
+    arena->size = (memory && size > skip) ? size - skip : 0;
+    arena->used = 0;
+}
+
+/* Carve allocation */
+void* voice_arena_alloc(voice_arena_t* arena, size_t size) {
+    size_t bytes = VOICE_ARENA_SIZE(size);
+    if (bytes == 0 || bytes > arena->size - arena->used) {
+        return NULL;
+    }
+
+    void* ptr = arena->base + arena->used;
+    arena->used += bytes;
+    memset(ptr, 0, bytes);
+    return ptr;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file voice_arena.h
+ * @brief W.I.T. Static Allocation Arena
+ *
+ * Bump allocator over a caller-provided block. Used when the voice
+ * pipeline is built with VOICE_STATIC_ALLOC so every buffer is carved
+ * from one region at init and nothing touches the heap afterwards.
+ * Allocations are cache-line aligned and are released all at once by
+ * discarding the arena.
+ */
+
+#ifndef WIT_VOICE_ARENA_H
+#define WIT_VOICE_ARENA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Configuration */
+#ifndef VOICE_STATIC_ALLOC
+#define VOICE_STATIC_ALLOC          0       // Build the arena init paths
+#endif
+
+#define VOICE_ARENA_ALIGN           32      // Cache line / DMA alignment
+
+/* Bytes an allocation of n bytes consumes */
+#define VOICE_ARENA_SIZE(n) \
+    (((size_t)(n) + VOICE_ARENA_ALIGN - 1) & ~(size_t)(VOICE_ARENA_ALIGN - 1))
+
+/* Arena state */
+typedef struct {
+    uint8_t* base;              // Aligned start of the block
+    size_t size;                // Usable bytes from base
+    size_t used;                // Bytes handed out
+} voice_arena_t;
+
+/**
+ * @brief Initialize an arena over a memory block
+ * @param arena Arena state
+ * @param memory Block to carve from
+ * @param size Size of the block in bytes
+ *
+ * An unaligned block loses up to VOICE_ARENA_ALIGN - 1 bytes at the
+ * start; size queries include that slack.
+ */
+void voice_arena_init(voice_arena_t* arena, void* memory, size_t size);
+
+/**
+ * @brief Carve a zeroed, aligned allocation
+ * @param arena Arena state
+ * @param size Bytes requested
+ * @return Pointer or NULL if the arena is exhausted
+ */
+void* voice_arena_alloc(voice_arena_t* arena, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_ARENA_H */
@@ -0,0 +1,228 @@
+/**
+ * @file voice_beamform.c
+ * @brief W.I.T. Delay-and-Sum Beamformer Implementation
+ */
+
+#include "voice_beamform.h"
+#include <string.h>
+#include <math.h>
+
+/* Internal Constants */
+#define FIR_CENTER              (BEAMFORM_FIR_TAPS / 2 - 1)
+#define DEGREES_PER_STEP        (360.0f / BEAMFORM_ANGLE_STEPS)
+
+/* Design the windowed-sinc fractional-delay bank */
+static void design_fir_bank(voice_beamformer_t* bf) {
+    for (int p = 0; p < BEAMFORM_FRAC_PHASES; p++) {
+        float frac = (float)p / BEAMFORM_FRAC_PHASES;
+        float taps[BEAMFORM_FIR_TAPS];
+        float sum = 0.0f;
+
+        for (int k = 0; k < BEAMFORM_FIR_TAPS; k++) {
+            float t = (float)(k - FIR_CENTER) - frac;
+            float sinc = (fabsf(t) < 1e-6f) ? 1.0f : sinf(M_PI * t) / (M_PI * t);
+            float window = 0.5f + 0.5f * cosf(M_PI * t / (BEAMFORM_FIR_TAPS / 2));
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+
+        /* Unity gain at DC for every phase */
+        for (int k = 0; k < BEAMFORM_FIR_TAPS; k++) {
+            bf->fir[p][k] = VOICE_COEF(taps[k] / sum);
+        }
+    }
+}
+
+/* Precompute steering delays for every quantized direction */
+static void build_steering_tables(voice_beamformer_t* bf,
+                                  const float mic_xy[VOICE_CHANNELS][2]) {
+    for (int a = 0; a < BEAMFORM_ANGLE_STEPS; a++) {
+        float rad = a * DEGREES_PER_STEP * M_PI / 180.0f;
+        float ux = cosf(rad);
+        float uy = sinf(rad);
+
+        /* Arrival lead of each microphone in samples */
+        float lead[VOICE_CHANNELS];
+        float min_lead = 0.0f;
+        for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+            lead[ch] = (mic_xy[ch][0] * ux + mic_xy[ch][1] * uy) *
+                       VOICE_SAMPLE_RATE / BEAMFORM_SPEED_OF_SOUND;
+            if (ch == 0 || lead[ch] < min_lead) {
+                min_lead = lead[ch];
+            }
+        }
+
+        /* Delay every channel to line up with the last arrival */
+        for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+            int q = (int)lroundf((lead[ch] - min_lead) * BEAMFORM_FRAC_PHASES);
+            int delay = q / BEAMFORM_FRAC_PHASES;
+            int phase = q % BEAMFORM_FRAC_PHASES;
+
+            if (delay >= BEAMFORM_MAX_DELAY) {
+                delay = BEAMFORM_MAX_DELAY;
+                phase = 0;
+            }
+
+            bf->steering[a][ch].delay = (uint16_t)delay;
+            bf->steering[a][ch].phase = (uint8_t)phase;
+        }
+    }
+}
+
+/* Initialize beamformer */
+void voice_beamform_init(voice_beamformer_t* bf,
+                         const float mic_xy[VOICE_CHANNELS][2]) {
+    memset(bf, 0, sizeof(voice_beamformer_t));
+
+    design_fir_bank(bf);
+    build_steering_tables(bf, mic_xy);
+    voice_dsp_select_kernels(&bf->kernels, VOICE_CHANNELS, VOICE_FRAME_SIZE);
+
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        bf->weights[ch] = VOICE_COEF(1.0f / VOICE_CHANNELS);
+    }
+
+    bf->active = bf->passthrough;
+    bf->active_index = 0;
+}
+
+/* Select look direction */
+int voice_beamform_steer(voice_beamformer_t* bf, float angle_degrees) {
+    int index = (int)lroundf(angle_degrees / DEGREES_PER_STEP) % BEAMFORM_ANGLE_STEPS;
+    if (index < 0) {
+        index += BEAMFORM_ANGLE_STEPS;
+    }
+
+    bf->active_index = index;
+    if (bf->active != bf->passthrough) {
+        bf->active = bf->steering[index];
+    }
+
+    return index;
+}
+
+/* Enable or disable steering */
+void voice_beamform_enable(voice_beamformer_t* bf, bool enable) {
+    bf->active = enable ? bf->steering[bf->active_index] : bf->passthrough;
+}
+
+/* Get channel delay */
+float voice_beamform_get_delay(const voice_beamformer_t* bf, int channel) {
+    if (channel < 0 || channel >= VOICE_CHANNELS) {
+        return 0.0f;
+    }
+
+    const beamform_steer_t* st = &bf->active[channel];
+    return st->delay + (float)st->phase / BEAMFORM_FRAC_PHASES;
+}
+
+/* Beamform one frame */
+void voice_beamform_process(voice_beamformer_t* bf,
+                            const int16_t* samples,
+                            int16_t* output) {
+    voice_beamform_process_lines(bf, &bf->lines, samples, output);
+}
+
+/* Beamform one frame through a stream's delay lines */
+void voice_beamform_process_lines(const voice_beamformer_t* bf,
+                                  voice_beamform_lines_t* lines,
+                                  const int16_t* samples,
+                                  int16_t* output) {
+#if VOICE_FIXED_POINT
+    /* Q15 products; weights sum to one, so 32 bits cannot overflow */
+    int32_t acc[VOICE_FRAME_SIZE];
+#else
+    float acc[VOICE_FRAME_SIZE];
+#endif
+    memset(acc, 0, sizeof(acc));
+
+    /* Append the new frame behind every delay-line history */
+    int16_t* tails[VOICE_CHANNELS];
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        tails[ch] = &lines->history[ch][BEAMFORM_HISTORY];
+    }
+    bf->kernels.deinterleave(&bf->kernels, samples, tails);
+
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        int16_t* line = lines->history[ch];
+        const beamform_steer_t* st = &bf->active[ch];
+#if VOICE_FIXED_POINT
+        int32_t w = bf->weights[ch];
+#else
+        float w = bf->weights[ch];
+#endif
+
+        if (st->phase == 0) {
+            /* Integer delay: the FIR reduces to its center tap */
+            const int16_t* x = &line[BEAMFORM_HISTORY - st->delay - FIR_CENTER];
+            for (int n = 0; n < VOICE_FRAME_SIZE; n++) {
+                acc[n] += w * x[n];
+            }
+        } else {
+            const voice_coef_t* h = bf->fir[st->phase];
+            const int16_t* x = &line[BEAMFORM_HISTORY - st->delay];
+            for (int n = 0; n < VOICE_FRAME_SIZE; n++) {
+#if VOICE_FIXED_POINT
+                int32_t sum = 0;
+                for (int k = 0; k < BEAMFORM_FIR_TAPS; k++) {
+                    sum += (int32_t)h[k] * x[n - k];
+                }
+                acc[n] += w * ((sum + (1 << 14)) >> 15);
+#else
+                float sum = 0.0f;
+                for (int k = 0; k < BEAMFORM_FIR_TAPS; k++) {
+                    sum += h[k] * x[n - k];
+                }
+                acc[n] += w * sum;
+#endif
+            }
+        }
+
+        /* Keep the tail as history for the next frame */
+        memmove(line, &line[VOICE_FRAME_SIZE], BEAMFORM_HISTORY * sizeof(int16_t));
+    }
+
+    for (int n = 0; n < VOICE_FRAME_SIZE; n++) {
+#if VOICE_FIXED_POINT
+        /* Truncate toward zero like the float conversion */
+        int32_t bias = (acc[n] < 0) ? (1 << 15) - 1 : 0;
+        output[n] = voice_dsp_sat16((acc[n] + bias) >> 15);
+#else
+        output[n] = (int16_t)fminf(fmaxf(acc[n], -32768.0f), 32767.0f);
+#endif
+    }
+}
+
+/* Stateless downmix */
+void voice_beamform_downmix(const voice_beamformer_t* bf,
+                            const int16_t* samples,
+                            size_t num_samples,
+                            int16_t* output) {
+    for (size_t n = 0; n < num_samples; n++) {
+        const int16_t* x = &samples[n * VOICE_CHANNELS];
+#if VOICE_FIXED_POINT
+        int32_t acc = 0;
+        for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+            acc += (int32_t)bf->weights[ch] * x[ch];
+        }
+        int32_t bias = (acc < 0) ? (1 << 15) - 1 : 0;
+        output[n] = voice_dsp_sat16((acc + bias) >> 15);
+#else
+        float acc = 0.0f;
+        for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+            acc += bf->weights[ch] * x[ch];
+        }
+        output[n] = (int16_t)fminf(fmaxf(acc, -32768.0f), 32767.0f);
+#endif
+    }
+}
+
+/* Clear history */
+void voice_beamform_reset(voice_beamformer_t* bf) {
+    voice_beamform_lines_reset(&bf->lines);
+}
+
+/* Clear a stream's history */
+void voice_beamform_lines_reset(voice_beamform_lines_t* lines) {
+    memset(lines->history, 0, sizeof(lines->history));
+}
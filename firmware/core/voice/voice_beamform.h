@@ -0,0 +1,151 @@
+/**
+ * @file voice_beamform.h
+ * @brief W.I.T. Delay-and-Sum Beamformer
+ *
+ * Fractional-delay delay-and-sum beamformer for the microphone array.
+ * Steering delays for a quantized set of look directions are computed
+ * once from the array geometry; fractional delays are applied with a
+ * polyphase windowed-sinc FIR bank, so the per-frame path performs no
+ * trigonometry. Fixed-point builds hold the taps and weights in Q15 and
+ * accumulate in 32 bits.
+ */
+
+#ifndef WIT_VOICE_BEAMFORM_H
+#define WIT_VOICE_BEAMFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "voice_core.h"
+#include "voice_dsp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Configuration */
+#define BEAMFORM_ANGLE_STEPS        72      // 5 degree steering resolution
+#define BEAMFORM_FRAC_PHASES        8       // 1/8 sample delay resolution
+#define BEAMFORM_FIR_TAPS           8       // Taps per fractional-delay phase
+#define BEAMFORM_MAX_DELAY          32      // Max integer delay (samples)
+#define BEAMFORM_SPEED_OF_SOUND     343.0f  // m/s
+
+#define BEAMFORM_HISTORY            (BEAMFORM_MAX_DELAY + BEAMFORM_FIR_TAPS - 1)
+
+/* Per-microphone steering entry */
+typedef struct {
+    uint16_t delay;             // Integer delay in samples
+    uint8_t phase;              // Fractional delay phase index
+} beamform_steer_t;
+
+/* Delay lines of one stream through the beamformer */
+typedef struct {
+    int16_t history[VOICE_CHANNELS][BEAMFORM_HISTORY + VOICE_FRAME_SIZE];
+} voice_beamform_lines_t;
+
+/* Beamformer state */
+typedef struct {
+    beamform_steer_t steering[BEAMFORM_ANGLE_STEPS][VOICE_CHANNELS];
+    beamform_steer_t passthrough[VOICE_CHANNELS];
+    voice_coef_t fir[BEAMFORM_FRAC_PHASES][BEAMFORM_FIR_TAPS];
+    voice_coef_t weights[VOICE_CHANNELS];
+    const beamform_steer_t* active;
+    int active_index;
+    voice_dsp_kernels_t kernels;
+    voice_beamform_lines_t lines;   // The live stream's
+} voice_beamformer_t;
+
+/**
+ * @brief Build steering tables and FIR bank
+ * @param bf Beamformer state
+ * @param mic_xy Microphone x/y positions in meters
+ *
+ * Steering starts disabled (plain weighted sum). Frame kernels for the
+ * VOICE_CHANNELS x VOICE_FRAME_SIZE geometry are selected here.
+ */
+void voice_beamform_init(voice_beamformer_t* bf,
+                         const float mic_xy[VOICE_CHANNELS][2]);
+
+/**
+ * @brief Select the look direction
+ * @param bf Beamformer state
+ * @param angle_degrees Direction in degrees (0-360)
+ * @return Quantized steering index
+ */
+int voice_beamform_steer(voice_beamformer_t* bf, float angle_degrees);
+
+/**
+ * @brief Enable or disable steering
+ * @param bf Beamformer state
+ * @param enable false falls back to an undelayed weighted sum
+ */
+void voice_beamform_enable(voice_beamformer_t* bf, bool enable);
+
+/**
+ * @brief Get the fractional delay applied to a channel
+ * @param bf Beamformer state
+ * @param channel Channel index
+ * @return Delay in samples relative to the earliest microphone
+ */
+float voice_beamform_get_delay(const voice_beamformer_t* bf, int channel);
+
+/**
+ * @brief Beamform one frame to mono
+ * @param bf Beamformer state
+ * @param samples Interleaved input, VOICE_FRAME_SIZE x VOICE_CHANNELS
+ * @param output Mono output, VOICE_FRAME_SIZE samples
+ */
+void voice_beamform_process(voice_beamformer_t* bf,
+                            const int16_t* samples,
+                            int16_t* output);
+
+/**
+ * @brief Beamform one frame of another stream to mono
+ * @param bf Beamformer state (steering and taps)
+ * @param lines The stream's delay lines
+ * @param samples Interleaved input, VOICE_FRAME_SIZE x VOICE_CHANNELS
+ * @param output Mono output, VOICE_FRAME_SIZE samples
+ *
+ * For audio outside the live stream, such as history read back from
+ * the circular buffer, steered as the live stream is. Once the lines
+ * hold the frame before, output matches what voice_beamform_process()
+ * gave for the same frame under the same steering.
+ */
+void voice_beamform_process_lines(const voice_beamformer_t* bf,
+                                  voice_beamform_lines_t* lines,
+                                  const int16_t* samples,
+                                  int16_t* output);
+
+/**
+ * @brief Clear a stream's delay lines
+ * @param lines Delay lines
+ */
+void voice_beamform_lines_reset(voice_beamform_lines_t* lines);
+
+/**
+ * @brief Undelayed weighted downmix, leaving the delay lines untouched
+ * @param bf Beamformer state
+ * @param samples Interleaved input, num_samples x VOICE_CHANNELS
+ * @param num_samples Samples per channel
+ * @param output Mono output, num_samples samples
+ *
+ * For audio outside the live stream, such as history read back from
+ * the circular buffer. Matches unsteered voice_beamform_process()
+ * output, less its FIR_CENTER sample alignment delay.
+ */
+void voice_beamform_downmix(const voice_beamformer_t* bf,
+                            const int16_t* samples,
+                            size_t num_samples,
+                            int16_t* output);
+
+/**
+ * @brief Clear delay-line history
+ * @param bf Beamformer state
+ */
+void voice_beamform_reset(voice_beamformer_t* bf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_BEAMFORM_H */
@@ -0,0 +1,130 @@
+/**
+ * @file voice_codec.c
+ * @brief W.I.T. Recording Encoders Implementation
+ */
+
+#include "voice_codec.h"
+#include "voice_core.h"
+#include <string.h>
+
+/* IMA-ADPCM tables */
+static const int16_t step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+    157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+    3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/* Encoder state carried across packets */
+typedef struct {
+    int32_t predictor;
+    int32_t index;
+} adpcm_state_t;
+
+/* Apply one code to the predictor, as the decoder will */
+static void adpcm_step(int32_t* predictor, int32_t* index, uint8_t code) {
+    int32_t step = step_table[*index];
+    int32_t diff = step >> 3;
+    if (code & 4) diff += step;
+    if (code & 2) diff += step >> 1;
+    if (code & 1) diff += step >> 2;
+
+    *predictor += (code & 8) ? -diff : diff;
+    if (*predictor > 32767) *predictor = 32767;
+    if (*predictor < -32768) *predictor = -32768;
+
+    *index += index_table[code];
+    if (*index < 0) *index = 0;
+    if (*index > 88) *index = 88;
+}
+
+/* Quantize one sample against the current step */
+static uint8_t adpcm_code(int32_t predictor, int32_t index, int16_t sample) {
+    int32_t step = step_table[index];
+    int32_t diff = sample - predictor;
+    uint8_t code = 0;
+
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    if (diff >= step) { code |= 4; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { code |= 2; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { code |= 1; }
+
+    return code;
+}
+
+static bool adpcm_init(void* state, uint32_t sample_rate) {
+    adpcm_state_t* st = (adpcm_state_t*)state;
+    st->predictor = 0;
+    st->index = 0;
+    return sample_rate > 0;
+}
+
+static size_t adpcm_encode(void* state, const int16_t* pcm, uint8_t* packet) {
+    adpcm_state_t* st = (adpcm_state_t*)state;
+
+    /* Header: the state this packet starts from */
+    packet[0] = (uint8_t)(st->predictor & 0xFF);
+    packet[1] = (uint8_t)((st->predictor >> 8) & 0xFF);
+    packet[2] = (uint8_t)st->index;
+    packet[3] = 0;
+
+    uint8_t* out = &packet[VOICE_ADPCM_HEADER_BYTES];
+    for (int n = 0; n < VOICE_FRAME_SIZE; n++) {
+        uint8_t code = adpcm_code(st->predictor, st->index, pcm[n]);
+        adpcm_step(&st->predictor, &st->index, code);
+
+        if (n & 1) {
+            out[n / 2] |= (uint8_t)(code << 4);
+        } else {
+            out[n / 2] = code;
+        }
+    }
+
+    return VOICE_ADPCM_PACKET_BYTES(VOICE_FRAME_SIZE);
+}
+
+const voice_encoder_t voice_adpcm_encoder = {
+    .codec = VOICE_CODEC_IMA_ADPCM,
+    .frame_samples = VOICE_FRAME_SIZE,
+    .max_packet_bytes = VOICE_ADPCM_PACKET_BYTES(VOICE_FRAME_SIZE),
+    .state_size = sizeof(adpcm_state_t),
+    .init = adpcm_init,
+    .encode = adpcm_encode
+};
+
+/* Decode one packet */
+size_t voice_adpcm_decode(const uint8_t* packet, size_t packet_bytes,
+                          int16_t* pcm, size_t max_samples) {
+    if (!packet || !pcm || packet_bytes <= VOICE_ADPCM_HEADER_BYTES ||
+        packet[2] > 88) {
+        return 0;
+    }
+
+    int32_t predictor = (int16_t)(packet[0] | (packet[1] << 8));
+    int32_t index = packet[2];
+    size_t samples = (packet_bytes - VOICE_ADPCM_HEADER_BYTES) * 2;
+    if (samples > max_samples) {
+        samples = max_samples;
+    }
+
+    const uint8_t* in = &packet[VOICE_ADPCM_HEADER_BYTES];
+    for (size_t n = 0; n < samples; n++) {
+        uint8_t code = (n & 1) ? (in[n / 2] >> 4) : (in[n / 2] & 0x0F);
+        adpcm_step(&predictor, &index, code);
+        pcm[n] = (int16_t)predictor;
+    }
+
+    return samples;
+}
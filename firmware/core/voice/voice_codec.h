@@ -0,0 +1,69 @@
+/**
+ * @file voice_codec.h
+ * @brief W.I.T. Recording Encoders
+ *
+ * Packet encoders for streamed recordings. Each packet covers a fixed
+ * number of samples and decodes on its own, so a packet lost on the
+ * network costs only its own audio. IMA-ADPCM is built in. Other codecs
+ * (Opus) are supplied by the platform through the same operations; the
+ * voice core allocates their state, so arena builds stay heap-free.
+ */
+
+#ifndef WIT_VOICE_CODEC_H
+#define WIT_VOICE_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* IMA-ADPCM packet: int16 predictor, uint8 step index, uint8 reserved,
+ * then two samples per byte, low nibble first */
+#define VOICE_ADPCM_HEADER_BYTES    4
+#define VOICE_ADPCM_PACKET_BYTES(samples) (VOICE_ADPCM_HEADER_BYTES + ((samples) + 1) / 2)
+
+/* Recording encodings */
+typedef enum {
+    VOICE_CODEC_PCM16 = 0,      // Raw little-endian 16-bit samples
+    VOICE_CODEC_IMA_ADPCM,      // 4 bits per sample, built in
+    VOICE_CODEC_OPUS            // Platform encoder (libopus)
+} voice_codec_t;
+
+/* Encoder operations for one codec */
+typedef struct {
+    voice_codec_t codec;
+    uint32_t frame_samples;     // Samples per packet, a multiple of VOICE_FRAME_SIZE
+    size_t max_packet_bytes;    // Largest packet, at most 2 * frame_samples
+    size_t state_size;          // Encoder state bytes owned by the caller
+    /* Prepare state for a new stream */
+    bool (*init)(void* state, uint32_t sample_rate);
+    /* Encode frame_samples samples; returns packet bytes, 0 on error */
+    size_t (*encode)(void* state, const int16_t* pcm, uint8_t* packet);
+} voice_encoder_t;
+
+/**
+ * @brief Built-in IMA-ADPCM encoder, one packet per voice frame
+ */
+extern const voice_encoder_t voice_adpcm_encoder;
+
+/**
+ * @brief Decode one IMA-ADPCM packet
+ * @param packet Packet produced by voice_adpcm_encoder
+ * @param packet_bytes Packet size in bytes
+ * @param pcm Output samples, (packet_bytes - header) * 2 at most
+ * @param max_samples Capacity of pcm
+ * @return Samples decoded, 0 for a malformed packet
+ *
+ * Reference decoder for hosts and tests; the device only encodes.
+ */
+size_t voice_adpcm_decode(const uint8_t* packet, size_t packet_bytes,
+                          int16_t* pcm, size_t max_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_CODEC_H */
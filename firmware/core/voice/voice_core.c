@@ -4,19 +4,128 @@
  */
 
 #include "voice_core.h"
+#include "voice_pipeline.h"
+#include "voice_ring.h"
+#include "voice_dsp.h"
+#include "voice_beamform.h"
+#include "voice_doa.h"
+#include "voice_denoise.h"
+#include "voice_noise.h"
+#include "wake_word.h"
+#include "voice_arena.h"
+#include "voice_profile.h"
+#include "voice_fifo.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdatomic.h>
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
 #include "timers.h"
 
 /* Internal Constants */
-#define CIRCULAR_BUFFER_SIZE    (VOICE_BUFFER_SIZE * VOICE_CHANNELS * sizeof(int16_t))
+#define CIRCULAR_BUFFER_SAMPLES voice_ring_capacity_for(VOICE_BUFFER_SIZE)
+#define CIRCULAR_BUFFER_SIZE    (CIRCULAR_BUFFER_SAMPLES * VOICE_CHANNELS * sizeof(int16_t))
 #define FFT_SIZE                512
 #define MEL_FILTERS             40
 #define MFCC_COEFFICIENTS       13
+#define FRAME_QUEUE_LENGTH      10
+#define RECORDING_CAPACITY      (VOICE_SAMPLE_RATE * 10 * sizeof(int16_t))
+#define ENERGY_HISTORY_LENGTH   10
+#define VOICE_TASK_STACK        4096
+#define VOICE_TASK_PRIORITY     (tskIDLE_PRIORITY + 3)
+#define WAKE_TASK_PRIORITY      (tskIDLE_PRIORITY + 2)
+#define NOISE_FLOOR_STEP_Q15    1638    // (1 - 0.95) in Q15
+#define NOISE_MIN_BIAS_DB       0.15f   // Frame energy minimum bias per doubling, coloured noise
+#define FRAME_DURATION_MS       (1000 * VOICE_FRAME_SIZE / VOICE_SAMPLE_RATE)
+#define PREROLL_CATCHUP_FRAMES  64      // Live frames a pre-roll is spread over, at most
+#define BEAM_REQUEST_STEER      0x01    // voice_set_beam_direction() pending
+#define BEAM_REQUEST_ADAPTIVE   0x02    // voice_set_adaptive_beam() pending
+
+/* Queued frame reference: points at a pool slot or at DMA memory */
+typedef struct {
+    const int16_t* samples;         // Interleaved samples
+    uint32_t timestamp_ms;          // Capture timestamp
+    uint32_t queued_ms;             // Tick time it was queued
+    voice_frame_t* slot;            // Frame pool slot (copy mode)
+    audio_buffer_t* dma_buffer;     // Driver buffer (zero-copy mode)
+    audio_driver_t* driver;         // Owner of dma_buffer
+} voice_frame_ref_t;
+
+/* Steered read-back of the circular buffer */
+typedef struct {
+    voice_ring_reader_t reader;
+    voice_beamform_lines_t lines;   // Primed by the frame before the first recorded
+    int16_t frame[VOICE_FRAME_SIZE * VOICE_CHANNELS];   // A frame the ring's end splits
+} voice_history_reader_t;
+
+/* Frame under processing, read in place from its source */
+typedef struct {
+    const int16_t* samples;
+    const int16_t* mono;            // Beamformed downmix
+    uint32_t timestamp_ms;
+    uint32_t queued_ms;             // Tick time it was queued
+    voice_db_t energy_db[VOICE_CHANNELS];
+    bool vad_active;
+} voice_frame_view_t;
+
+/* Beamformed frame handed to the wake stage (split pipeline) */
+typedef struct {
+    int16_t mono[VOICE_FRAME_SIZE];
+    uint32_t timestamp_ms;
+    uint32_t queued_ms;
+    uint32_t ring_position;         // Circular buffer position before this frame
+    wake_gate_t gate;               // Tier chosen by the processing task
+    bool onset;                     // Backfill the front-end first
+    voice_db_t score;               // Beam level over the noise floor (pool members)
+    bool active;                    // Voice activity or a pending onset (pool members)
+    bool listening;                 // Queued while idle or listening
+    uint32_t epoch;                 // Detections applied when queued
+    bool reset;                     // Reset and re-prime the engine first
+} voice_wake_job_t;
+
+/* Detection the wake stage hands back to the processing task */
+typedef struct {
+    uint32_t timestamp_ms;          // Audio time of the wake word's end
+    uint32_t queued_ms;             // Queue time of the frame that completed it
+    uint8_t model_index;
+} voice_wake_post_t;
+
+/* Worker pool shared by several contexts */
+struct voice_pool {
+    voice_pool_config_t config;
+    voice_context_t* members[VOICE_POOL_MAX_MEMBERS];  // members[0] is the lead
+    uint32_t num_members;
+    QueueHandle_t run_queue;        // Members with frames waiting, each at most once
+    TaskHandle_t workers[VOICE_POOL_MAX_WORKERS];
+    TaskHandle_t wake_task;
+    voice_context_t* source;        // Array the wake stage listens to
+    voice_pool_stats_t stats;       // Written by the wake task only
+    
+#if VOICE_STATIC_ALLOC
+    /* Static RTOS objects (arena builds) */
+    StaticQueue_t run_queue_buffer;
+    StaticTask_t worker_buffers[VOICE_POOL_MAX_WORKERS];
+    StaticTask_t wake_task_buffer;
+#endif
+    bool from_arena;
+};
+
+/* Subscription slot; the cursor belongs to the subscribed task */
+struct voice_subscriber {
+    voice_context_t* ctx;
+    voice_stream_t stream;
+    voice_ring_reader_t reader;
+    SemaphoreHandle_t ready;        // Given after each write, kept across subscriptions
+    _Atomic bool claimed;           // Slot taken by voice_subscribe()
+    _Atomic bool active;            // Producers signal it
+    uint32_t overruns;
+    
+#if VOICE_STATIC_ALLOC
+    StaticSemaphore_t ready_buffer;
+#endif
+};
 
 /* Voice Context Structure */
 struct voice_context {
@@ -26,9 +135,8 @@ struct voice_context {
     
     /* Audio Buffers */
     int16_t* circular_buffer;
-    size_t buffer_write_idx;
-    size_t buffer_read_idx;
-    SemaphoreHandle_t buffer_mutex;
+    voice_ring_t ring;
+    uint32_t history_limit;         // Samples of history safe to read back
     
     /* Recording Buffer */
     uint8_t* recording_buffer;
@@ -38,23 +146,87 @@ struct voice_context {
     uint32_t recording_start_time;
     uint32_t max_recording_duration;
     
+    /* Streaming Recording (processing task produces, consumer drains) */
+    voice_fifo_t chunk_fifo;
+    voice_recording_chunk_t* chunks;
+    voice_recording_chunk_t* chunk;     // Chunk being filled, if reserved
+    SemaphoreHandle_t chunk_ready;
+    bool utterance_open;                // Recording seen; a streamed final chunk is owed
+    uint32_t chunk_sequence;
+    uint32_t chunk_dropped;             // Samples lost since the last chunk
+    const voice_encoder_t* encoder;
+    void* encoder_state;
+    int16_t* encoder_pcm;               // Samples waiting for a full packet
+    uint32_t encoder_fill;
+    uint32_t encoder_timestamp_ms;      // Capture time of the waiting samples
+    
+    /* Pre-roll (processing task): the ring is read back a few frames per
+     * live frame until it catches up with capture */
+    voice_history_reader_t* preroll;    // With pre-roll only
+    bool preroll_active;                // Live frames wait their turn in the ring
+    bool preroll_closing;               // Recording stopped; the stream closes once caught up
+    uint32_t preroll_skip;              // Frames read only to prime beam and suppressor
+    uint32_t preroll_frames;            // Frames from before the recording, kept whatever the VAD said
+    uint32_t preroll_rate;              // Frames read per live frame
+    uint32_t preroll_timestamp_ms;      // Capture time of the next frame read
+    uint64_t preroll_keep;              // Per live frame not yet read: record it
+    uint32_t preroll_pending;           // Live frames not yet read
+    
     /* Beamforming */
-    float* beamform_weights;
-    float* beamform_delays;
+    voice_beamformer_t* beamformer;
+    int16_t* beam_output;
     float current_steering_angle;
+    voice_doa_t* doa;                   // Talker direction for the adaptive beam
+    uint32_t beam_steers;               // Moves made by the tracker
+    _Atomic uint8_t beam_request;       // BEAM_REQUEST_* asked for since the last frame
+    float steer_request;                // Angle for BEAM_REQUEST_STEER
+    bool adaptive_request;              // Mode for BEAM_REQUEST_ADAPTIVE
+    
+    /* Noise Suppression (recording path, one frame behind) */
+    voice_denoise_t* denoiser;
+    voice_denoise_stream_t* denoise_live;
+    voice_denoise_stream_t* denoise_history;    // Pre-roll replays, with pre-roll only
+    int16_t* denoise_output;
+    float* denoise_work;                // Owned FFT buffer, unless the MFCC one is lent
+    float noise_suppression;            // Requested level
+    float denoise_level;                // Level in effect; changes between utterances
     
     /* Wake Word Detection */
-    void* wake_word_engine;
+    wake_engine_t* wake_word_engine;
     uint32_t last_wake_time;
     float wake_sensitivity;
-    
-    /* Voice Activity Detection */
-    float noise_floor;
+    uint32_t wake_queued_ms;            // Queue time of the frame the engine saw last
+    uint8_t wake_model;                 // Model of the latest detection
+    _Atomic bool wake_unjudged;         // Latest detection not yet reported false
+    bool utterance_speech;              // VAD-active frame recorded this utterance
+    
+    /* Utterance Trace (latest utterance) */
+    voice_trace_t trace;
+    uint32_t trace_sequence;
+    _Atomic uint32_t trace_seqlock;     // Odd while a writer updates trace
+#if VOICE_CORE_AFFINITY
+    portMUX_TYPE trace_lock;            // Serializes writers across cores
+#endif
+    
+    /* Voice Activity Detection (levels in voice_db_t units) */
+    voice_db_t noise_floor;
+    voice_db_t channel_offset[VOICE_CHANNELS];  // Calibrated channel floors over noise_floor
+    voice_db_t avg_energy;
     float* energy_history;
     uint32_t vad_frame_count;
     bool vad_active;
+    voice_noise_tracker_t noise_tracker;        // With noise_tracking_ms only
+    
+    /* Noise Calibration (requested by the caller, run by the processing task) */
+    uint32_t calibration_request;       // Frames asked for, not yet started
+    _Atomic bool reset_request;         // voice_reset() since the last frame
+    bool wake_reset_pending;            // Engine reset for the next wake job
+    uint32_t calibration_frames;        // Frames still to collect
+    voice_noise_min_t calibration[VOICE_CHANNELS];
+    uint32_t noise_calibrations;
     
     /* DSP Buffers */
+    voice_dsp_kernels_t kernels;
     float* fft_buffer;
     float* mel_energies;
     float* mfcc_features;
@@ -62,112 +234,550 @@ struct voice_context {
     /* Statistics */
     voice_stats_t stats;
     uint32_t start_time;
+    voice_profile_stage_t profile[VOICE_STAGE_COUNT];
+    uint32_t queue_high_water;
     
     /* Callbacks */
     voice_audio_callback_t audio_callback;
     void* audio_callback_data;
     
+    /* Subscriber Streams (raw readers share the circular buffer) */
+    voice_subscriber_t subscribers[VOICE_MAX_SUBSCRIBERS];
+    int16_t* mono_buffer;
+    voice_ring_t mono_ring;             // Written by the processing task
+    int16_t* feature_buffer;
+    voice_ring_t feature_ring;          // Written by the wake stage
+    uint32_t feature_position;          // Engine frames already published
+    
+    /* Frame Pool (copy mode) */
+    voice_frame_t* frame_pool;
+    QueueHandle_t free_frames;
+    voice_frame_t* assembly;            // Slot filling from driver periods (producer side)
+    uint32_t assembly_fill;             // Samples per channel in it
+    
+    /* Capture Latency (with latency_control) */
+    audio_driver_t* driver;             // Driver of the last queued buffer
+    audio_latency_mode_t latency_mode;  // Mode last requested from it
+    uint32_t latency_hold_until_ms;
+    uint32_t latency_switches;
+    
     /* Synchronization */
     TaskHandle_t processing_task;
     QueueHandle_t frame_queue;
     TimerHandle_t timeout_timer;
+    _Atomic bool scheduled;         // On the pool's run queue or with a worker
+    
+    /* Split Pipeline (wake stage on its own task) */
+    voice_pipeline_config_t pipeline;
+    voice_fifo_t wake_fifo;
+    voice_wake_job_t* wake_jobs;
+    TaskHandle_t wake_task;
+    uint32_t wake_high_water;       // Written by the processing task only
+    uint32_t wake_drops;            // Written by the processing task only
+    
+    /* Detections off the processing task: the wake stage posts one, the
+     * processing task acts on it before its next frame */
+    voice_wake_post_t wake_post;    // Valid while wake_posted
+    _Atomic bool wake_posted;
+    uint32_t wake_epoch;            // Posts taken; processing task only
+    uint32_t wake_stale_epoch;      // Epoch of the last post; wake stage only
+    bool wake_post_sent;            // Posted by this pass; wake stage only
+    
+    /* Wake Gating */
+    wake_gate_t wake_gate;          // Tier chosen by the processing task
+    wake_gate_t engine_gate;        // Tier applied by the wake stage
+    uint32_t wake_hold_until_ms;
+    uint32_t wake_gate_frames[WAKE_GATE_FULL + 1];
+    uint32_t wake_backfills;
+    voice_history_reader_t* wake_history;   // Onset backfill (wake stage); gated or pooled only
+    
+#if VOICE_STATIC_ALLOC
+    /* Static RTOS objects (arena builds) */
+    StaticQueue_t frame_queue_buffer;
+    StaticQueue_t free_frames_buffer;
+    StaticTimer_t timeout_timer_buffer;
+    StaticTask_t processing_task_buffer;
+    StaticTask_t wake_task_buffer;
+    StaticSemaphore_t chunk_ready_buffer;
+#endif
+    bool from_arena;
 };
 
 /* Forward Declarations */
 static void voice_processing_task(void* param);
+static void voice_wake_task(void* param);
+static void voice_pool_worker(void* param);
+static void voice_pool_wake_task(void* param);
+static void process_frame(voice_context_t* ctx, const voice_frame_ref_t* ref);
+static void submit_wake_job(voice_context_t* ctx, const voice_frame_view_t* frame,
+                            wake_gate_t gate, bool onset, uint32_t ring_position);
+static wake_gate_t update_wake_gate(voice_context_t* ctx, const voice_frame_view_t* frame);
+static void run_wake_stage(voice_context_t* ctx, voice_context_t* source,
+                           const voice_frame_view_t* frame,
+                           wake_gate_t gate, bool onset, uint32_t ring_position);
+static void reset_wake_gate(voice_context_t* ctx);
+static void prime_wake_engine(voice_context_t* ctx);
+static void reset_wake_engine(voice_context_t* ctx);
+static uint32_t history_samples(const voice_context_t* ctx, uint32_t samples,
+                                uint32_t ring_position);
+static void history_reader_init(const voice_context_t* source,
+                                voice_history_reader_t* history, uint32_t position);
+static bool read_history_frame(voice_context_t* source, voice_history_reader_t* history,
+                               int16_t* mono);
+static void open_utterance(voice_context_t* ctx, const voice_frame_view_t* frame);
+static bool record_frame(voice_context_t* ctx, const voice_frame_view_t* frame);
+static void drain_preroll(voice_context_t* ctx, uint32_t max_frames);
+static void close_utterance(voice_context_t* ctx, const voice_frame_view_t* frame);
 static void voice_timeout_callback(TimerHandle_t timer);
-static float calculate_energy_db(const int16_t* samples, size_t num_samples);
-static bool detect_voice_activity(voice_context_t* ctx, const voice_frame_t* frame);
-static void apply_beamforming(voice_context_t* ctx, voice_frame_t* frame);
-static void process_wake_word_detection(voice_context_t* ctx, const voice_frame_t* frame);
-static void update_noise_floor(voice_context_t* ctx, float current_energy);
+static bool detect_voice_activity(voice_context_t* ctx, voice_frame_view_t* frame);
+static void apply_beamforming(voice_context_t* ctx, voice_frame_view_t* frame);
+static void track_direction(voice_context_t* ctx, const voice_frame_view_t* frame);
+static void apply_beam_request(voice_context_t* ctx, uint8_t request);
+static void apply_noise_suppression(voice_context_t* ctx, const voice_frame_view_t* frame);
+static void begin_noise_calibration(voice_context_t* ctx);
+static void update_noise_calibration(voice_context_t* ctx, const voice_frame_view_t* frame);
+static voice_frame_view_t recorded_frame(const voice_context_t* ctx,
+                                         const voice_frame_view_t* frame);
+static void process_wake_word_detection(voice_context_t* ctx, const voice_frame_view_t* frame);
+static void wake_detection_handler(const wake_detection_t* detection, void* user_data);
+static void apply_wake_detection(voice_context_t* ctx, const voice_wake_post_t* post);
+static bool wake_job_live(const voice_context_t* ctx, const voice_wake_job_t* job);
+static void begin_trace(voice_context_t* ctx, uint32_t audio_ms, uint32_t queued_ms);
+static void update_noise_floor(voice_context_t* ctx, voice_db_t current_energy);
+static void update_latency_mode(voice_context_t* ctx, const voice_frame_view_t* frame);
+static voice_error_t queue_buffer_frames(voice_context_t* ctx, audio_driver_t* driver,
+                                         audio_buffer_t* buffer);
+static voice_error_t assemble_buffer_frames(voice_context_t* ctx, audio_driver_t* driver,
+                                            audio_buffer_t* buffer);
+static void release_frame(voice_context_t* ctx, const voice_frame_ref_t* ref);
+static void frames_queued(voice_context_t* ctx);
+static uint32_t stage_done(voice_context_t* ctx, voice_stage_t stage, uint32_t mark);
+static void notify_subscribers(voice_context_t* ctx, voice_stream_t stream);
+static void publish_features(voice_context_t* ctx);
 
-/* Initialize voice processing system */
-voice_context_t* voice_init(const voice_config_t* config) {
+/* Feature frames kept for subscribers, about as long as the circular buffer */
+static uint32_t feature_ring_frames(const wake_feature_config_t* feature_config) {
+    return voice_ring_capacity_for(CIRCULAR_BUFFER_SAMPLES /
+                                   (VOICE_SAMPLE_RATE / 1000 * feature_config->frame_stride_ms));
+}
+
+/* Values per feature frame, as the engine's front-end lays them out */
+static uint32_t feature_ring_dim(const wake_feature_config_t* feature_config) {
+    return (feature_config->num_coeffs + (feature_config->use_energy ? 1 : 0)) *
+           (feature_config->use_deltas ? 2 : 1);
+}
+
+/* Carve from the arena when given one, otherwise use the heap */
+static void* context_alloc(voice_arena_t* arena, size_t size) {
+    return arena ? voice_arena_alloc(arena, size) : pvPortMalloc(size);
+}
+
+/* Trace writers (the processing task, voice_start/stop_recording) run
+ * one at a time in a critical section; readers retry on the seqlock */
+static void trace_write_begin(voice_context_t* ctx) {
+#if VOICE_CORE_AFFINITY
+    portENTER_CRITICAL(&ctx->trace_lock);
+#else
+    taskENTER_CRITICAL();
+#endif
+    uint32_t seq = atomic_load_explicit(&ctx->trace_seqlock, memory_order_relaxed);
+    atomic_store_explicit(&ctx->trace_seqlock, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void trace_write_end(voice_context_t* ctx) {
+    uint32_t seq = atomic_load_explicit(&ctx->trace_seqlock, memory_order_relaxed);
+    atomic_store_explicit(&ctx->trace_seqlock, seq + 1, memory_order_release);
+#if VOICE_CORE_AFFINITY
+    portEXIT_CRITICAL(&ctx->trace_lock);
+#else
+    taskEXIT_CRITICAL();
+#endif
+}
+
+#if VOICE_STATIC_ALLOC
+#define TASK_BUFFER(ctx, field) (&(ctx)->field)
+#else
+#define TASK_BUFFER(ctx, field) NULL
+#endif
+
+/* Create a pipeline task, pinned where the port supports affinity */
+static bool create_stage_task(TaskFunction_t code, const char* name, void* param,
+                              UBaseType_t priority, int32_t core,
+                              voice_arena_t* arena, StaticTask_t* task_buffer,
+                              TaskHandle_t* handle) {
+    (void)core;
+    (void)arena;
+    (void)task_buffer;
+#if VOICE_CORE_AFFINITY
+    BaseType_t core_id = (core == VOICE_CORE_ANY) ? tskNO_AFFINITY : (BaseType_t)core;
+#endif
+    
+#if VOICE_STATIC_ALLOC
+    if (arena) {
+        StackType_t* stack = (StackType_t*)voice_arena_alloc(arena,
+            VOICE_TASK_STACK * sizeof(StackType_t));
+        if (!stack) {
+            return false;
+        }
+#if VOICE_CORE_AFFINITY
+        *handle = xTaskCreateStaticPinnedToCore(code, name, VOICE_TASK_STACK, param,
+                                                priority, stack, task_buffer, core_id);
+#else
+        *handle = xTaskCreateStatic(code, name, VOICE_TASK_STACK, param,
+                                    priority, stack, task_buffer);
+#endif
+        return *handle != NULL;
+    }
+#endif
+    
+#if VOICE_CORE_AFFINITY
+    return xTaskCreatePinnedToCore(code, name, VOICE_TASK_STACK, param,
+                                   priority, handle, core_id) == pdPASS;
+#else
+    return xTaskCreate(code, name, VOICE_TASK_STACK, param,
+                       priority, handle) == pdPASS;
+#endif
+}
+
+/* A pool's wake stage runs in its lead's engine; other members keep none */
+static bool owns_wake_engine(const voice_pipeline_config_t* pipeline) {
+    return !pipeline || !pipeline->pool || pipeline->pool->num_members == 0;
+}
+
+/* Build a context; every buffer comes from the arena when one is given */
+static voice_context_t* context_create(const voice_config_t* config,
+                                       const voice_pipeline_config_t* pipeline,
+                                       voice_arena_t* arena) {
     if (!config) {
         return NULL;
     }
+    if (pipeline && pipeline->pool &&
+        pipeline->pool->num_members >= VOICE_POOL_MAX_MEMBERS) {
+        return NULL;
+    }
     
     /* Allocate context */
-    voice_context_t* ctx = (voice_context_t*)pvPortMalloc(sizeof(voice_context_t));
+    voice_context_t* ctx = (voice_context_t*)context_alloc(arena, sizeof(voice_context_t));
     if (!ctx) {
         return NULL;
     }
     
     memset(ctx, 0, sizeof(voice_context_t));
+#if VOICE_CORE_AFFINITY
+    portMUX_INITIALIZE(&ctx->trace_lock);
+#endif
     memcpy(&ctx->config, config, sizeof(voice_config_t));
+    ctx->pipeline = pipeline ? *pipeline : voice_get_default_pipeline_config();
+    ctx->from_arena = (arena != NULL);
+    if (ctx->pipeline.stream_recording &&
+        ctx->pipeline.recording_preroll_ms > VOICE_RECORDING_CHUNKS * VOICE_RECORDING_CHUNK_MS) {
+        /* A streamed pre-roll fits the chunks the consumer can hold */
+        ctx->pipeline.recording_preroll_ms = VOICE_RECORDING_CHUNKS * VOICE_RECORDING_CHUNK_MS;
+    }
     
     /* Initialize state */
     ctx->state = VOICE_STATE_IDLE;
     ctx->wake_sensitivity = WAKE_WORD_SENSITIVITY;
-    ctx->noise_floor = VAD_ENERGY_THRESHOLD;
+    ctx->noise_floor = VOICE_DB(VAD_ENERGY_THRESHOLD);
+    if (ctx->pipeline.noise_tracking_ms > 0) {
+        voice_noise_tracker_init(&ctx->noise_tracker,
+                                 ctx->pipeline.noise_tracking_ms / FRAME_DURATION_MS,
+                                 VOICE_DB(NOISE_MIN_BIAS_DB));
+    }
     ctx->start_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    voice_profile_init();
+    
+    /* Frame kernels specialized for the configured geometry */
+    if (!voice_dsp_select_kernels(&ctx->kernels, VOICE_CHANNELS, VOICE_FRAME_SIZE)) {
+        goto error_cleanup;
+    }
     
     /* Allocate circular buffer */
-    ctx->circular_buffer = (int16_t*)pvPortMalloc(CIRCULAR_BUFFER_SIZE);
+    ctx->circular_buffer = (int16_t*)context_alloc(arena, CIRCULAR_BUFFER_SIZE);
     if (!ctx->circular_buffer) {
         goto error_cleanup;
     }
     memset(ctx->circular_buffer, 0, CIRCULAR_BUFFER_SIZE);
+    voice_ring_init(&ctx->ring, ctx->circular_buffer,
+                    CIRCULAR_BUFFER_SAMPLES, VOICE_CHANNELS);
+    
+    /* Allocate recording buffer (10 seconds), or chunks when streaming */
+    if (ctx->pipeline.stream_recording) {
+        ctx->chunks = (voice_recording_chunk_t*)context_alloc(arena,
+            VOICE_RECORDING_CHUNKS * sizeof(voice_recording_chunk_t));
+        if (!ctx->chunks ||
+            !voice_fifo_init(&ctx->chunk_fifo, ctx->chunks,
+                             sizeof(voice_recording_chunk_t), VOICE_RECORDING_CHUNKS)) {
+            goto error_cleanup;
+        }
+#if VOICE_STATIC_ALLOC
+        if (arena) {
+            ctx->chunk_ready = xSemaphoreCreateBinaryStatic(&ctx->chunk_ready_buffer);
+        } else
+#endif
+        {
+            ctx->chunk_ready = xSemaphoreCreateBinary();
+        }
+        if (!ctx->chunk_ready) {
+            goto error_cleanup;
+        }
+        
+        /* Optional packet encoder; chunks hold whole packets */
+        const voice_encoder_t* encoder = ctx->pipeline.recording_encoder;
+        if (encoder) {
+            if (!encoder->init || !encoder->encode || encoder->frame_samples == 0 ||
+                encoder->frame_samples % VOICE_FRAME_SIZE != 0 ||
+                encoder->frame_samples > VOICE_RECORDING_CHUNK_SAMPLES ||
+                encoder->max_packet_bytes > encoder->frame_samples * sizeof(int16_t)) {
+                goto error_cleanup;
+            }
+            ctx->encoder_state = encoder->state_size ?
+                context_alloc(arena, encoder->state_size) : NULL;
+            ctx->encoder_pcm = (int16_t*)context_alloc(arena,
+                encoder->frame_samples * sizeof(int16_t));
+            if ((encoder->state_size && !ctx->encoder_state) || !ctx->encoder_pcm) {
+                goto error_cleanup;
+            }
+            ctx->encoder = encoder;
+        }
+    } else {
+        ctx->recording_capacity = RECORDING_CAPACITY;
+        ctx->recording_buffer = (uint8_t*)context_alloc(arena, ctx->recording_capacity);
+        if (!ctx->recording_buffer) {
+            goto error_cleanup;
+        }
+    }
     
-    /* Allocate recording buffer (start with 10 seconds capacity) */
-    ctx->recording_capacity = VOICE_SAMPLE_RATE * 10 * sizeof(int16_t);
-    ctx->recording_buffer = (uint8_t*)pvPortMalloc(ctx->recording_capacity);
-    if (!ctx->recording_buffer) {
+    /* Allocate beamformer and its mono output */
+    ctx->beamformer = (voice_beamformer_t*)context_alloc(arena, sizeof(voice_beamformer_t));
+    ctx->beam_output = (int16_t*)context_alloc(arena, VOICE_FRAME_SIZE * sizeof(int16_t));
+    if (!ctx->beamformer || !ctx->beam_output) {
         goto error_cleanup;
     }
     
-    /* Allocate beamforming arrays */
-    ctx->beamform_weights = (float*)pvPortMalloc(VOICE_CHANNELS * sizeof(float));
-    ctx->beamform_delays = (float*)pvPortMalloc(VOICE_CHANNELS * sizeof(float));
-    if (!ctx->beamform_weights || !ctx->beamform_delays) {
+    /* Precompute steering tables from the array geometry */
+    float mic_xy[VOICE_CHANNELS][2];
+    for (int i = 0; i < VOICE_CHANNELS; i++) {
+        mic_xy[i][0] = ctx->config.beamform.mic_positions[i][0];
+        mic_xy[i][1] = ctx->config.beamform.mic_positions[i][1];
+    }
+    voice_beamform_init(ctx->beamformer, mic_xy);
+    voice_beamform_enable(ctx->beamformer, ctx->config.beamform.adaptive_mode);
+    
+    /* Direction tracker on the same steering table */
+    ctx->doa = (voice_doa_t*)context_alloc(arena, sizeof(voice_doa_t));
+    if (!ctx->doa) {
         goto error_cleanup;
     }
+    voice_doa_init(ctx->doa, ctx->beamformer);
+    
+    /* Allocate noise suppressor; a second stream replays the pre-roll */
+    ctx->denoiser = (voice_denoise_t*)context_alloc(arena, sizeof(voice_denoise_t));
+    ctx->denoise_live = (voice_denoise_stream_t*)context_alloc(arena,
+        sizeof(voice_denoise_stream_t));
+    ctx->denoise_output = (int16_t*)context_alloc(arena, VOICE_FRAME_SIZE * sizeof(int16_t));
+    if (!ctx->denoiser || !ctx->denoise_live || !ctx->denoise_output) {
+        goto error_cleanup;
+    }
+    if (ctx->pipeline.recording_preroll_ms > 0) {
+        ctx->denoise_history = (voice_denoise_stream_t*)context_alloc(arena,
+            sizeof(voice_denoise_stream_t));
+        ctx->preroll = (voice_history_reader_t*)context_alloc(arena,
+            sizeof(voice_history_reader_t));
+        if (!ctx->denoise_history || !ctx->preroll) {
+            goto error_cleanup;
+        }
+    }
     
-    /* Initialize beamforming weights */
-    for (int i = 0; i < VOICE_CHANNELS; i++) {
-        ctx->beamform_weights[i] = 1.0f / VOICE_CHANNELS;
-        ctx->beamform_delays[i] = 0.0f;
+    /* Onset backfill reader; a pool can move the wake stage between arrays */
+    if (ctx->pipeline.wake_gating || ctx->pipeline.pool) {
+        ctx->wake_history = (voice_history_reader_t*)context_alloc(arena,
+            sizeof(voice_history_reader_t));
+        if (!ctx->wake_history) {
+            goto error_cleanup;
+        }
     }
     
     /* Allocate VAD history buffer */
-    ctx->energy_history = (float*)pvPortMalloc(10 * sizeof(float));
+    ctx->energy_history = (float*)context_alloc(arena, ENERGY_HISTORY_LENGTH * sizeof(float));
     if (!ctx->energy_history) {
         goto error_cleanup;
     }
     
-    /* Allocate DSP buffers */
-    ctx->fft_buffer = (float*)pvPortMalloc(FFT_SIZE * sizeof(float));
-    ctx->mel_energies = (float*)pvPortMalloc(MEL_FILTERS * sizeof(float));
-    ctx->mfcc_features = (float*)pvPortMalloc(MFCC_COEFFICIENTS * sizeof(float));
-    if (!ctx->fft_buffer || !ctx->mel_energies || !ctx->mfcc_features) {
+    /* Allocate DSP buffers (arena builds let the engine carve its own) */
+    bool wake_engine = owns_wake_engine(&ctx->pipeline);
+    if (!arena && wake_engine) {
+        ctx->fft_buffer = (float*)pvPortMalloc(FFT_SIZE * sizeof(float));
+        ctx->mel_energies = (float*)pvPortMalloc(MEL_FILTERS * sizeof(float));
+        ctx->mfcc_features = (float*)pvPortMalloc(MFCC_COEFFICIENTS * sizeof(float));
+        if (!ctx->fft_buffer || !ctx->mel_energies || !ctx->mfcc_features) {
+            goto error_cleanup;
+        }
+    }
+    
+    /* The suppressor shares the MFCC FFT buffer unless the wake stage
+     * runs on its own task, or long frames need a longer transform */
+    voice_pool_t* pool = ctx->pipeline.pool;
+    bool wake_queue = ctx->pipeline.split || pool;
+    float* denoise_work = (wake_queue || DENOISE_FFT_SIZE > FFT_SIZE) ? NULL : ctx->fft_buffer;
+    if (!denoise_work) {
+        ctx->denoise_work = (float*)context_alloc(arena, DENOISE_FFT_SIZE * sizeof(float));
+        if (!ctx->denoise_work) {
+            goto error_cleanup;
+        }
+        denoise_work = ctx->denoise_work;
+    }
+    voice_denoise_init(ctx->denoiser, denoise_work);
+    voice_denoise_stream_reset(ctx->denoiser, ctx->denoise_live);
+    
+    /* Allocate frame pool for copy-mode submissions */
+    ctx->frame_pool = (voice_frame_t*)context_alloc(arena, FRAME_QUEUE_LENGTH * sizeof(voice_frame_t));
+    if (!ctx->frame_pool) {
         goto error_cleanup;
     }
     
     /* Create synchronization objects */
-    ctx->buffer_mutex = xSemaphoreCreateMutex();
-    ctx->frame_queue = xQueueCreate(10, sizeof(voice_frame_t));
-    if (!ctx->buffer_mutex || !ctx->frame_queue) {
+#if VOICE_STATIC_ALLOC
+    if (arena) {
+        uint8_t* frame_storage = (uint8_t*)voice_arena_alloc(arena,
+            FRAME_QUEUE_LENGTH * sizeof(voice_frame_ref_t));
+        uint8_t* free_storage = (uint8_t*)voice_arena_alloc(arena,
+            FRAME_QUEUE_LENGTH * sizeof(voice_frame_t*));
+        if (!frame_storage || !free_storage) {
+            goto error_cleanup;
+        }
+        ctx->frame_queue = xQueueCreateStatic(FRAME_QUEUE_LENGTH, sizeof(voice_frame_ref_t),
+                                              frame_storage, &ctx->frame_queue_buffer);
+        ctx->free_frames = xQueueCreateStatic(FRAME_QUEUE_LENGTH, sizeof(voice_frame_t*),
+                                              free_storage, &ctx->free_frames_buffer);
+    } else
+#endif
+    {
+        ctx->frame_queue = xQueueCreate(FRAME_QUEUE_LENGTH, sizeof(voice_frame_ref_t));
+        ctx->free_frames = xQueueCreate(FRAME_QUEUE_LENGTH, sizeof(voice_frame_t*));
+    }
+    if (!ctx->frame_queue || !ctx->free_frames) {
         goto error_cleanup;
     }
     
+    for (int i = 0; i < FRAME_QUEUE_LENGTH; i++) {
+        voice_frame_t* slot = &ctx->frame_pool[i];
+        xQueueSend(ctx->free_frames, &slot, 0);
+    }
+    
     /* Create timeout timer */
-    ctx->timeout_timer = xTimerCreate("VoiceTimeout", 
-                                     pdMS_TO_TICKS(WAKE_WORD_TIMEOUT_MS),
-                                     pdFALSE, ctx, voice_timeout_callback);
+#if VOICE_STATIC_ALLOC
+    if (arena) {
+        ctx->timeout_timer = xTimerCreateStatic("VoiceTimeout",
+                                               pdMS_TO_TICKS(WAKE_WORD_TIMEOUT_MS),
+                                               pdFALSE, ctx, voice_timeout_callback,
+                                               &ctx->timeout_timer_buffer);
+    } else
+#endif
+    {
+        ctx->timeout_timer = xTimerCreate("VoiceTimeout", 
+                                         pdMS_TO_TICKS(WAKE_WORD_TIMEOUT_MS),
+                                         pdFALSE, ctx, voice_timeout_callback);
+    }
     if (!ctx->timeout_timer) {
         goto error_cleanup;
     }
     
-    /* Create processing task */
-    if (xTaskCreate(voice_processing_task, "VoiceProc", 
-                   4096, ctx, tskIDLE_PRIORITY + 3, 
-                   &ctx->processing_task) != pdPASS) {
+    /* Initialize wake word engine; its front-end runs in our DSP buffers */
+    wake_feature_config_t feature_config = wake_get_default_feature_config();
+    feature_config.sample_rate = VOICE_SAMPLE_RATE;
+    feature_config.num_filters = MEL_FILTERS;
+    feature_config.num_coeffs = MFCC_COEFFICIENTS;
+    
+    if (wake_engine) {
+#if VOICE_STATIC_ALLOC
+        if (arena) {
+            ctx->wake_word_engine = wake_engine_init_static(&feature_config, arena);
+        } else
+#endif
+        {
+            ctx->wake_word_engine = wake_engine_init(&feature_config);
+        }
+        if (!ctx->wake_word_engine) {
+            goto error_cleanup;
+        }
+        if (ctx->fft_buffer &&
+            wake_engine_bind_scratch(ctx->wake_word_engine,
+                                     ctx->fft_buffer, FFT_SIZE,
+                                     ctx->mel_energies, MEL_FILTERS,
+                                     ctx->mfcc_features, MFCC_COEFFICIENTS) != WAKE_OK) {
+            goto error_cleanup;
+        }
+        wake_engine_register_callback(ctx->wake_word_engine, wake_detection_handler, ctx);
+        if (ctx->pipeline.wake_false_accepts_per_hour > 0.0f) {
+            wake_tuning_config_t tuning = wake_get_default_tuning_config();
+            tuning.false_accepts_per_hour = ctx->pipeline.wake_false_accepts_per_hour;
+            wake_engine_set_tuning(ctx->wake_word_engine, &tuning);
+            wake_engine_set_sensitivity(ctx->wake_word_engine, ctx->wake_sensitivity);
+        }
+    }
+    ctx->wake_stale_epoch = UINT32_MAX;
+    
+    /* Rings for the subscriber streams asked for */
+    if (ctx->pipeline.subscriber_streams & VOICE_STREAM_BIT(VOICE_STREAM_MONO)) {
+        ctx->mono_buffer = (int16_t*)context_alloc(arena,
+            CIRCULAR_BUFFER_SAMPLES * sizeof(int16_t));
+        if (!ctx->mono_buffer) {
+            goto error_cleanup;
+        }
+        voice_ring_init(&ctx->mono_ring, ctx->mono_buffer, CIRCULAR_BUFFER_SAMPLES, 1);
+    }
+    if (ctx->pipeline.subscriber_streams & VOICE_STREAM_BIT(VOICE_STREAM_FEATURES)) {
+        uint32_t frames = feature_ring_frames(&feature_config);
+        uint32_t dim = feature_ring_dim(&feature_config);
+        ctx->feature_buffer = (int16_t*)context_alloc(arena,
+            (size_t)frames * dim * sizeof(int16_t));
+        if (!ctx->feature_buffer) {
+            goto error_cleanup;
+        }
+        voice_ring_init(&ctx->feature_ring, ctx->feature_buffer, frames, (uint8_t)dim);
+    }
+    for (int i = 0; i < VOICE_MAX_SUBSCRIBERS; i++) {
+        ctx->subscribers[i].ctx = ctx;
+    }
+    
+    /* Keep room for the frames the wake stage may lag behind capture */
+    ctx->history_limit = ctx->ring.capacity -
+                         (VOICE_WAKE_QUEUE_LENGTH + 1) * VOICE_FRAME_SIZE;
+    reset_wake_gate(ctx);
+    prime_wake_engine(ctx);
+    
+    /* Wake stage queue, and its task (split pipeline) or the pool's */
+    if (wake_queue) {
+        ctx->wake_jobs = (voice_wake_job_t*)context_alloc(arena,
+            VOICE_WAKE_QUEUE_LENGTH * sizeof(voice_wake_job_t));
+        if (!ctx->wake_jobs ||
+            !voice_fifo_init(&ctx->wake_fifo, ctx->wake_jobs,
+                             sizeof(voice_wake_job_t), VOICE_WAKE_QUEUE_LENGTH)) {
+            goto error_cleanup;
+        }
+    }
+    if (pool) {
+        /* Pool workers process the frames; nothing else to start */
+        ctx->wake_task = pool->wake_task;
+        pool->members[pool->num_members++] = ctx;
+        return ctx;
+    }
+    if (ctx->pipeline.split &&
+        !create_stage_task(voice_wake_task, "VoiceWake", ctx,
+                           WAKE_TASK_PRIORITY, ctx->pipeline.wake_core, arena,
+                           TASK_BUFFER(ctx, wake_task_buffer), &ctx->wake_task)) {
         goto error_cleanup;
     }
     
-    /* Initialize wake word engine (placeholder - would integrate real engine) */
-    ctx->wake_word_engine = NULL; // Initialize with actual wake word engine
+    /* Create processing task */
+    if (!create_stage_task(voice_processing_task, "VoiceProc", ctx,
+                           VOICE_TASK_PRIORITY, ctx->pipeline.front_core, arena,
+                           TASK_BUFFER(ctx, processing_task_buffer),
+                           &ctx->processing_task)) {
+        goto error_cleanup;
+    }
     
     return ctx;
 
@@ -176,14 +786,140 @@ error_cleanup:
     return NULL;
 }
 
+/* Initialize voice processing system */
+voice_context_t* voice_init(const voice_config_t* config) {
+    return context_create(config, NULL, NULL);
+}
+
+/* Default pipeline layout */
+voice_pipeline_config_t voice_get_default_pipeline_config(void) {
+    voice_pipeline_config_t pipeline = {
+        .split = false,
+        .front_core = VOICE_CORE_ANY,
+        .wake_core = VOICE_CORE_ANY,
+        .wake_gating = false,
+        .wake_backfill_ms = VOICE_WAKE_BACKFILL_MS,
+        .wake_hangover_ms = VOICE_WAKE_HANGOVER_MS,
+        .stream_recording = false,
+        .recording_encoder = NULL,
+        .recording_preroll_ms = 0,
+        .noise_tracking_ms = 0,
+        .latency_control = false,
+        .pool = NULL,
+        .subscriber_streams = 0,
+        .wake_false_accepts_per_hour = 0.0f
+    };
+    return pipeline;
+}
+
+/* Initialize voice processing with a pipeline layout */
+voice_context_t* voice_init_pipeline(const voice_config_t* config,
+                                     const voice_pipeline_config_t* pipeline) {
+    return context_create(config, pipeline, NULL);
+}
+
+#if VOICE_STATIC_ALLOC
+/* Arena bytes for voice_init_static() */
+size_t voice_context_required_size(const voice_config_t* config,
+                                   const voice_pipeline_config_t* pipeline) {
+    if (!config) {
+        return 0;
+    }
+    
+    /* Pool members queue wake jobs but start no tasks */
+    bool pooled = pipeline && pipeline->pool;
+    size_t tasks = pooled ? 0 : VOICE_ARENA_SIZE(VOICE_TASK_STACK * sizeof(StackType_t));
+    if (pipeline && (pipeline->split || pooled)) {
+        tasks += VOICE_ARENA_SIZE(VOICE_WAKE_QUEUE_LENGTH * sizeof(voice_wake_job_t));
+    }
+    if (pipeline && pipeline->split && !pooled) {
+        tasks += VOICE_ARENA_SIZE(VOICE_TASK_STACK * sizeof(StackType_t));
+    }
+    if (pipeline && (pipeline->wake_gating || pooled)) {
+        tasks += VOICE_ARENA_SIZE(sizeof(voice_history_reader_t));
+    }
+    size_t denoise = VOICE_ARENA_SIZE(sizeof(voice_denoise_t)) +
+                     VOICE_ARENA_SIZE(sizeof(voice_denoise_stream_t)) +
+                     VOICE_ARENA_SIZE(VOICE_FRAME_SIZE * sizeof(int16_t)) +
+                     VOICE_ARENA_SIZE(DENOISE_FFT_SIZE * sizeof(float));
+    if (pipeline && pipeline->recording_preroll_ms > 0) {
+        denoise += VOICE_ARENA_SIZE(sizeof(voice_denoise_stream_t)) +
+                   VOICE_ARENA_SIZE(sizeof(voice_history_reader_t));
+    }
+    size_t recording = (pipeline && pipeline->stream_recording) ?
+        VOICE_ARENA_SIZE(VOICE_RECORDING_CHUNKS * sizeof(voice_recording_chunk_t)) :
+        VOICE_ARENA_SIZE(RECORDING_CAPACITY);
+    if (pipeline && pipeline->stream_recording && pipeline->recording_encoder) {
+        const voice_encoder_t* encoder = pipeline->recording_encoder;
+        recording += VOICE_ARENA_SIZE(encoder->frame_samples * sizeof(int16_t));
+        if (encoder->state_size) {
+            recording += VOICE_ARENA_SIZE(encoder->state_size);
+        }
+    }
+    
+    wake_feature_config_t feature_config = wake_get_default_feature_config();
+    feature_config.sample_rate = VOICE_SAMPLE_RATE;
+    feature_config.num_filters = MEL_FILTERS;
+    feature_config.num_coeffs = MFCC_COEFFICIENTS;
+    
+    size_t streams = 0;
+    uint32_t stream_bits = pipeline ? pipeline->subscriber_streams : 0;
+    if (stream_bits & VOICE_STREAM_BIT(VOICE_STREAM_MONO)) {
+        streams += VOICE_ARENA_SIZE(CIRCULAR_BUFFER_SAMPLES * sizeof(int16_t));
+    }
+    if (stream_bits & VOICE_STREAM_BIT(VOICE_STREAM_FEATURES)) {
+        streams += VOICE_ARENA_SIZE((size_t)feature_ring_frames(&feature_config) *
+                                    feature_ring_dim(&feature_config) * sizeof(int16_t));
+    }
+    
+    return (VOICE_ARENA_ALIGN - 1) +
+           VOICE_ARENA_SIZE(sizeof(voice_context_t)) +
+           VOICE_ARENA_SIZE(CIRCULAR_BUFFER_SIZE) +
+           recording +
+           VOICE_ARENA_SIZE(sizeof(voice_beamformer_t)) +
+           VOICE_ARENA_SIZE(VOICE_FRAME_SIZE * sizeof(int16_t)) +
+           VOICE_ARENA_SIZE(sizeof(voice_doa_t)) +
+           denoise +
+           VOICE_ARENA_SIZE(ENERGY_HISTORY_LENGTH * sizeof(float)) +
+           VOICE_ARENA_SIZE(FRAME_QUEUE_LENGTH * sizeof(voice_frame_t)) +
+           VOICE_ARENA_SIZE(FRAME_QUEUE_LENGTH * sizeof(voice_frame_ref_t)) +
+           VOICE_ARENA_SIZE(FRAME_QUEUE_LENGTH * sizeof(voice_frame_t*)) +
+           tasks +
+           streams +
+           (owns_wake_engine(pipeline) ? wake_engine_required_size(&feature_config) : 0);
+}
+
+/* Initialize voice processing system in a caller-provided arena */
+voice_context_t* voice_init_static(const voice_config_t* config,
+                                   const voice_pipeline_config_t* pipeline,
+                                   void* arena_memory,
+                                   size_t arena_size) {
+    if (!arena_memory || arena_size < voice_context_required_size(config, pipeline)) {
+        return NULL;
+    }
+    
+    voice_arena_t arena;
+    voice_arena_init(&arena, arena_memory, arena_size);
+    return context_create(config, pipeline, &arena);
+}
+#endif
+
 /* Deinitialize voice processing system */
 void voice_deinit(voice_context_t* ctx) {
     if (!ctx) return;
     
-    /* Stop processing task */
+    /* Stop processing tasks; a pool's belong to the pool */
     if (ctx->processing_task) {
         vTaskDelete(ctx->processing_task);
     }
+    if (ctx->wake_task && !ctx->pipeline.pool) {
+        vTaskDelete(ctx->wake_task);
+    }
+    
+    /* Release wake word engine */
+    if (ctx->wake_word_engine) {
+        wake_engine_deinit(ctx->wake_word_engine);
+    }
     
     /* Delete timer */
     if (ctx->timeout_timer) {
@@ -191,22 +927,57 @@ void voice_deinit(voice_context_t* ctx) {
     }
     
     /* Delete synchronization objects */
-    if (ctx->buffer_mutex) {
-        vSemaphoreDelete(ctx->buffer_mutex);
-    }
     if (ctx->frame_queue) {
+        /* Hand pending driver buffers back to their owner */
+        voice_frame_ref_t ref;
+        while (xQueueReceive(ctx->frame_queue, &ref, 0) == pdPASS) {
+            if (ref.dma_buffer) {
+                audio_driver_return_buffer(ref.driver, ref.dma_buffer);
+            }
+        }
         vQueueDelete(ctx->frame_queue);
     }
+    if (ctx->free_frames) {
+        vQueueDelete(ctx->free_frames);
+    }
+    if (ctx->chunk_ready) {
+        vSemaphoreDelete(ctx->chunk_ready);
+    }
+    for (int i = 0; i < VOICE_MAX_SUBSCRIBERS; i++) {
+        if (ctx->subscribers[i].ready) {
+            vSemaphoreDelete(ctx->subscribers[i].ready);
+        }
+    }
+    
+    /* Arena memory is reclaimed by the caller */
+    if (ctx->from_arena) {
+        return;
+    }
     
     /* Free buffers */
     if (ctx->circular_buffer) vPortFree(ctx->circular_buffer);
     if (ctx->recording_buffer) vPortFree(ctx->recording_buffer);
-    if (ctx->beamform_weights) vPortFree(ctx->beamform_weights);
-    if (ctx->beamform_delays) vPortFree(ctx->beamform_delays);
+    if (ctx->beamformer) vPortFree(ctx->beamformer);
+    if (ctx->doa) vPortFree(ctx->doa);
+    if (ctx->beam_output) vPortFree(ctx->beam_output);
+    if (ctx->denoiser) vPortFree(ctx->denoiser);
+    if (ctx->denoise_live) vPortFree(ctx->denoise_live);
+    if (ctx->denoise_history) vPortFree(ctx->denoise_history);
+    if (ctx->preroll) vPortFree(ctx->preroll);
+    if (ctx->wake_history) vPortFree(ctx->wake_history);
+    if (ctx->denoise_output) vPortFree(ctx->denoise_output);
+    if (ctx->denoise_work) vPortFree(ctx->denoise_work);
     if (ctx->energy_history) vPortFree(ctx->energy_history);
     if (ctx->fft_buffer) vPortFree(ctx->fft_buffer);
     if (ctx->mel_energies) vPortFree(ctx->mel_energies);
     if (ctx->mfcc_features) vPortFree(ctx->mfcc_features);
+    if (ctx->frame_pool) vPortFree(ctx->frame_pool);
+    if (ctx->wake_jobs) vPortFree(ctx->wake_jobs);
+    if (ctx->chunks) vPortFree(ctx->chunks);
+    if (ctx->encoder_state) vPortFree(ctx->encoder_state);
+    if (ctx->encoder_pcm) vPortFree(ctx->encoder_pcm);
+    if (ctx->mono_buffer) vPortFree(ctx->mono_buffer);
+    if (ctx->feature_buffer) vPortFree(ctx->feature_buffer);
     
     vPortFree(ctx);
 }
@@ -217,242 +988,1398 @@ voice_error_t voice_process_frame(voice_context_t* ctx, const voice_frame_t* fra
         return VOICE_ERR_INVALID_PARAM;
     }
     
-    /* Send frame to processing queue */
-    if (xQueueSend(ctx->frame_queue, frame, 0) != pdPASS) {
+    /* Take a free pool slot; the queue itself only carries references */
+    voice_frame_t* slot;
+    if (xQueueReceive(ctx->free_frames, &slot, 0) != pdPASS) {
         ctx->stats.buffer_overruns++;
         return VOICE_ERR_BUFFER_OVERFLOW;
     }
     
+    memcpy(slot, frame, sizeof(voice_frame_t));
+    
+    voice_frame_ref_t ref = {
+        .samples = slot->samples,
+        .timestamp_ms = slot->timestamp_ms,
+        .queued_ms = xTaskGetTickCount() * portTICK_PERIOD_MS,
+        .slot = slot,
+        .dma_buffer = NULL,
+        .driver = NULL
+    };
+    
+    /* Send reference to processing queue */
+    if (xQueueSend(ctx->frame_queue, &ref, 0) != pdPASS) {
+        xQueueSend(ctx->free_frames, &slot, 0);
+        ctx->stats.buffer_overruns++;
+        return VOICE_ERR_BUFFER_OVERFLOW;
+    }
+    
+    frames_queued(ctx);
     return VOICE_OK;
 }
 
+/* Process audio driver buffer in place */
+voice_error_t voice_process_buffer(voice_context_t* ctx,
+                                  audio_driver_t* driver,
+                                  audio_buffer_t* buffer) {
+    if (!ctx || !driver || !buffer || !buffer->data) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    /* Only the native layout can be consumed without conversion */
+    if (buffer->format != AUDIO_FORMAT_S16_LE ||
+        buffer->channels != VOICE_CHANNELS ||
+        buffer->samples_per_channel == 0) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    ctx->driver = driver;
+    
+    /* Whole frames on a frame boundary are read in place */
+    if (ctx->assembly_fill == 0 && buffer->samples_per_channel % VOICE_FRAME_SIZE == 0) {
+        return queue_buffer_frames(ctx, driver, buffer);
+    }
+    return assemble_buffer_frames(ctx, driver, buffer);
+}
+
+/* Queue a buffer of whole frames in place; its last frame returns it */
+static voice_error_t queue_buffer_frames(voice_context_t* ctx, audio_driver_t* driver,
+                                         audio_buffer_t* buffer) {
+    uint32_t frames = buffer->samples_per_channel / VOICE_FRAME_SIZE;
+    if (uxQueueSpacesAvailable(ctx->frame_queue) < frames) {
+        ctx->stats.buffer_overruns++;
+        return VOICE_ERR_BUFFER_OVERFLOW;
+    }
+    
+    const int16_t* samples = (const int16_t*)buffer->data;
+    uint32_t timestamp_ms = buffer->timestamp_us / 1000;
+    uint32_t queued_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    
+    for (uint32_t f = 0; f < frames; f++) {
+        bool last = (f == frames - 1);
+        voice_frame_ref_t ref = {
+            .samples = &samples[f * VOICE_FRAME_SIZE * VOICE_CHANNELS],
+            .timestamp_ms = timestamp_ms + f * FRAME_DURATION_MS,
+            .queued_ms = queued_ms,
+            .slot = NULL,
+            .dma_buffer = last ? buffer : NULL,
+            .driver = last ? driver : NULL
+        };
+        xQueueSend(ctx->frame_queue, &ref, 0);
+    }
+    
+    frames_queued(ctx);
+    return VOICE_OK;
+}
+
+/* Copy a buffer into pool slots, carrying a partial frame to the next */
+static voice_error_t assemble_buffer_frames(voice_context_t* ctx, audio_driver_t* driver,
+                                            audio_buffer_t* buffer) {
+    uint32_t samples = buffer->samples_per_channel;
+    uint32_t total = ctx->assembly_fill + samples;
+    uint32_t slots = (total + VOICE_FRAME_SIZE - 1) / VOICE_FRAME_SIZE - (ctx->assembly ? 1 : 0);
+    
+    /* All or nothing, so a rejected buffer leaves the assembly as it was */
+    if (uxQueueMessagesWaiting(ctx->free_frames) < slots ||
+        uxQueueSpacesAvailable(ctx->frame_queue) < total / VOICE_FRAME_SIZE) {
+        ctx->stats.buffer_overruns++;
+        return VOICE_ERR_BUFFER_OVERFLOW;
+    }
+    
+    const int16_t* in = (const int16_t*)buffer->data;
+    uint32_t queued_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    uint32_t offset = 0;
+    
+    while (offset < samples) {
+        if (!ctx->assembly) {
+            xQueueReceive(ctx->free_frames, &ctx->assembly, 0);
+            ctx->assembly->timestamp_ms = (uint32_t)((buffer->timestamp_us +
+                (uint64_t)offset * 1000000 / VOICE_SAMPLE_RATE) / 1000);
+        }
+        
+        uint32_t take = VOICE_FRAME_SIZE - ctx->assembly_fill;
+        if (take > samples - offset) {
+            take = samples - offset;
+        }
+        memcpy(&ctx->assembly->samples[ctx->assembly_fill * VOICE_CHANNELS],
+               &in[offset * VOICE_CHANNELS], take * VOICE_CHANNELS * sizeof(int16_t));
+        ctx->assembly_fill += take;
+        offset += take;
+        
+        if (ctx->assembly_fill == VOICE_FRAME_SIZE) {
+            voice_frame_ref_t ref = {
+                .samples = ctx->assembly->samples,
+                .timestamp_ms = ctx->assembly->timestamp_ms,
+                .queued_ms = queued_ms,
+                .slot = ctx->assembly,
+                .dma_buffer = NULL,
+                .driver = NULL
+            };
+            xQueueSend(ctx->frame_queue, &ref, 0);
+            ctx->assembly = NULL;
+            ctx->assembly_fill = 0;
+        }
+    }
+    
+    /* Everything is copied out; the driver gets the buffer back at once */
+    audio_driver_return_buffer(driver, buffer);
+    frames_queued(ctx);
+    return VOICE_OK;
+}
+
+/* Record the frame queue high-water mark and, in a pool, put the
+ * context on the run queue unless it is already there (producer side) */
+static void frames_queued(voice_context_t* ctx) {
+    uint32_t depth = (uint32_t)uxQueueMessagesWaiting(ctx->frame_queue);
+    if (depth > ctx->queue_high_water) {
+        ctx->queue_high_water = depth;
+    }
+    
+    voice_pool_t* pool = ctx->pipeline.pool;
+    if (pool && !atomic_exchange(&ctx->scheduled, true)) {
+        xQueueSend(pool->run_queue, &ctx, 0);
+    }
+}
+
+/* Close a timed stage; returns the mark for the next one */
+static uint32_t stage_done(voice_context_t* ctx, voice_stage_t stage, uint32_t mark) {
+    uint32_t now = voice_profile_now();
+    voice_profile_record(&ctx->profile[stage], now - mark);
+    return now;
+}
+
+/* Return a processed frame to its source */
+static void release_frame(voice_context_t* ctx, const voice_frame_ref_t* ref) {
+    if (ref->dma_buffer) {
+        audio_driver_return_buffer(ref->driver, ref->dma_buffer);
+    } else if (ref->slot) {
+        voice_frame_t* slot = ref->slot;
+        xQueueSend(ctx->free_frames, &slot, 0);
+    }
+}
+
 /* Voice processing task */
 static void voice_processing_task(void* param) {
     voice_context_t* ctx = (voice_context_t*)param;
-    voice_frame_t frame;
+    voice_frame_ref_t ref;
+    
+    while (1) {
+        /* Wait for frame */
+        if (xQueueReceive(ctx->frame_queue, &ref, portMAX_DELAY) == pdPASS) {
+            process_frame(ctx, &ref);
+        }
+    }
+}
+
+/* Run one frame through the pipeline (processing task or pool worker) */
+static void process_frame(voice_context_t* ctx, const voice_frame_ref_t* ref) {
+    voice_frame_view_t frame;
+    frame.samples = ref->samples;
+    frame.timestamp_ms = ref->timestamp_ms;
+    frame.queued_ms = ref->queued_ms;
+    frame.vad_active = false;
+    uint32_t frame_start = voice_profile_now();
+    uint32_t mark = frame_start;
+    bool offered = false;
+    
+    /* Update statistics */
+    ctx->stats.frames_processed++;
+    
+    /* A detection the wake stage posted since the last frame */
+    if (atomic_load_explicit(&ctx->wake_posted, memory_order_acquire)) {
+        voice_wake_post_t post = ctx->wake_post;
+        ctx->wake_epoch++;
+        atomic_store_explicit(&ctx->wake_posted, false, memory_order_release);
+        apply_wake_detection(ctx, &post);
+    }
+    
+    /* Reset asked for since the last frame; whichever task runs the
+     * wake engine clears and re-primes it */
+    if (atomic_exchange(&ctx->reset_request, false)) {
+        reset_wake_gate(ctx);
+        if (ctx->wake_task) {
+            ctx->wake_reset_pending = true;
+        } else {
+            reset_wake_engine(ctx);
+        }
+    }
+    
+    /* Steering asked for since the last frame */
+    uint8_t beam_request = atomic_exchange(&ctx->beam_request, 0);
+    if (beam_request) {
+        apply_beam_request(ctx, beam_request);
+    }
+    
+    /* Noise calibration asked for since the last frame */
+    if (ctx->calibration_request > 0) {
+        begin_noise_calibration(ctx);
+    }
+    
+    /* Beamform to mono (plain weighted sum while unsteered) */
+    apply_beamforming(ctx, &frame);
+    mark = stage_done(ctx, VOICE_STAGE_BEAMFORM, mark);
+    
+    /* Detect voice activity */
+    bool vad_result = detect_voice_activity(ctx, &frame);
+    frame.vad_active = vad_result;
+    mark = stage_done(ctx, VOICE_STAGE_VAD, mark);
+    
+    if (vad_result) {
+        ctx->stats.vad_activations++;
+    }
+    
+    /* Follow the talker; the new beam applies from the next frame */
+    if (vad_result && ctx->config.beamform.adaptive_mode) {
+        track_direction(ctx, &frame);
+        mark = stage_done(ctx, VOICE_STAGE_DOA, mark);
+    }
+    
+    if (ctx->pipeline.latency_control) {
+        update_latency_mode(ctx, &frame);
+    }
+    
+    /* Clean the mono signal for recording */
+    if (ctx->noise_suppression > 0.0f || ctx->denoise_level > 0.0f ||
+        ctx->calibration_frames > 0) {
+        apply_noise_suppression(ctx, &frame);
+        mark = stage_done(ctx, VOICE_STAGE_DENOISE, mark);
+    }
+    
+    if (ctx->calibration_frames > 0) {
+        update_noise_calibration(ctx, &frame);
+    }
+    
+    /* A few frames of the pre-roll backlog per live frame; once recording
+     * has stopped nothing chases it, and a chunk's worth goes each frame */
+    if (ctx->preroll_active) {
+        drain_preroll(ctx, ctx->preroll_closing ?
+                      VOICE_RECORDING_CHUNK_SAMPLES / VOICE_FRAME_SIZE : ctx->preroll_rate);
+        mark = stage_done(ctx, VOICE_STAGE_RECORD, mark);
+    }
+    
+    /* State machine */
+    switch (ctx->state) {
+        case VOICE_STATE_IDLE:
+        case VOICE_STATE_LISTENING: {
+            /* Check for wake word, here or on the wake stage */
+            wake_gate_t previous = ctx->wake_gate;
+            wake_gate_t gate = update_wake_gate(ctx, &frame);
+            bool onset = (previous == WAKE_GATE_OFF && gate != WAKE_GATE_OFF);
+            uint32_t position = voice_ring_position(&ctx->ring);
+            
+            if (ctx->wake_task) {
+                /* A sleeping wake stage is not woken per frame */
+                if (ctx->pipeline.pool || gate != WAKE_GATE_OFF || previous != WAKE_GATE_OFF ||
+                    ctx->wake_reset_pending) {
+                    submit_wake_job(ctx, &frame, gate, onset, position);
+                    offered = true;
+                }
+            } else {
+                run_wake_stage(ctx, ctx, &frame, gate, onset, position);
+                mark = stage_done(ctx, VOICE_STAGE_WAKE, mark);
+            }
+            break;
+        }
+            
+        case VOICE_STATE_WAKE_DETECTED:
+            /* Automatically transition to recording */
+            ctx->state = VOICE_STATE_RECORDING;
+            ctx->recording_start_time = frame.timestamp_ms;
+            ctx->recording_size = 0;
+            ctx->is_recording = true;
+            /* Fall through - this frame is the first recorded */
+        case VOICE_STATE_RECORDING: {
+            /* First recording frame: open the utterance, pre-roll first,
+             * once the last one's backlog is in */
+            if (ctx->is_recording && ctx->preroll_closing) {
+                close_utterance(ctx, &frame);
+            }
+            if (ctx->is_recording && !ctx->utterance_open) {
+                open_utterance(ctx, &frame);
+            }
+            
+            /* Record audio if VAD active; behind a pre-roll it is read
+             * back from the ring in turn */
+            bool keep = frame.vad_active && ctx->is_recording;
+            if (keep) {
+                ctx->utterance_speech = true;
+            }
+            if (ctx->preroll_active && !ctx->preroll_closing) {
+                ctx->preroll_keep |= (uint64_t)keep << ctx->preroll_pending;
+                ctx->preroll_pending++;
+            } else if (keep) {
+                voice_frame_view_t recorded = recorded_frame(ctx, &frame);
+                record_frame(ctx, &recorded);
+                mark = stage_done(ctx, VOICE_STAGE_RECORD, mark);
+            }
+            
+            /* Check recording timeout */
+            if (ctx->is_recording &&
+                frame.timestamp_ms - ctx->recording_start_time > 
+                ctx->max_recording_duration) {
+                voice_stop_recording(ctx);
+            }
+            break;
+        }
+            
+        case VOICE_STATE_PROCESSING:
+            /* Wait for external processing to complete */
+            break;
+            
+        case VOICE_STATE_ERROR:
+            /* Error state - might need reset */
+            break;
+    }
+    
+    /* Pool members hand in every period, so the pool can line arrays up */
+    if (ctx->pipeline.pool && !offered) {
+        submit_wake_job(ctx, &frame, ctx->wake_gate, false, voice_ring_position(&ctx->ring));
+    }
+    
+    /* Close the utterance once recording stops, however it stopped; a
+     * streamed pre-roll still behind finishes at its own pace first */
+    if (ctx->utterance_open && !ctx->is_recording && !ctx->preroll_closing) {
+        ctx->preroll_closing = ctx->chunks && ctx->preroll_active;
+        if (!ctx->preroll_closing) {
+            mark = voice_profile_now();
+            close_utterance(ctx, &frame);
+            stage_done(ctx, VOICE_STAGE_RECORD, mark);
+        }
+    } else if (ctx->preroll_closing && !ctx->preroll_active) {
+        close_utterance(ctx, &frame);
+    }
+    
+    /* Invoke audio callback if registered */
+    mark = voice_profile_now();
+    if (ctx->audio_callback) {
+        ctx->audio_callback(frame.samples, VOICE_FRAME_SIZE,
+                           VOICE_CHANNELS, ctx->audio_callback_data);
+        mark = stage_done(ctx, VOICE_STAGE_CALLBACK, mark);
+    }
+    
+    /* Commit to circular buffer (lock-free, never blocks) */
+    voice_ring_write(&ctx->ring, frame.samples, VOICE_FRAME_SIZE);
+    notify_subscribers(ctx, VOICE_STREAM_RAW);
+    if (ctx->mono_buffer) {
+        voice_ring_write(&ctx->mono_ring, frame.mono, VOICE_FRAME_SIZE);
+        notify_subscribers(ctx, VOICE_STREAM_MONO);
+    }
+    stage_done(ctx, VOICE_STAGE_COMMIT, mark);
+    
+    /* Samples are no longer referenced */
+    release_frame(ctx, ref);
+    stage_done(ctx, VOICE_STAGE_FRAME, frame_start);
+}
+
+/* Reserve the chunk to fill next; NULL while the consumer is behind */
+static voice_recording_chunk_t* open_chunk(voice_context_t* ctx, uint32_t timestamp_ms) {
+    if (!ctx->chunk) {
+        ctx->chunk = (voice_recording_chunk_t*)voice_fifo_reserve(&ctx->chunk_fifo);
+        if (!ctx->chunk) {
+            return NULL;
+        }
+        ctx->chunk->sequence = ctx->chunk_sequence;
+        ctx->chunk->trace_id = ctx->trace.trace_id;
+        ctx->chunk->timestamp_ms = timestamp_ms;
+        ctx->chunk->num_samples = 0;
+        ctx->chunk->dropped_samples = ctx->chunk_dropped;
+        ctx->chunk->final = false;
+        ctx->chunk->codec = ctx->encoder ? ctx->encoder->codec : VOICE_CODEC_PCM16;
+        ctx->chunk->num_packets = 0;
+        ctx->chunk->data_bytes = 0;
+        ctx->chunk_dropped = 0;
+    }
+    return ctx->chunk;
+}
+
+/* Publish the chunk being filled */
+static void commit_chunk(voice_context_t* ctx, bool final) {
+    ctx->chunk->final = final;
+    voice_fifo_commit(&ctx->chunk_fifo);
+    ctx->chunk = NULL;
+    ctx->chunk_sequence++;
+    xSemaphoreGive(ctx->chunk_ready);
+}
+
+/* Start a streamed utterance (processing task) */
+static void open_recording_stream(voice_context_t* ctx) {
+    ctx->chunk_sequence = 0;
+    if (ctx->encoder) {
+        ctx->encoder->init(ctx->encoder_state, VOICE_SAMPLE_RATE);
+        ctx->encoder_fill = 0;
+    }
+}
+
+/* Encode the buffered packet into the open chunk */
+static void encode_packet(voice_context_t* ctx, voice_recording_chunk_t* chunk) {
+    size_t bytes = ctx->encoder->encode(ctx->encoder_state, ctx->encoder_pcm,
+                                        &chunk->data[chunk->data_bytes]);
+    if (bytes > ctx->encoder->max_packet_bytes) {
+        bytes = 0;
+    }
+    
+    chunk->packet_bytes[chunk->num_packets++] = (uint16_t)bytes;
+    chunk->data_bytes += (uint32_t)bytes;
+    chunk->num_samples += ctx->encoder->frame_samples;
+    ctx->encoder_fill = 0;
+}
+
+/* Append a beamformed frame to a streamed recording */
+static void stream_frame(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    uint32_t packet_samples = ctx->encoder ? ctx->encoder->frame_samples : VOICE_FRAME_SIZE;
+    if (ctx->encoder && ctx->encoder_fill == 0) {
+        ctx->encoder_timestamp_ms = frame->timestamp_ms;
+    }
+    uint32_t timestamp_ms = ctx->encoder ? ctx->encoder_timestamp_ms : frame->timestamp_ms;
+    
+    /* Only the frame that completes a packet needs somewhere to go */
+    bool completes = !ctx->encoder ||
+                     ctx->encoder_fill + VOICE_FRAME_SIZE == packet_samples;
+    voice_recording_chunk_t* chunk = completes ? open_chunk(ctx, timestamp_ms) : NULL;
+    if (completes && !chunk) {
+        /* Consumer is behind; capture does not wait for it */
+        ctx->chunk_dropped += packet_samples;
+        ctx->stats.buffer_overruns += packet_samples / VOICE_FRAME_SIZE;
+        ctx->encoder_fill = 0;
+        return;
+    }
+    
+    if (!ctx->encoder) {
+        memcpy(&chunk->samples[chunk->num_samples], frame->mono,
+               VOICE_FRAME_SIZE * sizeof(int16_t));
+        chunk->num_samples += VOICE_FRAME_SIZE;
+        chunk->data_bytes += VOICE_FRAME_SIZE * sizeof(int16_t);
+    } else {
+        memcpy(&ctx->encoder_pcm[ctx->encoder_fill], frame->mono,
+               VOICE_FRAME_SIZE * sizeof(int16_t));
+        ctx->encoder_fill += VOICE_FRAME_SIZE;
+        if (!completes) {
+            return;
+        }
+        encode_packet(ctx, chunk);
+    }
+    
+    if (chunk->num_samples + packet_samples > VOICE_RECORDING_CHUNK_SAMPLES) {
+        commit_chunk(ctx, false);
+    }
+}
+
+/* Append a beamformed frame to the recording (processing task);
+ * false once the recording buffer is full */
+static bool record_frame(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    if (ctx->chunks) {
+        stream_frame(ctx, frame);
+        return true;
+    }
+    
+    size_t frame_bytes = VOICE_FRAME_SIZE * sizeof(int16_t);
+    if (ctx->recording_size + frame_bytes > ctx->recording_capacity) {
+        /* Buffer full: end the utterance rather than lose its middle */
+        ctx->stats.buffer_overruns++;
+        voice_stop_recording(ctx);
+        return false;
+    }
+    
+    /* Copy beamformed mono audio */
+    memcpy(ctx->recording_buffer + ctx->recording_size, frame->mono, frame_bytes);
+    ctx->recording_size += frame_bytes;
+    return true;
+}
+
+/* Deliver the final chunk; retried next frame while the consumer is behind */
+static void finish_recording_stream(voice_context_t* ctx, uint32_t timestamp_ms) {
+    if (ctx->encoder && ctx->encoder_fill > 0) {
+        timestamp_ms = ctx->encoder_timestamp_ms;
+    }
+    voice_recording_chunk_t* chunk = open_chunk(ctx, timestamp_ms);
+    if (!chunk) {
+        return;
+    }
+    
+    /* Pad the last packet with silence so it stays frame-aligned */
+    if (ctx->encoder && ctx->encoder_fill > 0) {
+        memset(&ctx->encoder_pcm[ctx->encoder_fill], 0,
+               (ctx->encoder->frame_samples - ctx->encoder_fill) * sizeof(int16_t));
+        encode_packet(ctx, chunk);
+    }
+    
+    commit_chunk(ctx, true);
+    ctx->utterance_open = false;
+}
+
+/* Start the recording with the audio captured before it. The ring is
+ * read back steered, like the live stream, and spread over at most
+ * PREROLL_CATCHUP_FRAMES live frames, so neither the frame nor the
+ * consumer's chunks take the pre-roll in one burst. */
+static void begin_preroll(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    if (ctx->pipeline.recording_preroll_ms == 0) {
+        return;
+    }
+    
+    /* One more frame is read to prime the beam's delay lines. Cleaned
+     * history runs one frame behind, like the live stream, whose next
+     * output is the newest history frame; the silence the suppressor
+     * gives first is dropped too. */
+    bool denoise = (ctx->denoise_level > 0.0f);
+    uint32_t skip = denoise ? 2 : 1;
+    uint32_t position = voice_ring_position(&ctx->ring);
+    uint32_t frames = history_samples(ctx, ctx->pipeline.recording_preroll_ms *
+                                      (VOICE_SAMPLE_RATE / 1000) +
+                                      skip * VOICE_FRAME_SIZE, position) / VOICE_FRAME_SIZE;
+    if (frames <= skip) {
+        return;
+    }
+    
+    history_reader_init(ctx, ctx->preroll, position - frames * VOICE_FRAME_SIZE);
+    if (denoise) {
+        voice_denoise_stream_reset(ctx->denoiser, ctx->denoise_history);
+    }
+    ctx->preroll_skip = skip;
+    ctx->preroll_frames = frames - skip;
+    ctx->preroll_timestamp_ms = frame->timestamp_ms - frames * FRAME_DURATION_MS;
+    ctx->preroll_keep = 0;
+    ctx->preroll_pending = 0;
+    
+    /* Each live frame adds one to the backlog and takes rate off it */
+    ctx->preroll_rate = 1 + (frames + PREROLL_CATCHUP_FRAMES - 1) / PREROLL_CATCHUP_FRAMES;
+    ctx->preroll_active = true;
+}
+
+/* Record up to max_frames of the pre-roll backlog; the pre-roll ends
+ * once every frame it owes is in (processing task) */
+static void drain_preroll(voice_context_t* ctx, uint32_t max_frames) {
+    bool denoise = (ctx->denoise_level > 0.0f);
+    uint32_t position = voice_ring_position(&ctx->ring);
+    int16_t mono[VOICE_FRAME_SIZE];
+    int16_t clean[VOICE_FRAME_SIZE];
+    
+    /* Frames still to read; live frames are owed once in the ring */
+    uint32_t owed = ctx->preroll_skip + ctx->preroll_frames + ctx->preroll_pending;
+    for (; owed > 0 && max_frames > 0 && ctx->preroll->reader.cursor != position;
+         owed--, max_frames--) {
+        voice_frame_view_t recorded = { .mono = mono };
+        recorded.timestamp_ms = ctx->preroll_timestamp_ms;
+        ctx->preroll_timestamp_ms += FRAME_DURATION_MS;
+        
+        if (!read_history_frame(ctx, ctx->preroll, mono)) {
+            /* Overwritten while read: the rest is too old to use */
+            ctx->stats.buffer_overruns++;
+            ctx->preroll_active = false;
+            return;
+        }
+        if (denoise) {
+            voice_denoise_process(ctx->denoiser, ctx->denoise_history, mono, false, clean);
+            recorded.mono = clean;
+            recorded.timestamp_ms -= FRAME_DURATION_MS;
+        }
+        if (ctx->preroll_skip > 0) {
+            ctx->preroll_skip--;
+            continue;
+        }
+        
+        /* The pre-roll is kept whole; live frames as they would have been */
+        bool keep = true;
+        if (ctx->preroll_frames > 0) {
+            ctx->preroll_frames--;
+        } else {
+            keep = ctx->preroll_keep & 1;
+            ctx->preroll_keep >>= 1;
+            ctx->preroll_pending--;
+        }
+        if (keep && !record_frame(ctx, &recorded)) {
+            ctx->preroll_active = false;
+            return;
+        }
+    }
+    
+    if (owed == 0) {
+        ctx->preroll_active = false;
+    }
+}
+
+/* Recording started (processing task) */
+static void open_utterance(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    ctx->utterance_open = true;
+    ctx->utterance_speech = false;
+    trace_write_begin(ctx);
+    ctx->trace.recording_start_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    ctx->trace.recording = true;
+    trace_write_end(ctx);
+    if (ctx->chunks) {
+        open_recording_stream(ctx);
+    }
+    begin_preroll(ctx, frame);
+}
+
+/* Recording stopped (processing task) */
+static void close_utterance(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    /* Closed while catching up: the backlog goes now, and a frame it
+     * owes that is not in the ring yet, this one, from the live stream */
+    if (ctx->preroll_active) {
+        drain_preroll(ctx, UINT32_MAX);
+        if (ctx->preroll_active && ctx->preroll_pending == 1 && (ctx->preroll_keep & 1)) {
+            voice_frame_view_t recorded = recorded_frame(ctx, frame);
+            record_frame(ctx, &recorded);
+        }
+        ctx->preroll_active = false;
+    }
+    ctx->preroll_closing = false;
+    
+    /* Nothing but silence after the wake word: it was not meant */
+    if (!ctx->utterance_speech) {
+        voice_report_false_wake(ctx);
+    }
+    
+    if (ctx->chunks) {
+        finish_recording_stream(ctx, frame->timestamp_ms);
+    } else {
+        ctx->utterance_open = false;
+    }
+}
+
+/* Detect voice activity */
+static bool detect_voice_activity(voice_context_t* ctx, voice_frame_view_t* frame) {
+    /* Per-channel energy in a single pass over the interleaved frame */
+    uint64_t sum_squares[VOICE_CHANNELS];
+    ctx->kernels.sum_squares(&ctx->kernels, frame->samples, sum_squares);
+    
+    voice_db_t total_energy = 0;
+    int active_channels = 0;
+    
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        voice_db_t energy = voice_dsp_level_db(sum_squares[ch], VOICE_FRAME_SIZE);
+        frame->energy_db[ch] = energy;
+        
+        if (energy > ctx->noise_floor + ctx->channel_offset[ch] + VOICE_DB(6.0f)) { // 6dB above noise floor
+            active_channels++;
+        }
+        
+        total_energy += energy;
+    }
+    
+    voice_db_t avg_energy = total_energy / VOICE_CHANNELS;
+    ctx->avg_energy = avg_energy;
+    
+    /* Update noise floor: minimum statistics throughout once the
+     * tracker has a window, otherwise the EMA during silence */
+    voice_db_t tracked;
+    if (ctx->pipeline.noise_tracking_ms > 0) {
+        voice_noise_tracker_update(&ctx->noise_tracker, avg_energy);
+    }
+    if (ctx->pipeline.noise_tracking_ms > 0 &&
+        voice_noise_tracker_estimate(&ctx->noise_tracker, &tracked)) {
+        ctx->noise_floor = tracked;
+    } else if (!ctx->vad_active) {
+        update_noise_floor(ctx, avg_energy);
+    }
+    
+    /* VAD decision based on energy and active channels */
+    bool energy_vad = avg_energy > ctx->noise_floor + VOICE_DB(10.0f);
+    bool channel_vad = active_channels >= (VOICE_CHANNELS / 2);
+    
+    if (energy_vad && channel_vad) {
+        ctx->vad_frame_count++;
+    } else {
+        ctx->vad_frame_count = 0;
+    }
+    
+    /* Require multiple consecutive frames */
+    ctx->vad_active = ctx->vad_frame_count >= VAD_FRAME_THRESHOLD;
+    
+    return ctx->vad_active;
+}
+
+/* Run the suppressor over the live stream (processing task) */
+static void apply_noise_suppression(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    /* A new level waits for the utterance to close, so a recording is
+     * cleaned, or not, throughout */
+    float level = ctx->noise_suppression;
+    if (level != ctx->denoise_level && !ctx->utterance_open) {
+        if (ctx->denoise_level == 0.0f) {
+            voice_denoise_stream_reset(ctx->denoiser, ctx->denoise_live);
+        }
+        voice_denoise_set_level(ctx->denoiser, level);
+        ctx->denoise_level = level;
+    }
+    
+    /* Calibration reads the live stream's levels, cleaned or not */
+    if (ctx->denoise_level > 0.0f || ctx->calibration_frames > 0) {
+        voice_denoise_process(ctx->denoiser, ctx->denoise_live, frame->mono,
+                              !frame->vad_active, ctx->denoise_output);
+    }
+    if (ctx->calibration_frames > 0) {
+        voice_denoise_calibrate_update(ctx->denoiser, ctx->denoise_live);
+    }
+}
+
+/* Start collecting a calibration (processing task) */
+static void begin_noise_calibration(voice_context_t* ctx) {
+    ctx->calibration_frames = ctx->calibration_request;
+    ctx->calibration_request = 0;
+    
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        voice_noise_min_reset(&ctx->calibration[ch], VOICE_DB(NOISE_MIN_BIAS_DB));
+    }
+    
+    /* An idle suppressor's stream is stale */
+    if (ctx->denoise_level == 0.0f) {
+        voice_denoise_stream_reset(ctx->denoiser, ctx->denoise_live);
+    }
+    voice_denoise_calibrate_begin(ctx->denoiser);
+}
+
+/* Collect one calibration frame; seed VAD and suppressor after the last */
+static void update_noise_calibration(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        voice_noise_min_update(&ctx->calibration[ch], frame->energy_db[ch]);
+    }
+    
+    if (--ctx->calibration_frames > 0) {
+        return;
+    }
+    
+    /* The floor is compared with the channel average, so it is the
+     * average estimate, and each channel keeps its difference */
+    voice_db_t estimate[VOICE_CHANNELS];
+    voice_db_t total = 0;
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        estimate[ch] = voice_noise_min_estimate(&ctx->calibration[ch]);
+        total += estimate[ch];
+    }
+    ctx->noise_floor = total / VOICE_CHANNELS;
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        ctx->channel_offset[ch] = estimate[ch] - ctx->noise_floor;
+    }
+    
+    if (ctx->pipeline.noise_tracking_ms > 0) {
+        voice_noise_tracker_seed(&ctx->noise_tracker, ctx->noise_floor);
+    }
+    voice_denoise_calibrate_end(ctx->denoiser);
+    ctx->noise_calibrations++;
+}
+
+/* The frame as recorded: cleaned audio runs one frame behind */
+static voice_frame_view_t recorded_frame(const voice_context_t* ctx,
+                                         const voice_frame_view_t* frame) {
+    voice_frame_view_t recorded = *frame;
+    if (ctx->denoise_level > 0.0f) {
+        recorded.mono = ctx->denoise_output;
+        recorded.timestamp_ms -= FRAME_DURATION_MS;
+    }
+    return recorded;
+}
+
+/* Steer toward the tracked talker direction */
+static void track_direction(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    int index;
+    if (voice_doa_update(ctx->doa, frame->samples, &index)) {
+        ctx->current_steering_angle = index * (360.0f / BEAMFORM_ANGLE_STEPS);
+        voice_beamform_steer(ctx->beamformer, ctx->current_steering_angle);
+        ctx->beam_steers++;
+    }
+}
+
+/* Apply the caller's steering between frames (processing task). The
+ * mode goes first, so that a direction set with it seeds the tracker */
+static void apply_beam_request(voice_context_t* ctx, uint8_t request) {
+    if (request & BEAM_REQUEST_ADAPTIVE) {
+        ctx->config.beamform.adaptive_mode = ctx->adaptive_request;
+    }
+    
+    /* Only a direction change touches the steering selection */
+    if (request & BEAM_REQUEST_STEER) {
+        ctx->current_steering_angle = ctx->steer_request;
+        voice_beamform_steer(ctx->beamformer, ctx->current_steering_angle);
+    }
+    voice_beamform_enable(ctx->beamformer,
+                          ctx->config.beamform.adaptive_mode ||
+                          ctx->current_steering_angle != 0.0f);
+    
+    /* Tracking carries on from the current direction */
+    if (ctx->config.beamform.adaptive_mode) {
+        voice_doa_reset(ctx->doa, ctx->beamformer->active_index);
+    }
+}
+
+/* Apply beamforming to frame */
+static void apply_beamforming(voice_context_t* ctx, voice_frame_view_t* frame) {
+    /* Steering delays come from the precomputed table; no per-frame trig */
+    voice_beamform_process(ctx->beamformer, frame->samples, ctx->beam_output);
+    frame->mono = ctx->beam_output;
+}
+
+/* Process wake word detection */
+static void process_wake_word_detection(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    /* Streaming front-end: only the MFCC frames this audio completes are
+     * computed, and models see the rolling window in place */
+    wake_engine_process(ctx->wake_word_engine, frame->mono,
+                        VOICE_FRAME_SIZE, frame->timestamp_ms);
+}
+
+/* Pick the wake stage tier for this frame (processing task) */
+static wake_gate_t update_wake_gate(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    if (!ctx->pipeline.wake_gating) {
+        ctx->wake_gate_frames[WAKE_GATE_FULL]++;
+        return WAKE_GATE_FULL;
+    }
+    
+    wake_gate_t gate = ctx->wake_gate;
+    if (frame->vad_active) {
+        /* Speech-like activity: run inference */
+        gate = WAKE_GATE_FULL;
+        ctx->wake_hold_until_ms = frame->timestamp_ms + ctx->pipeline.wake_hangover_ms;
+    } else if (ctx->vad_frame_count > 0) {
+        /* Energy onset, not yet confirmed: keep the features current */
+        if (gate == WAKE_GATE_OFF) {
+            gate = WAKE_GATE_FEATURES;
+        }
+        ctx->wake_hold_until_ms = frame->timestamp_ms + ctx->pipeline.wake_hangover_ms;
+    } else if ((int32_t)(frame->timestamp_ms - ctx->wake_hold_until_ms) >= 0) {
+        gate = WAKE_GATE_OFF;
+    }
+    
+    ctx->wake_gate = gate;
+    ctx->wake_gate_frames[gate]++;
+    return gate;
+}
+
+/* Samples of history ending at ring_position that are safe to read back */
+static uint32_t history_samples(const voice_context_t* ctx, uint32_t samples,
+                                uint32_t ring_position) {
+    if (samples > ctx->history_limit) {
+        samples = ctx->history_limit;
+    }
+    if (samples > ring_position) {
+        samples = ring_position;
+    }
+    return samples;
+}
+
+/* Attach a steered history reader at an earlier position of source's
+ * ring; the first frame read primes its delay lines */
+static void history_reader_init(const voice_context_t* source,
+                                voice_history_reader_t* history, uint32_t position) {
+    voice_ring_reader_init_at(&history->reader, &source->ring, position);
+    voice_beamform_lines_reset(&history->lines);
+}
+
+/* Beamform the next whole frame of history, steered as the live stream
+ * is now; false if less than a frame is left or it was overwritten */
+static bool read_history_frame(voice_context_t* source, voice_history_reader_t* history,
+                               int16_t* mono) {
+    voice_span_t spans[2];
+    if (voice_ring_peek(&history->reader, spans, VOICE_FRAME_SIZE) < VOICE_FRAME_SIZE) {
+        return false;
+    }
+    
+    /* In place unless the ring's end splits the frame */
+    const int16_t* samples = spans[0].data;
+    if (spans[1].samples > 0) {
+        size_t first = spans[0].samples * VOICE_CHANNELS;
+        memcpy(history->frame, spans[0].data, first * sizeof(int16_t));
+        memcpy(&history->frame[first], spans[1].data,
+               spans[1].samples * VOICE_CHANNELS * sizeof(int16_t));
+        samples = history->frame;
+    }
+    
+    voice_beamform_process_lines(source->beamformer, &history->lines, samples, mono);
+    return voice_ring_release(&history->reader, VOICE_FRAME_SIZE);
+}
+
+/* Refill the front-end's whole window before an onset (wake stage):
+ * silence for what the backfill does not cover, as reset_wake_gate()
+ * primes it, then the ring's history steered as the live beam is.
+ * source is the array the audio comes from, ctx owns the engine. */
+static void backfill_wake_frontend(voice_context_t* ctx, voice_context_t* source,
+                                   uint32_t ring_position) {
+    static const int16_t silence[VOICE_FRAME_SIZE];
+    const uint32_t window = WAKE_WORD_WINDOW_MS / FRAME_DURATION_MS;
+    uint32_t wanted = ctx->pipeline.wake_backfill_ms / FRAME_DURATION_MS;
+    if (wanted > window) {
+        wanted = window;
+    }
+    
+    /* One frame more, when the ring has it, primes the beam's delay lines */
+    uint32_t frames = history_samples(source, (wanted + 1) * VOICE_FRAME_SIZE,
+                                      ring_position) / VOICE_FRAME_SIZE;
+    bool prime = frames > wanted;
+    uint32_t history = prime ? wanted : frames;
+    
+    /* Features only; inference starts with the live frame */
+    wake_engine_set_gate(ctx->wake_word_engine, WAKE_GATE_FEATURES);
+    ctx->engine_gate = WAKE_GATE_FEATURES;
+    
+    for (uint32_t f = history; f < window; f++) {
+        wake_engine_process(ctx->wake_word_engine, silence, VOICE_FRAME_SIZE, 0);
+    }
+    
+    history_reader_init(source, ctx->wake_history, ring_position - frames * VOICE_FRAME_SIZE);
+    int16_t mono[VOICE_FRAME_SIZE];
+    if (prime && !read_history_frame(source, ctx->wake_history, mono)) {
+        history = 0;
+    }
+    for (uint32_t f = 0; f < history; f++) {
+        if (!read_history_frame(source, ctx->wake_history, mono)) {
+            break;
+        }
+        wake_engine_process(ctx->wake_word_engine, mono, VOICE_FRAME_SIZE, 0);
+    }
+    
+    ctx->wake_backfills++;
+}
+
+/* Wake stage for one frame of source at the tier the processing task
+ * chose (source is ctx except in a pool) */
+static void run_wake_stage(voice_context_t* ctx, voice_context_t* source,
+                           const voice_frame_view_t* frame,
+                           wake_gate_t gate, bool onset, uint32_t ring_position) {
+    if (onset) {
+        backfill_wake_frontend(ctx, source, ring_position);
+    }
+    if (gate != ctx->engine_gate) {
+        wake_engine_set_gate(ctx->wake_word_engine, gate);
+        ctx->engine_gate = gate;
+    }
+    
+    if (gate != WAKE_GATE_OFF) {
+        /* The floor is the processing task's; a stale read only delays
+         * a band switch by a frame */
+        if (ctx->pipeline.wake_false_accepts_per_hour > 0.0f) {
+            wake_engine_set_noise_floor(ctx->wake_word_engine,
+                                        VOICE_DB_TO_FLOAT(source->noise_floor));
+        }
+        ctx->wake_queued_ms = frame->queued_ms;
+        process_wake_word_detection(ctx, frame);
+    }
+    if (ctx->feature_buffer) {
+        publish_features(ctx);
+    }
+}
+
+/* Copy the engine's new feature frames to the feature ring as Q7 */
+static void publish_features(voice_context_t* ctx) {
+    wake_feature_view_t view;
+    wake_engine_new_features(ctx->wake_word_engine, &ctx->feature_position, &view);
+    if (view.frames == 0) {
+        return;
+    }
+    
+    const float scale = (float)(1 << VOICE_FEATURE_FRAC_BITS);
+    int16_t row[WAKE_WORD_FEATURE_DIM];
+    for (uint32_t f = 0; f < view.frames; f++) {
+        const float* src = &view.data[(size_t)f * view.stride];
+        for (uint32_t i = 0; i < view.dim; i++) {
+            float q = src[i] * scale;
+            row[i] = voice_dsp_sat16((int32_t)(q < 0.0f ? q - 0.5f : q + 0.5f));
+        }
+        voice_ring_write(&ctx->feature_ring, row, 1);
+    }
+    notify_subscribers(ctx, VOICE_STREAM_FEATURES);
+}
+
+/* Wake every subscriber of a stream; never waits */
+static void notify_subscribers(voice_context_t* ctx, voice_stream_t stream) {
+    for (int i = 0; i < VOICE_MAX_SUBSCRIBERS; i++) {
+        voice_subscriber_t* sub = &ctx->subscribers[i];
+        if (atomic_load_explicit(&sub->active, memory_order_acquire) &&
+            sub->stream == stream) {
+            xSemaphoreGive(sub->ready);
+        }
+    }
+}
+
+/* Gate the processing task chooses, back to its starting tier */
+static void reset_wake_gate(voice_context_t* ctx) {
+    ctx->wake_hold_until_ms = 0;
+    ctx->wake_gate = ctx->pipeline.wake_gating ? WAKE_GATE_OFF : WAKE_GATE_FULL;
+}
+
+/* Start gated: fill the window with silence so the first onset can infer
+ * (task that runs the engine) */
+static void prime_wake_engine(voice_context_t* ctx) {
+    static const int16_t silence[VOICE_FRAME_SIZE];
+    
+    /* A pool member other than the lead has no engine to prime */
+    if (!ctx->wake_word_engine) {
+        return;
+    }
+    if (!ctx->pipeline.wake_gating) {
+        ctx->engine_gate = WAKE_GATE_FULL;
+        return;
+    }
+    
+    wake_engine_set_gate(ctx->wake_word_engine, WAKE_GATE_FEATURES);
+    for (uint32_t ms = 0; ms < WAKE_WORD_WINDOW_MS;
+         ms += FRAME_DURATION_MS) {
+        wake_engine_process(ctx->wake_word_engine, silence, VOICE_FRAME_SIZE, 0);
+    }
+    wake_engine_set_gate(ctx->wake_word_engine, WAKE_GATE_OFF);
+    ctx->engine_gate = WAKE_GATE_OFF;
+    
+    /* The silence is not published to feature subscribers */
+    wake_feature_view_t skipped;
+    wake_engine_new_features(ctx->wake_word_engine, &ctx->feature_position, &skipped);
+}
+
+/* voice_reset() reaching the engine, on the task that runs it */
+static void reset_wake_engine(voice_context_t* ctx) {
+    wake_engine_reset(ctx->wake_word_engine);
+    prime_wake_engine(ctx);
+}
+
+/* Hand a beamformed frame to the wake stage; drops it when the queue is full */
+static void submit_wake_job(voice_context_t* ctx, const voice_frame_view_t* frame,
+                            wake_gate_t gate, bool onset, uint32_t ring_position) {
+    voice_wake_job_t* job = (voice_wake_job_t*)voice_fifo_reserve(&ctx->wake_fifo);
+    if (!job) {
+        /* Wake stage is behind; keep capture real-time */
+        ctx->wake_drops++;
+        return;
+    }
+    
+    memcpy(job->mono, frame->mono, sizeof(job->mono));
+    job->timestamp_ms = frame->timestamp_ms;
+    job->queued_ms = frame->queued_ms;
+    job->ring_position = ring_position;
+    job->gate = gate;
+    job->onset = onset;
+    job->listening = (ctx->state == VOICE_STATE_IDLE || ctx->state == VOICE_STATE_LISTENING);
+    job->epoch = ctx->wake_epoch;
+    job->reset = ctx->wake_reset_pending;
+    ctx->wake_reset_pending = false;
+    if (ctx->pipeline.pool) {
+        uint64_t sum_squares;
+        voice_dsp_sum_squares(frame->mono, VOICE_FRAME_SIZE, 1, &sum_squares);
+        job->score = voice_dsp_level_db(sum_squares, VOICE_FRAME_SIZE) - ctx->noise_floor;
+        job->active = frame->vad_active || ctx->vad_frame_count > 0;
+    }
+    voice_fifo_commit(&ctx->wake_fifo);
+    
+    uint32_t depth = voice_fifo_count(&ctx->wake_fifo);
+    if (depth > ctx->wake_high_water) {
+        ctx->wake_high_water = depth;
+    }
+    xTaskNotifyGive(ctx->wake_task);
+}
+
+/* The part of a frame the wake stage reads */
+static voice_frame_view_t wake_job_frame(const voice_wake_job_t* job) {
+    voice_frame_view_t frame = {
+        .mono = job->mono,
+        .timestamp_ms = job->timestamp_ms,
+        .queued_ms = job->queued_ms
+    };
+    return frame;
+}
+
+/* Whether a job is worth inference: its array was listening, and no
+ * detection was posted since it was queued (wake stage) */
+static bool wake_job_live(const voice_context_t* ctx, const voice_wake_job_t* job) {
+    return job->listening && job->epoch != ctx->wake_stale_epoch;
+}
+
+/* Wake stage task (split pipeline): features and inference */
+static void voice_wake_task(void* param) {
+    voice_context_t* ctx = (voice_context_t*)param;
     
     while (1) {
-        /* Wait for frame */
-        if (xQueueReceive(ctx->frame_queue, &frame, portMAX_DELAY) == pdPASS) {
-            /* Update statistics */
-            ctx->stats.frames_processed++;
-            
-            /* Apply beamforming if enabled */
-            if (ctx->config.beamform.adaptive_mode || 
-                ctx->current_steering_angle != 0.0f) {
-                apply_beamforming(ctx, &frame);
-            }
-            
-            /* Detect voice activity */
-            bool vad_result = detect_voice_activity(ctx, &frame);
-            frame.vad_active = vad_result;
-            
-            if (vad_result) {
-                ctx->stats.vad_activations++;
-            }
-            
-            /* State machine */
-            switch (ctx->state) {
-                case VOICE_STATE_IDLE:
-                case VOICE_STATE_LISTENING:
-                    /* Check for wake word */
-                    process_wake_word_detection(ctx, &frame);
-                    break;
-                    
-                case VOICE_STATE_WAKE_DETECTED:
-                    /* Automatically transition to recording */
-                    ctx->state = VOICE_STATE_RECORDING;
-                    ctx->recording_start_time = frame.timestamp_ms;
-                    ctx->recording_size = 0;
-                    ctx->is_recording = true;
-                    /* Fall through to recording */
-                    
-                case VOICE_STATE_RECORDING:
-                    /* Record audio if VAD active */
-                    if (frame.vad_active && ctx->is_recording) {
-                        /* Add frame to recording buffer */
-                        size_t frame_bytes = VOICE_FRAME_SIZE * sizeof(int16_t);
-                        if (ctx->recording_size + frame_bytes <= ctx->recording_capacity) {
-                            /* Copy beamformed mono audio */
-                            int16_t mono_frame[VOICE_FRAME_SIZE];
-                            for (int i = 0; i < VOICE_FRAME_SIZE; i++) {
-                                float sum = 0.0f;
-                                for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
-                                    sum += frame.samples[i * VOICE_CHANNELS + ch] * 
-                                           ctx->beamform_weights[ch];
-                                }
-                                mono_frame[i] = (int16_t)fminf(fmaxf(sum, -32768.0f), 32767.0f);
-                            }
-                            
-                            memcpy(ctx->recording_buffer + ctx->recording_size,
-                                   mono_frame, frame_bytes);
-                            ctx->recording_size += frame_bytes;
-                        }
-                    }
-                    
-                    /* Check recording timeout */
-                    if (frame.timestamp_ms - ctx->recording_start_time > 
-                        ctx->max_recording_duration) {
-                        voice_stop_recording(ctx);
-                    }
-                    break;
-                    
-                case VOICE_STATE_PROCESSING:
-                    /* Wait for external processing to complete */
-                    break;
-                    
-                case VOICE_STATE_ERROR:
-                    /* Error state - might need reset */
-                    break;
-            }
-            
-            /* Invoke audio callback if registered */
-            if (ctx->audio_callback) {
-                ctx->audio_callback(frame.samples, VOICE_FRAME_SIZE,
-                                   VOICE_CHANNELS, ctx->audio_callback_data);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        const voice_wake_job_t* job;
+        while ((job = (const voice_wake_job_t*)voice_fifo_front(&ctx->wake_fifo)) != NULL) {
+            if (job->reset) {
+                reset_wake_engine(ctx);
             }
             
-            /* Update circular buffer */
-            if (xSemaphoreTake(ctx->buffer_mutex, pdMS_TO_TICKS(10)) == pdPASS) {
-                size_t write_size = VOICE_FRAME_SIZE * VOICE_CHANNELS;
-                memcpy(&ctx->circular_buffer[ctx->buffer_write_idx],
-                       frame.samples, write_size * sizeof(int16_t));
-                
-                ctx->buffer_write_idx = (ctx->buffer_write_idx + write_size) %
-                                       (VOICE_BUFFER_SIZE * VOICE_CHANNELS);
-                
-                xSemaphoreGive(ctx->buffer_mutex);
+            /* Frames queued behind a detection are stale; only their tier counts */
+            if (wake_job_live(ctx, job)) {
+                uint32_t mark = voice_profile_now();
+                voice_frame_view_t frame = wake_job_frame(job);
+                run_wake_stage(ctx, ctx, &frame, job->gate, job->onset, job->ring_position);
+                if (ctx->wake_post_sent) {
+                    ctx->wake_post_sent = false;
+                    ctx->wake_stale_epoch = job->epoch;
+                }
+                stage_done(ctx, VOICE_STAGE_WAKE, mark);
+            } else if (job->gate != ctx->engine_gate) {
+                wake_engine_set_gate(ctx->wake_word_engine, job->gate);
+                ctx->engine_gate = job->gate;
             }
+            voice_fifo_pop(&ctx->wake_fifo);
         }
     }
 }
 
-/* Calculate energy in dB */
-static float calculate_energy_db(const int16_t* samples, size_t num_samples) {
-    if (!samples || num_samples == 0) {
-        return -100.0f;
-    }
+/* Pool worker: one frame of one member per turn, so arrays share the
+ * workers fairly and a member's frames never run on two at once */
+static void voice_pool_worker(void* param) {
+    voice_pool_t* pool = (voice_pool_t*)param;
+    voice_context_t* ctx;
+    voice_frame_ref_t ref;
     
-    float sum = 0.0f;
-    for (size_t i = 0; i < num_samples; i++) {
-        float normalized = samples[i] / 32768.0f;
-        sum += normalized * normalized;
+    while (1) {
+        if (xQueueReceive(pool->run_queue, &ctx, portMAX_DELAY) != pdPASS) {
+            continue;
+        }
+        
+        if (xQueueReceive(ctx->frame_queue, &ref, 0) == pdPASS) {
+            process_frame(ctx, &ref);
+        }
+        
+        /* Go to the back of the run queue with frames left; otherwise
+         * leave it, unless a frame arrived as the flag was cleared */
+        if (uxQueueMessagesWaiting(ctx->frame_queue) > 0) {
+            xQueueSend(pool->run_queue, &ctx, 0);
+        } else {
+            atomic_store(&ctx->scheduled, false);
+            if (uxQueueMessagesWaiting(ctx->frame_queue) > 0 &&
+                !atomic_exchange(&ctx->scheduled, true)) {
+                xQueueSend(pool->run_queue, &ctx, 0);
+            }
+        }
     }
-    
-    float rms = sqrtf(sum / num_samples);
-    return 20.0f * log10f(fmaxf(rms, 1e-6f));
 }
 
-/* Detect voice activity */
-static bool detect_voice_activity(voice_context_t* ctx, const voice_frame_t* frame) {
-    /* Calculate energy for each channel */
-    float total_energy = 0.0f;
-    int active_channels = 0;
+/* The oldest period is complete once every member handed in a frame,
+ * or once one member has a full queue waiting on the others */
+static bool pool_period_ready(voice_pool_t* pool) {
+    bool waiting = false;
+    bool missing = false;
+    bool full = false;
+    
+    for (uint32_t i = 0; i < pool->num_members; i++) {
+        uint32_t count = voice_fifo_count(&pool->members[i]->wake_fifo);
+        waiting |= (count > 0);
+        missing |= (count == 0);
+        full |= (count >= VOICE_WAKE_QUEUE_LENGTH);
+    }
+    return waiting && (!missing || full);
+}
+
+/* Pick the best beam of one period and run the wake stage on it alone */
+static void run_pool_period(voice_pool_t* pool) {
+    const voice_wake_job_t* jobs[VOICE_POOL_MAX_MEMBERS];
+    uint32_t period_ms = 0;
+    bool first = true;
+    
+    for (uint32_t i = 0; i < pool->num_members; i++) {
+        jobs[i] = (const voice_wake_job_t*)voice_fifo_front(&pool->members[i]->wake_fifo);
+        if (jobs[i] && (first || (int32_t)(jobs[i]->timestamp_ms - period_ms) < 0)) {
+            period_ms = jobs[i]->timestamp_ms;
+            first = false;
+        }
+    }
     
-    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
-        /* Extract channel samples */
-        int16_t channel_samples[VOICE_FRAME_SIZE];
-        for (int i = 0; i < VOICE_FRAME_SIZE; i++) {
-            channel_samples[i] = frame->samples[i * VOICE_CHANNELS + ch];
+    /* Frames of the same period join it; later ones wait for the next */
+    int best = -1;
+    int source = -1;
+    uint32_t present = 0;
+    wake_gate_t gate = WAKE_GATE_OFF;
+    bool busy = false;
+    bool reset = false;
+    
+    for (uint32_t i = 0; i < pool->num_members; i++) {
+        const voice_wake_job_t* job = jobs[i];
+        if (!job || (int32_t)(job->timestamp_ms - period_ms) >= FRAME_DURATION_MS / 2) {
+            jobs[i] = NULL;
+            continue;
         }
         
-        float energy = calculate_energy_db(channel_samples, VOICE_FRAME_SIZE);
-        ((voice_frame_t*)frame)->energy_db[ch] = energy; // Cast away const for update
-        
-        if (energy > ctx->noise_floor + 6.0f) { // 6dB above noise floor
-            active_channels++;
+        voice_context_t* member = pool->members[i];
+        present++;
+        reset |= job->reset;
+        busy |= !wake_job_live(member, job);
+        if (job->gate > gate) {
+            gate = job->gate;
+        }
+        if (best < 0 || job->score > jobs[best]->score) {
+            best = (int)i;
+        }
+        if (member == pool->source) {
+            source = (int)i;
         }
-        
-        total_energy += energy;
     }
     
-    float avg_energy = total_energy / VOICE_CHANNELS;
-    ctx->stats.avg_energy_db = avg_energy;
-    
-    /* Update noise floor during silence */
-    if (!ctx->vad_active) {
-        update_noise_floor(ctx, avg_energy);
+    pool->stats.slots++;
+    if (present < pool->num_members) {
+        pool->stats.partial_slots++;
     }
     
-    /* VAD decision based on energy and active channels */
-    bool energy_vad = avg_energy > ctx->noise_floor + 10.0f;
-    bool channel_vad = active_channels >= (VOICE_CHANNELS / 2);
-    
-    if (energy_vad && channel_vad) {
-        ctx->vad_frame_count++;
-    } else {
-        ctx->vad_frame_count = 0;
+    /* Any member's voice_reset() clears the shared stage */
+    voice_context_t* lead = pool->members[0];
+    if (reset) {
+        reset_wake_engine(lead);
+        pool->source = NULL;
     }
     
-    /* Require multiple consecutive frames */
-    ctx->vad_active = ctx->vad_frame_count >= VAD_FRAME_THRESHOLD;
+    if (!busy) {
+        uint32_t mark = voice_profile_now();
+        bool onset = (lead->engine_gate == WAKE_GATE_OFF && gate != WAKE_GATE_OFF);
+        bool running = (gate != WAKE_GATE_OFF && !onset);
+        
+        /* A running stage stays on its array until another beam clearly
+         * leads with speech on it; noise alone never moves it */
+        if (running && source >= 0 && best != source &&
+            (!jobs[best]->active ||
+             jobs[best]->score - jobs[source]->score < VOICE_DB(VOICE_POOL_SWITCH_DB))) {
+            best = source;
+        }
+        
+        /* Moving mid-activity replays the new array's history, as at an onset */
+        voice_context_t* chosen = pool->members[best];
+        bool moved = running && pool->source && chosen != pool->source;
+        if (moved) {
+            pool->stats.source_switches++;
+        }
+        pool->source = chosen;
+        pool->stats.source = best;
+        
+        voice_frame_view_t frame = wake_job_frame(jobs[best]);
+        run_wake_stage(lead, chosen, &frame, gate, onset || moved, jobs[best]->ring_position);
+        if (chosen->wake_post_sent) {
+            chosen->wake_post_sent = false;
+            chosen->wake_stale_epoch = jobs[best]->epoch;
+        }
+        if (gate != WAKE_GATE_OFF) {
+            pool->stats.wake_passes++;
+            pool->stats.wins[best]++;
+        }
+        stage_done(lead, VOICE_STAGE_WAKE, mark);
+    } else if (gate != lead->engine_gate) {
+        /* An array is past a detection; only the tier counts */
+        wake_engine_set_gate(lead->wake_word_engine, gate);
+        lead->engine_gate = gate;
+    }
     
-    return ctx->vad_active;
+    for (uint32_t i = 0; i < pool->num_members; i++) {
+        if (jobs[i]) {
+            voice_fifo_pop(&pool->members[i]->wake_fifo);
+        }
+    }
 }
 
-/* Apply beamforming to frame */
-static void apply_beamforming(voice_context_t* ctx, voice_frame_t* frame) {
-    /* Simple delay-and-sum beamforming */
-    float steering_rad = ctx->current_steering_angle * M_PI / 180.0f;
-    float speed_of_sound = 343.0f; // m/s
+/* Pool wake task: cross-array beam selection, features and inference */
+static void voice_pool_wake_task(void* param) {
+    voice_pool_t* pool = (voice_pool_t*)param;
     
-    /* Calculate delays based on microphone positions */
-    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
-        float dx = ctx->config.beamform.mic_positions[ch][0];
-        float dy = ctx->config.beamform.mic_positions[ch][1];
-        
-        /* Time delay in samples */
-        float delay = (dx * cosf(steering_rad) + dy * sinf(steering_rad)) * 
-                     VOICE_SAMPLE_RATE / speed_of_sound;
-        ctx->beamform_delays[ch] = delay;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
         
-        /* Update weights based on coherence (simplified) */
-        ctx->beamform_weights[ch] = 1.0f / VOICE_CHANNELS;
+        while (pool_period_ready(pool)) {
+            run_pool_period(pool);
+        }
+    }
+}
+
+/* Start the trace of a new utterance. An asynchronous backend completes
+ * after later frames were queued, so its capture time leans late. */
+static void begin_trace(voice_context_t* ctx, uint32_t audio_ms, uint32_t queued_ms) {
+    voice_trace_t* trace = &ctx->trace;
+    trace_write_begin(ctx);
+    trace->trace_id = ++ctx->trace_sequence;
+    trace->audio_ms = audio_ms;
+    trace->queued_ms = queued_ms;
+    trace->wake_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    trace->recording_start_ms = trace->wake_ms;
+    trace->recording_stop_ms = trace->wake_ms;
+    trace->recording = false;
+    trace_write_end(ctx);
+}
+
+/* Wake word detected (runs on the processing, wake stage or pool wake task) */
+static void wake_detection_handler(const wake_detection_t* detection, void* user_data) {
+    voice_context_t* ctx = (voice_context_t*)user_data;
+    voice_wake_post_t post = {
+        .timestamp_ms = detection->timestamp_ms,
+        .queued_ms = ctx->wake_queued_ms,
+        .model_index = detection->model_index
+    };
+    
+    /* A pool runs the lead's engine; the detection is the listened array's */
+    if (ctx->pipeline.pool) {
+        ctx = ctx->pipeline.pool->source;
+    }
+    
+    if (!ctx->wake_task) {
+        apply_wake_detection(ctx, &post);
+        return;
     }
     
-    /* Note: Actual implementation would apply fractional delays */
-    /* This is a placeholder for the concept */
+    /* The state is the processing task's: hand the detection over. One
+     * already waiting was the first of this drain, and wins. */
+    ctx->wake_post_sent = true;
+    if (atomic_load_explicit(&ctx->wake_posted, memory_order_acquire)) {
+        return;
+    }
+    ctx->wake_post = post;
+    atomic_store_explicit(&ctx->wake_posted, true, memory_order_release);
 }
 
-/* Process wake word detection */
-static void process_wake_word_detection(voice_context_t* ctx, const voice_frame_t* frame) {
-    /* Placeholder for actual wake word detection */
-    /* In real implementation, this would:
-     * 1. Extract MFCC features from the frame
-     * 2. Feed features to wake word model
-     * 3. Check confidence against threshold
-     */
-    
-    /* Simulate wake word detection (replace with real implementation) */
-    static int simulation_counter = 0;
-    simulation_counter++;
-    
-    /* For demo: trigger wake word every 500 frames if VAD active */
-    if (frame->vad_active && (simulation_counter % 500) == 0) {
-        /* Wake word detected */
-        ctx->state = VOICE_STATE_WAKE_DETECTED;
-        ctx->last_wake_time = frame->timestamp_ms;
-        ctx->stats.wake_detections++;
-        
-        /* Start timeout timer */
-        xTimerReset(ctx->timeout_timer, 0);
-        
-        /* Call wake word callback if registered */
-        for (int i = 0; i < ctx->config.num_wake_words; i++) {
-            if (ctx->config.wake_words[i].callback) {
-                ctx->config.wake_words[i].callback();
-                break;
-            }
+/* Act on a detection (processing task) */
+static void apply_wake_detection(voice_context_t* ctx, const voice_wake_post_t* post) {
+    /* A second detection in the same drain must not restart recording */
+    if (ctx->state != VOICE_STATE_IDLE && ctx->state != VOICE_STATE_LISTENING) {
+        return;
+    }
+    
+    ctx->state = VOICE_STATE_WAKE_DETECTED;
+    ctx->last_wake_time = post->timestamp_ms;
+    ctx->stats.wake_detections++;
+    ctx->wake_model = post->model_index;
+    atomic_store(&ctx->wake_unjudged, true);
+    begin_trace(ctx, post->timestamp_ms, post->queued_ms);
+    
+    /* Start timeout timer */
+    xTimerReset(ctx->timeout_timer, 0);
+    
+    /* Models are loaded in registration order; fall back to the first
+     * registered callback */
+    if (post->model_index < ctx->config.num_wake_words &&
+        ctx->config.wake_words[post->model_index].callback) {
+        ctx->config.wake_words[post->model_index].callback();
+        return;
+    }
+    
+    for (int i = 0; i < ctx->config.num_wake_words; i++) {
+        if (ctx->config.wake_words[i].callback) {
+            ctx->config.wake_words[i].callback();
+            break;
         }
     }
 }
 
 /* Update noise floor estimate */
-static void update_noise_floor(voice_context_t* ctx, float current_energy) {
+static void update_noise_floor(voice_context_t* ctx, voice_db_t current_energy) {
     /* Simple exponential moving average */
+#if VOICE_FIXED_POINT
+    /* alpha = 0.95 as a Q15 step of (1 - alpha) toward the new level */
+    ctx->noise_floor += ((current_energy - ctx->noise_floor) * NOISE_FLOOR_STEP_Q15) >> 15;
+#else
     float alpha = 0.95f; // Slow adaptation
     ctx->noise_floor = alpha * ctx->noise_floor + (1.0f - alpha) * current_energy;
-    ctx->stats.noise_floor_db = ctx->noise_floor;
+#endif
+}
+
+/* Ask the capture driver for the latency mode activity calls for */
+static void update_latency_mode(voice_context_t* ctx, const voice_frame_view_t* frame) {
+    /* Anything that may be a command, a stop word above all, gets short
+     * periods at once; long ones wait out the hangover */
+    bool active = frame->vad_active || ctx->vad_frame_count > 0 ||
+                  ctx->state == VOICE_STATE_WAKE_DETECTED ||
+                  ctx->state == VOICE_STATE_RECORDING;
+    if (active) {
+        ctx->latency_hold_until_ms = frame->timestamp_ms + ctx->pipeline.wake_hangover_ms;
+    }
+    
+    audio_latency_mode_t mode = AUDIO_LATENCY_LOW;
+    if (!active && (int32_t)(frame->timestamp_ms - ctx->latency_hold_until_ms) >= 0) {
+        mode = AUDIO_LATENCY_LOW_POWER;
+    }
+    
+    if (mode != ctx->latency_mode && ctx->driver &&
+        audio_driver_set_latency_mode(ctx->driver, mode) == AUDIO_OK) {
+        ctx->latency_mode = mode;
+        ctx->latency_switches++;
+    }
 }
 
 /* Timeout callback */
@@ -465,7 +2392,17 @@ static void voice_timeout_callback(TimerHandle_t timer) {
 
 /* Get current state */
 voice_state_t voice_get_state(const voice_context_t* ctx) {
-    return ctx ? ctx->state : VOICE_STATE_ERROR;
+    if (!ctx) {
+        return VOICE_STATE_ERROR;
+    }
+    
+    /* A posted detection the processing task has yet to act on counts */
+    voice_state_t state = ctx->state;
+    if ((state == VOICE_STATE_IDLE || state == VOICE_STATE_LISTENING) &&
+        atomic_load_explicit(&ctx->wake_posted, memory_order_acquire)) {
+        return VOICE_STATE_WAKE_DETECTED;
+    }
+    return state;
 }
 
 /* Start recording */
@@ -479,6 +2416,13 @@ voice_error_t voice_start_recording(voice_context_t* ctx, uint32_t max_duration_
         return VOICE_ERR_INVALID_PARAM;
     }
     
+    /* A recording started by hand is an utterance of its own */
+    if (ctx->state == VOICE_STATE_IDLE) {
+        uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        begin_trace(ctx, 0, now_ms);
+        atomic_store(&ctx->wake_unjudged, false);
+    }
+    
     ctx->recording_size = 0;
     ctx->is_recording = true;
     ctx->max_recording_duration = max_duration_ms;
@@ -494,6 +2438,12 @@ voice_error_t voice_stop_recording(voice_context_t* ctx) {
         return VOICE_ERR_INVALID_PARAM;
     }
     
+    if (ctx->is_recording) {
+        trace_write_begin(ctx);
+        ctx->trace.recording_stop_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        ctx->trace.recording = false;
+        trace_write_end(ctx);
+    }
     ctx->is_recording = false;
     ctx->state = VOICE_STATE_PROCESSING;
     
@@ -507,8 +2457,21 @@ voice_error_t voice_get_recording(voice_context_t* ctx, uint8_t* buffer,
         return VOICE_ERR_INVALID_PARAM;
     }
     
+    /* Streamed recordings were delivered as they were captured */
+    if (ctx->chunks) {
+        *bytes_written = 0;
+        if (ctx->state == VOICE_STATE_PROCESSING) {
+            ctx->state = VOICE_STATE_IDLE;
+        }
+        return VOICE_OK;
+    }
+    
     if (ctx->recording_size == 0) {
+        /* An empty utterance still ends processing */
         *bytes_written = 0;
+        if (ctx->state == VOICE_STATE_PROCESSING) {
+            ctx->state = VOICE_STATE_IDLE;
+        }
         return VOICE_OK;
     }
     
@@ -525,13 +2488,59 @@ voice_error_t voice_get_recording(voice_context_t* ctx, uint8_t* buffer,
     return VOICE_OK;
 }
 
+/* Get the oldest recording chunk */
+voice_error_t voice_recording_acquire(voice_context_t* ctx,
+                                      const voice_recording_chunk_t** chunk,
+                                      uint32_t timeout_ms) {
+    if (!ctx || !chunk || !ctx->chunks) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    
+    /* The semaphore only wakes us; the FIFO says whether a chunk is there */
+    while ((*chunk = (const voice_recording_chunk_t*)voice_fifo_front(&ctx->chunk_fifo)) == NULL) {
+        TickType_t waited = xTaskGetTickCount() - start;
+        if (waited >= timeout ||
+            xSemaphoreTake(ctx->chunk_ready, timeout - waited) != pdTRUE) {
+            break;
+        }
+    }
+    
+    return VOICE_OK;
+}
+
+/* Give back a recording chunk */
+voice_error_t voice_recording_release(voice_context_t* ctx) {
+    if (!ctx || !ctx->chunks) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    const voice_recording_chunk_t* chunk =
+        (const voice_recording_chunk_t*)voice_fifo_front(&ctx->chunk_fifo);
+    if (!chunk) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    bool final = chunk->final;
+    voice_fifo_pop(&ctx->chunk_fifo);
+    if (final && ctx->state == VOICE_STATE_PROCESSING) {
+        ctx->state = VOICE_STATE_IDLE;
+    }
+    
+    return VOICE_OK;
+}
+
 /* Set beam direction */
 voice_error_t voice_set_beam_direction(voice_context_t* ctx, float angle_degrees) {
     if (!ctx || angle_degrees < 0.0f || angle_degrees > 360.0f) {
         return VOICE_ERR_INVALID_PARAM;
     }
     
-    ctx->current_steering_angle = angle_degrees;
+    /* Steered by the processing task between frames */
+    ctx->steer_request = angle_degrees;
+    atomic_fetch_or(&ctx->beam_request, BEAM_REQUEST_STEER);
     return VOICE_OK;
 }
 
@@ -541,7 +2550,9 @@ voice_error_t voice_set_adaptive_beam(voice_context_t* ctx, bool enable) {
         return VOICE_ERR_INVALID_PARAM;
     }
     
-    ctx->config.beamform.adaptive_mode = enable;
+    /* Switched by the processing task between frames */
+    ctx->adaptive_request = enable;
+    atomic_fetch_or(&ctx->beam_request, BEAM_REQUEST_ADAPTIVE);
     return VOICE_OK;
 }
 
@@ -566,6 +2577,7 @@ voice_error_t voice_set_sensitivity(voice_context_t* ctx, float sensitivity) {
     }
     
     ctx->wake_sensitivity = sensitivity;
+    wake_engine_set_sensitivity(voice_get_wake_engine(ctx), sensitivity);
     return VOICE_OK;
 }
 
@@ -576,13 +2588,99 @@ voice_error_t voice_get_stats(const voice_context_t* ctx, voice_stats_t* stats)
     }
     
     memcpy(stats, &ctx->stats, sizeof(voice_stats_t));
+    stats->avg_energy_db = VOICE_DB_TO_FLOAT(ctx->avg_energy);
+    stats->noise_floor_db = VOICE_DB_TO_FLOAT(ctx->noise_floor);
+    
+    /* Frames the wake stage could not take count as overruns */
+    stats->buffer_overruns += ctx->wake_drops;
+    
+    /* So does a detection not yet acted on */
+    if (atomic_load_explicit(&ctx->wake_posted, memory_order_acquire)) {
+        stats->wake_detections++;
+    }
+    
+    /* Share of the real-time frame budget spent processing */
+    voice_stage_stats_t frame;
+    voice_profile_summarize(&ctx->profile[VOICE_STAGE_FRAME], &frame);
+    stats->cpu_usage_percent = 100.0f * frame.avg_us / VOICE_FRAME_BUDGET_US;
+    
+    return VOICE_OK;
+}
+
+/* Get extended statistics */
+voice_error_t voice_get_stats_ext(const voice_context_t* ctx, voice_stats_ext_t* stats) {
+    if (!ctx || !stats) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    voice_get_stats(ctx, &stats->base);
+    for (int i = 0; i < VOICE_STAGE_COUNT; i++) {
+        voice_profile_summarize(&ctx->profile[i], &stats->stages[i]);
+    }
+    
+    stats->frame_budget_us = VOICE_FRAME_BUDGET_US;
+    stats->frame_queue_length = FRAME_QUEUE_LENGTH;
+    stats->frame_queue_depth = (uint32_t)uxQueueMessagesWaiting(ctx->frame_queue);
+    stats->frame_queue_high_water = ctx->queue_high_water;
     
-    /* Calculate CPU usage (placeholder) */
-    stats->cpu_usage_percent = 15.0f; // Would calculate actual usage
+    if (ctx->wake_task) {
+        stats->wake_queue_length = VOICE_WAKE_QUEUE_LENGTH;
+        stats->wake_queue_depth = voice_fifo_count(&ctx->wake_fifo);
+    } else {
+        stats->wake_queue_length = 0;
+        stats->wake_queue_depth = 0;
+    }
+    stats->wake_queue_high_water = ctx->wake_high_water;
+    stats->wake_queue_drops = ctx->wake_drops;
+    memcpy(stats->wake_gate_frames, ctx->wake_gate_frames, sizeof(stats->wake_gate_frames));
+    stats->wake_backfills = ctx->wake_backfills;
+    stats->noise_calibrations = ctx->noise_calibrations;
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        stats->channel_floor_db[ch] = VOICE_DB_TO_FLOAT(ctx->noise_floor + ctx->channel_offset[ch]);
+    }
+    stats->latency_mode = ctx->latency_mode;
+    stats->latency_switches = ctx->latency_switches;
+    stats->beam_angle_deg = ctx->current_steering_angle;
+    stats->beam_steers = ctx->beam_steers;
+#if VOICE_FIXED_POINT
+    stats->doa_confidence = ctx->doa->confidence / 32768.0f;
+#else
+    stats->doa_confidence = ctx->doa->confidence;
+#endif
+    
+    stats->subscribers = 0;
+    stats->subscriber_overruns = 0;
+    for (int i = 0; i < VOICE_MAX_SUBSCRIBERS; i++) {
+        const voice_subscriber_t* sub = &ctx->subscribers[i];
+        if (atomic_load_explicit(&sub->active, memory_order_acquire)) {
+            stats->subscribers++;
+            stats->subscriber_overruns += sub->overruns;
+        }
+    }
     
     return VOICE_OK;
 }
 
+/* Get the latest utterance's trace */
+voice_error_t voice_get_trace(const voice_context_t* ctx, voice_trace_t* trace) {
+    if (!ctx || !trace) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    /* A copy that overlapped a writer is retried */
+    for (;;) {
+        uint32_t seq = atomic_load_explicit(&ctx->trace_seqlock, memory_order_acquire);
+        if (seq & 1) {
+            continue;
+        }
+        *trace = ctx->trace;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&ctx->trace_seqlock, memory_order_relaxed) == seq) {
+            return VOICE_OK;
+        }
+    }
+}
+
 /* Reset voice system */
 voice_error_t voice_reset(voice_context_t* ctx) {
     if (!ctx) {
@@ -590,14 +2688,29 @@ voice_error_t voice_reset(voice_context_t* ctx) {
     }
     
     ctx->state = VOICE_STATE_IDLE;
+    atomic_store(&ctx->wake_posted, false);
     ctx->recording_size = 0;
     ctx->is_recording = false;
     ctx->vad_frame_count = 0;
     ctx->vad_active = false;
     
+    /* The wake engine is reset on the task that runs it */
+    atomic_store(&ctx->reset_request, true);
+    
     /* Clear statistics */
     memset(&ctx->stats, 0, sizeof(voice_stats_t));
-    ctx->stats.noise_floor_db = ctx->noise_floor;
+    for (int i = 0; i < VOICE_STAGE_COUNT; i++) {
+        voice_profile_reset(&ctx->profile[i]);
+    }
+    ctx->queue_high_water = 0;
+    ctx->wake_high_water = 0;
+    ctx->wake_drops = 0;
+    memset(ctx->wake_gate_frames, 0, sizeof(ctx->wake_gate_frames));
+    ctx->wake_backfills = 0;
+    ctx->noise_calibrations = 0;
+    ctx->latency_switches = 0;
+    ctx->beam_steers = 0;
+    ctx->avg_energy = 0;
     
     return VOICE_OK;
 }
@@ -608,7 +2721,8 @@ voice_error_t voice_set_noise_suppression(voice_context_t* ctx, float level) {
         return VOICE_ERR_INVALID_PARAM;
     }
     
-    /* Placeholder - would configure noise suppression algorithm */
+    /* Picked up by the processing task between utterances */
+    ctx->noise_suppression = level;
     return VOICE_OK;
 }
 
@@ -618,9 +2732,8 @@ voice_error_t voice_calibrate_noise(voice_context_t* ctx, uint32_t duration_ms)
         return VOICE_ERR_INVALID_PARAM;
     }
     
-    /* Placeholder - would collect samples and calculate noise floor */
-    /* For now, just reset to default */
-    ctx->noise_floor = VAD_ENERGY_THRESHOLD;
+    /* Collected and applied by the processing task */
+    ctx->calibration_request = duration_ms / FRAME_DURATION_MS;
     
     return VOICE_OK;
 }
@@ -637,4 +2750,287 @@ voice_error_t voice_register_audio_callback(voice_context_t* ctx,
     ctx->audio_callback_data = user_data;
     
     return VOICE_OK;
-}
\ No newline at end of file
+}
+
+/* Attach a reader to the circular buffer */
+voice_error_t voice_open_buffer_reader(voice_context_t* ctx,
+                                      voice_ring_reader_t* reader) {
+    if (!ctx || !reader) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    voice_ring_reader_init(reader, &ctx->ring);
+    return VOICE_OK;
+}
+
+/* Ring behind a stream, NULL if the context keeps none */
+static const voice_ring_t* stream_ring(const voice_context_t* ctx, voice_stream_t stream) {
+    switch (stream) {
+        case VOICE_STREAM_RAW:
+            return &ctx->ring;
+        case VOICE_STREAM_MONO:
+            return ctx->mono_buffer ? &ctx->mono_ring : NULL;
+        case VOICE_STREAM_FEATURES:
+            /* A pool's wake stage publishes through its lead */
+            if (ctx->pipeline.pool && ctx->pipeline.pool->members[0] != ctx) {
+                return NULL;
+            }
+            return ctx->feature_buffer ? &ctx->feature_ring : NULL;
+        default:
+            return NULL;
+    }
+}
+
+/* Subscribe to a stream */
+voice_subscriber_t* voice_subscribe(voice_context_t* ctx, voice_stream_t stream) {
+    if (!ctx) {
+        return NULL;
+    }
+    const voice_ring_t* ring = stream_ring(ctx, stream);
+    if (!ring) {
+        return NULL;
+    }
+    
+    for (int i = 0; i < VOICE_MAX_SUBSCRIBERS; i++) {
+        voice_subscriber_t* sub = &ctx->subscribers[i];
+        if (atomic_exchange_explicit(&sub->claimed, true, memory_order_acquire)) {
+            continue;
+        }
+        
+        /* Producers may still give a reused semaphore; it is never deleted */
+        if (!sub->ready) {
+#if VOICE_STATIC_ALLOC
+            if (ctx->from_arena) {
+                sub->ready = xSemaphoreCreateBinaryStatic(&sub->ready_buffer);
+            } else
+#endif
+            {
+                sub->ready = xSemaphoreCreateBinary();
+            }
+            if (!sub->ready) {
+                atomic_store_explicit(&sub->claimed, false, memory_order_release);
+                return NULL;
+            }
+        }
+        xSemaphoreTake(sub->ready, 0);
+        
+        sub->stream = stream;
+        sub->overruns = 0;
+        voice_ring_reader_init(&sub->reader, ring);
+        atomic_store_explicit(&sub->active, true, memory_order_release);
+        return sub;
+    }
+    return NULL;
+}
+
+/* Get unread data of a subscription */
+size_t voice_subscriber_peek(voice_subscriber_t* sub, voice_span_t spans[2],
+                             size_t max_positions, uint32_t timeout_ms) {
+    if (!sub || !spans) {
+        return 0;
+    }
+    
+    /* Clear a stale signal first, so waiting below sees only new writes */
+    xSemaphoreTake(sub->ready, 0);
+    uint32_t dropped = sub->reader.dropped;
+    size_t count = voice_ring_peek(&sub->reader, spans, max_positions);
+    if (count == 0 && timeout_ms > 0 &&
+        xSemaphoreTake(sub->ready, pdMS_TO_TICKS(timeout_ms)) == pdPASS) {
+        count = voice_ring_peek(&sub->reader, spans, max_positions);
+    }
+    if (sub->reader.dropped != dropped) {
+        sub->overruns++;
+    }
+    return count;
+}
+
+/* Consume data of a subscription */
+bool voice_subscriber_release(voice_subscriber_t* sub, size_t positions) {
+    if (!sub) {
+        return false;
+    }
+    
+    if (!voice_ring_release(&sub->reader, positions)) {
+        sub->overruns++;
+        return false;
+    }
+    return true;
+}
+
+/* Get subscription statistics */
+voice_error_t voice_subscriber_get_stats(const voice_subscriber_t* sub,
+                                         voice_subscriber_stats_t* stats) {
+    if (!sub || !stats) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    stats->stream = sub->stream;
+    stats->channels = sub->reader.ring->channels;
+    stats->position = sub->reader.cursor;
+    stats->dropped = sub->reader.dropped;
+    stats->overruns = sub->overruns;
+    return VOICE_OK;
+}
+
+/* End a subscription */
+void voice_unsubscribe(voice_subscriber_t* sub) {
+    if (!sub) {
+        return;
+    }
+    
+    atomic_store_explicit(&sub->active, false, memory_order_release);
+    atomic_store_explicit(&sub->claimed, false, memory_order_release);
+}
+
+/* Get wake word engine */
+wake_engine_t* voice_get_wake_engine(voice_context_t* ctx) {
+    if (ctx && ctx->pipeline.pool) {
+        return ctx->pipeline.pool->members[0]->wake_word_engine;
+    }
+    return ctx ? ctx->wake_word_engine : NULL;
+}
+
+/* Report a false wake detection */
+voice_error_t voice_report_false_wake(voice_context_t* ctx) {
+    if (!ctx) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    if (atomic_exchange(&ctx->wake_unjudged, false)) {
+        wake_engine_report_false_accept(voice_get_wake_engine(ctx), ctx->wake_model);
+    }
+    return VOICE_OK;
+}
+
+/* Default pool layout */
+voice_pool_config_t voice_pool_get_default_config(void) {
+    voice_pool_config_t config = {
+        .num_workers = 2,
+        .worker_core = VOICE_CORE_ANY,
+        .wake_core = VOICE_CORE_ANY
+    };
+    return config;
+}
+
+/* Build a pool; everything comes from the arena when one is given */
+static voice_pool_t* pool_create(const voice_pool_config_t* config, voice_arena_t* arena) {
+    voice_pool_config_t layout = config ? *config : voice_pool_get_default_config();
+    if (layout.num_workers == 0 || layout.num_workers > VOICE_POOL_MAX_WORKERS) {
+        return NULL;
+    }
+    
+    voice_pool_t* pool = (voice_pool_t*)context_alloc(arena, sizeof(voice_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+    
+    memset(pool, 0, sizeof(voice_pool_t));
+    pool->config = layout;
+    pool->stats.source = -1;
+    pool->from_arena = (arena != NULL);
+    
+    /* Every member is queued at most once */
+#if VOICE_STATIC_ALLOC
+    if (arena) {
+        uint8_t* run_storage = (uint8_t*)voice_arena_alloc(arena,
+            VOICE_POOL_MAX_MEMBERS * sizeof(voice_context_t*));
+        if (!run_storage) {
+            goto error_cleanup;
+        }
+        pool->run_queue = xQueueCreateStatic(VOICE_POOL_MAX_MEMBERS, sizeof(voice_context_t*),
+                                             run_storage, &pool->run_queue_buffer);
+    } else
+#endif
+    {
+        pool->run_queue = xQueueCreate(VOICE_POOL_MAX_MEMBERS, sizeof(voice_context_t*));
+    }
+    if (!pool->run_queue) {
+        goto error_cleanup;
+    }
+    
+    if (!create_stage_task(voice_pool_wake_task, "VoicePoolWake", pool,
+                           WAKE_TASK_PRIORITY, layout.wake_core, arena,
+                           TASK_BUFFER(pool, wake_task_buffer), &pool->wake_task)) {
+        goto error_cleanup;
+    }
+    for (uint32_t i = 0; i < layout.num_workers; i++) {
+        if (!create_stage_task(voice_pool_worker, "VoicePool", pool,
+                               VOICE_TASK_PRIORITY, layout.worker_core, arena,
+                               TASK_BUFFER(pool, worker_buffers[i]), &pool->workers[i])) {
+            goto error_cleanup;
+        }
+    }
+    
+    return pool;
+
+error_cleanup:
+    voice_pool_deinit(pool);
+    return NULL;
+}
+
+/* Create a shared worker pool */
+voice_pool_t* voice_pool_create(const voice_pool_config_t* config) {
+    return pool_create(config, NULL);
+}
+
+#if VOICE_STATIC_ALLOC
+/* Arena bytes for voice_pool_init_static() */
+size_t voice_pool_required_size(const voice_pool_config_t* config) {
+    voice_pool_config_t layout = config ? *config : voice_pool_get_default_config();
+    if (layout.num_workers == 0 || layout.num_workers > VOICE_POOL_MAX_WORKERS) {
+        return 0;
+    }
+    
+    return (VOICE_ARENA_ALIGN - 1) +
+           VOICE_ARENA_SIZE(sizeof(voice_pool_t)) +
+           VOICE_ARENA_SIZE(VOICE_POOL_MAX_MEMBERS * sizeof(voice_context_t*)) +
+           (layout.num_workers + 1) * VOICE_ARENA_SIZE(VOICE_TASK_STACK * sizeof(StackType_t));
+}
+
+/* Create a shared worker pool in a caller-provided arena */
+voice_pool_t* voice_pool_init_static(const voice_pool_config_t* config,
+                                     void* arena_memory,
+                                     size_t arena_size) {
+    size_t required = voice_pool_required_size(config);
+    if (!arena_memory || required == 0 || arena_size < required) {
+        return NULL;
+    }
+    
+    voice_arena_t arena;
+    voice_arena_init(&arena, arena_memory, arena_size);
+    return pool_create(config, &arena);
+}
+#endif
+
+/* Stop a shared worker pool */
+void voice_pool_deinit(voice_pool_t* pool) {
+    if (!pool) return;
+    
+    for (uint32_t i = 0; i < VOICE_POOL_MAX_WORKERS; i++) {
+        if (pool->workers[i]) {
+            vTaskDelete(pool->workers[i]);
+        }
+    }
+    if (pool->wake_task) {
+        vTaskDelete(pool->wake_task);
+    }
+    if (pool->run_queue) {
+        vQueueDelete(pool->run_queue);
+    }
+    
+    /* Arena memory is reclaimed by the caller */
+    if (!pool->from_arena) {
+        vPortFree(pool);
+    }
+}
+
+/* Get pool statistics */
+voice_error_t voice_pool_get_stats(const voice_pool_t* pool, voice_pool_stats_t* stats) {
+    if (!pool || !stats) {
+        return VOICE_ERR_INVALID_PARAM;
+    }
+    
+    memcpy(stats, &pool->stats, sizeof(voice_pool_stats_t));
+    stats->members = pool->num_members;
+    return VOICE_OK;
+}
@@ -0,0 +1,387 @@
+/**
+ * @file voice_denoise.c
+ * @brief W.I.T. Spectral Noise Suppressor Implementation
+ */
+
+#include "voice_denoise.h"
+#include <string.h>
+#include <math.h>
+
+/* Internal Constants */
+#define HALF                    (DENOISE_FFT_SIZE / 2)
+#define DB_PER_LOG2             3.01029996f     // 10 * log10(2)
+#define DB_PER_LOG2_Q16         197283          // 10 * log10(2) in Q16
+#define FULL_SCALE_LOG2         30              // log2(32768^2)
+#define POWER_FLOOR             1e-12f          // VOICE_DSP_FLOOR_DB as power
+#define GAIN_STEP_DB            0.5f            // SNR between gain table entries
+#define SMOOTH_SHIFT            1               // Level smoothing, 1/2 per frame
+#define NOISE_SHIFT             4               // Noise tracking, 1/16 per frame
+#define STARTUP_SHIFT           1               // Noise tracking right after a reset
+#define FALL_SHIFT              2               // Noise tracking when the noise drops
+#define OVERSUBTRACT_DB         6.0f            // Noise margin before a bin counts as signal
+#define STARTUP_FRAMES          16
+#define BAND_BIAS_DB            0.36f           // Band minimum bias per doubling
+#define LEARNT_OFFSET_DB        -2.05f          // Learnt noise below the mean level
+#define FFT_INPUT_BITS          20              // Analysis block-float headroom (bits)
+#define INVERSE_INPUT_BITS      26              // Synthesis block-float headroom (bits)
+#define OVERLAP_FRAC_BITS       8
+
+/* Move a level 1/2^shift of the way toward target */
+static inline voice_db_t db_toward(voice_db_t level, voice_db_t target, int shift) {
+#if VOICE_FIXED_POINT
+    return level + ((target - level) >> shift);
+#else
+    return level + (target - level) * (1.0f / (float)(1 << shift));
+#endif
+}
+
+/* Update one bin's level and noise; returns its gain */
+static voice_coef_t bin_gain(voice_denoise_t* ns, voice_denoise_stream_t* stream,
+                             uint32_t k, voice_db_t level, bool learn_noise) {
+    voice_db_t smoothed = db_toward(stream->smoothed[k], level, SMOOTH_SHIFT);
+    stream->smoothed[k] = smoothed;
+
+    if (learn_noise) {
+        int shift = (ns->noise_frames < STARTUP_FRAMES) ? STARTUP_SHIFT : NOISE_SHIFT;
+        if (smoothed < ns->noise[k] && shift > FALL_SHIFT) {
+            shift = FALL_SHIFT;
+        }
+        ns->noise[k] = db_toward(ns->noise[k], smoothed, shift);
+    }
+
+    /* Wiener gain from the a-posteriori SNR past the margin, floored
+     * by the level */
+    voice_db_t snr = smoothed - ns->noise[k] - VOICE_DB(OVERSUBTRACT_DB);
+#if VOICE_FIXED_POINT
+    int32_t step = snr / (VOICE_DSP_DB_ONE / 2);
+#else
+    int32_t step = (int32_t)(snr * (1.0f / GAIN_STEP_DB));
+#endif
+    voice_coef_t gain;
+    if (step < 0) {
+        gain = VOICE_COEF(0.0f);
+    } else if (step >= DENOISE_GAIN_STEPS) {
+        gain = VOICE_COEF(1.0f);
+    } else {
+        gain = ns->gain_table[step];
+    }
+
+    return (gain > ns->gain_floor) ? gain : ns->gain_floor;
+}
+
+/* Initialize suppressor */
+void voice_denoise_init(voice_denoise_t* ns, float* work) {
+    memset(ns, 0, sizeof(voice_denoise_t));
+    ns->work = (voice_fft_t*)work;
+
+    /* Square-root periodic Hann: analysis times synthesis overlap-adds to one */
+    for (uint32_t n = 0; n < DENOISE_WINDOW; n++) {
+        ns->window[n] = VOICE_COEF(sinf(M_PI * n / DENOISE_WINDOW));
+    }
+    voice_dsp_fft_twiddle(ns->twiddle, DENOISE_FFT_SIZE);
+
+    /* Gain at the centre of each SNR step: 1 - 1 / snr */
+    for (uint32_t i = 0; i < DENOISE_GAIN_STEPS; i++) {
+        float snr_db = (i + 0.5f) * GAIN_STEP_DB;
+        ns->gain_table[i] = VOICE_COEF(1.0f - powf(10.0f, -snr_db / 10.0f));
+    }
+
+    voice_denoise_set_level(ns, 0.0f);
+    voice_denoise_reset(ns);
+}
+
+/* Set suppression level */
+void voice_denoise_set_level(voice_denoise_t* ns, float level) {
+    level = fminf(fmaxf(level, 0.0f), 1.0f);
+    ns->gain_floor = VOICE_COEF(powf(10.0f, -level * DENOISE_MAX_ATTENUATION_DB / 20.0f));
+}
+
+/* Forget learnt noise */
+void voice_denoise_reset(voice_denoise_t* ns) {
+    for (uint32_t k = 0; k < DENOISE_BINS; k++) {
+        ns->noise[k] = VOICE_DB(VOICE_DSP_FLOOR_DB);
+    }
+    ns->noise_frames = 0;
+}
+
+/* Start a stream from silence */
+void voice_denoise_stream_reset(const voice_denoise_t* ns,
+                                voice_denoise_stream_t* stream) {
+    memset(stream->analysis, 0, sizeof(stream->analysis));
+    memset(stream->overlap, 0, sizeof(stream->overlap));
+    memcpy(stream->smoothed, ns->noise, sizeof(stream->smoothed));
+}
+
+#if VOICE_FIXED_POINT
+/* Level of a bin whose power carries scale_log2 extra bits */
+static voice_db_t bin_level(int64_t re, int64_t im, int32_t scale_log2) {
+    const voice_db_t floor_db = VOICE_DB(VOICE_DSP_FLOOR_DB);
+    uint64_t power = (uint64_t)(re * re + im * im);
+    if (power == 0) {
+        return floor_db;
+    }
+
+    int32_t log2_power = voice_dsp_log2_q16(power) - (scale_log2 << 16);
+    voice_db_t db = (voice_db_t)(((int64_t)log2_power * DB_PER_LOG2_Q16) >> 24);
+    return (db < floor_db) ? floor_db : db;
+}
+
+/* Clean one frame.
+ *
+ * Block floating point twice over: the windowed frame is scaled up to
+ * FFT_INPUT_BITS before the forward transform, and the filtered spectrum
+ * to INVERSE_INPUT_BITS before the inverse one, so neither 1/HALF
+ * scaling costs resolution on quiet frames. */
+void voice_denoise_process(voice_denoise_t* ns,
+                           voice_denoise_stream_t* stream,
+                           const int16_t* input,
+                           bool learn_noise,
+                           int16_t* output) {
+    int32_t* buf = ns->work;
+
+    memmove(stream->analysis, &stream->analysis[VOICE_FRAME_SIZE],
+            VOICE_FRAME_SIZE * sizeof(int16_t));
+    memcpy(&stream->analysis[VOICE_FRAME_SIZE], input, VOICE_FRAME_SIZE * sizeof(int16_t));
+
+    uint32_t peak = 0;
+    for (uint32_t n = 0; n < DENOISE_WINDOW; n++) {
+        int32_t x = stream->analysis[n];
+        peak |= (uint32_t)(x < 0 ? -x : x);
+    }
+    int32_t frac_bits = 0;
+    while (peak != 0 && (peak << (frac_bits + 1)) < (1u << FFT_INPUT_BITS)) {
+        frac_bits++;
+    }
+
+    /* Window in Q15, to frac_bits; zero-pad */
+    for (uint32_t n = 0; n < DENOISE_WINDOW; n++) {
+        int32_t y = stream->analysis[n] * ns->window[n];
+        buf[n] = (frac_bits <= 15) ? (y >> (15 - frac_bits)) : y * (1 << (frac_bits - 15));
+    }
+    memset(&buf[DENOISE_WINDOW], 0, (DENOISE_FFT_SIZE - DENOISE_WINDOW) * sizeof(int32_t));
+
+    int32_t stages = 0;
+    for (uint32_t len = HALF; len > 1; len >>= 1) {
+        stages++;
+    }
+
+    voice_dsp_fft(buf, HALF, ns->twiddle);
+
+    /* Spectrum carries frac_bits - stages bits over the int16 transform,
+     * and levels are relative to full scale */
+    int32_t scale_log2 = 2 * (frac_bits - stages) + FULL_SCALE_LOG2;
+
+    /* DC and Nyquist share the first pair */
+    int64_t dc = (int64_t)buf[0] + buf[1];
+    int64_t nyquist = (int64_t)buf[0] - buf[1];
+    dc = (dc * bin_gain(ns, stream, 0, bin_level(dc, 0, scale_log2), learn_noise)) >> 15;
+    nyquist = (nyquist * bin_gain(ns, stream, HALF, bin_level(nyquist, 0, scale_log2),
+                                  learn_noise)) >> 15;
+    buf[0] = (int32_t)((dc + nyquist) >> 1);
+    buf[1] = (int32_t)(-(dc - nyquist) >> 1);
+
+    /* Bins k and HALF - k come from, and go back to, the same pair */
+    for (uint32_t k = 1; k <= HALF / 2; k++) {
+        uint32_t m = HALF - k;
+        int32_t ar = buf[2 * k], ai = buf[2 * k + 1];
+        int32_t br = buf[2 * m], bi = buf[2 * m + 1];
+        int64_t ck = ns->twiddle[2 * k], sk = ns->twiddle[2 * k + 1];
+        int64_t cm = ns->twiddle[2 * m], sm = ns->twiddle[2 * m + 1];
+
+        /* Split the packed spectrum: X = E - j W O */
+        int32_t er = (ar + br) >> 1, ei = (ai - bi) >> 1;
+        int64_t or_ = (ar - br) >> 1, oi = (ai + bi) >> 1;
+        int64_t xkr = er + ((ck * oi - sk * or_) >> 15);
+        int64_t xki = ei - ((ck * or_ + sk * oi) >> 15);
+        int64_t xmr = er + ((cm * oi + sm * or_) >> 15);
+        int64_t xmi = -ei - ((sm * oi - cm * or_) >> 15);
+
+        voice_coef_t gk = bin_gain(ns, stream, k, bin_level(xkr, xki, scale_log2), learn_noise);
+        voice_coef_t gm = (m == k) ? gk :
+                          bin_gain(ns, stream, m, bin_level(xmr, xmi, scale_log2), learn_noise);
+        xkr = (xkr * gk) >> 15;
+        xki = (xki * gk) >> 15;
+        xmr = (xmr * gm) >> 15;
+        xmi = (xmi * gm) >> 15;
+
+        /* Merge back: Z = E + j O, O = (X[k] - X*[m]) / 2 * W^-k;
+         * stored conjugated for an inverse through the forward FFT */
+        int64_t sr = (xkr + xmr) >> 1, si = (xki - xmi) >> 1;
+        int64_t dr = (xkr - xmr) >> 1, di = (xki + xmi) >> 1;
+        int64_t okr = (dr * ck - di * sk) >> 15, oki = (dr * sk + di * ck) >> 15;
+        int64_t omr = (-dr * cm - di * sm) >> 15, omi = (-dr * sm + di * cm) >> 15;
+        buf[2 * k] = (int32_t)(sr - oki);
+        buf[2 * k + 1] = (int32_t)-(si + okr);
+        buf[2 * m] = (int32_t)(sr - omi);
+        buf[2 * m + 1] = (int32_t)-(-si + omr);
+    }
+
+    if (learn_noise) {
+        ns->noise_frames++;
+    }
+
+    /* Rescale for the inverse transform */
+    uint32_t spectrum_peak = 0;
+    for (uint32_t i = 0; i < DENOISE_FFT_SIZE; i++) {
+        int32_t v = buf[i];
+        spectrum_peak |= (uint32_t)(v < 0 ? -v : v);
+    }
+    int32_t shift = 0;
+    while (spectrum_peak != 0 && (spectrum_peak << (shift + 1)) < (1u << INVERSE_INPUT_BITS)) {
+        shift++;
+    }
+    for (uint32_t i = 0; i < DENOISE_FFT_SIZE; i++) {
+        buf[i] = (int32_t)((uint32_t)buf[i] << shift);
+    }
+
+    voice_dsp_fft(buf, HALF, ns->twiddle);
+
+    /* Synthesis window, overlap-add in Q8 samples; odd samples are the
+     * conjugated imaginary parts */
+    int32_t out_shift = frac_bits - stages + shift - OVERLAP_FRAC_BITS;
+    int32_t tail[VOICE_FRAME_SIZE];
+    for (uint32_t n = 0; n < DENOISE_WINDOW; n++) {
+        int64_t x = (n & 1) ? -(int64_t)buf[n] : buf[n];
+        int64_t y = (x * ns->window[n]) >> 15;
+        int32_t q8 = (int32_t)((out_shift >= 0) ? (y >> out_shift) : y * ((int64_t)1 << -out_shift));
+
+        if (n < VOICE_FRAME_SIZE) {
+            int32_t sum = stream->overlap[n] + q8 + (1 << (OVERLAP_FRAC_BITS - 1));
+            output[n] = voice_dsp_sat16(sum >> OVERLAP_FRAC_BITS);
+        } else {
+            tail[n - VOICE_FRAME_SIZE] = q8;
+        }
+    }
+    memcpy(stream->overlap, tail, sizeof(tail));
+}
+#else
+/* Level of a bin */
+static voice_db_t bin_level(float re, float im) {
+    return DB_PER_LOG2 * voice_dsp_fast_log2(fmaxf(re * re + im * im, POWER_FLOOR));
+}
+
+/* Clean one frame */
+void voice_denoise_process(voice_denoise_t* ns,
+                           voice_denoise_stream_t* stream,
+                           const int16_t* input,
+                           bool learn_noise,
+                           int16_t* output) {
+    float* buf = ns->work;
+
+    memmove(stream->analysis, &stream->analysis[VOICE_FRAME_SIZE],
+            VOICE_FRAME_SIZE * sizeof(int16_t));
+    memcpy(&stream->analysis[VOICE_FRAME_SIZE], input, VOICE_FRAME_SIZE * sizeof(int16_t));
+
+    /* Window, zero-pad */
+    for (uint32_t n = 0; n < DENOISE_WINDOW; n++) {
+        buf[n] = stream->analysis[n] * (1.0f / 32768.0f) * ns->window[n];
+    }
+    memset(&buf[DENOISE_WINDOW], 0, (DENOISE_FFT_SIZE - DENOISE_WINDOW) * sizeof(float));
+
+    voice_dsp_fft(buf, HALF, ns->twiddle);
+
+    /* DC and Nyquist share the first pair */
+    float dc = buf[0] + buf[1];
+    float nyquist = buf[0] - buf[1];
+    dc *= bin_gain(ns, stream, 0, bin_level(dc, 0.0f), learn_noise);
+    nyquist *= bin_gain(ns, stream, HALF, bin_level(nyquist, 0.0f), learn_noise);
+    buf[0] = 0.5f * (dc + nyquist);
+    buf[1] = -0.5f * (dc - nyquist);
+
+    /* Bins k and HALF - k come from, and go back to, the same pair */
+    for (uint32_t k = 1; k <= HALF / 2; k++) {
+        uint32_t m = HALF - k;
+        float ar = buf[2 * k], ai = buf[2 * k + 1];
+        float br = buf[2 * m], bi = buf[2 * m + 1];
+        float ck = ns->twiddle[2 * k], sk = ns->twiddle[2 * k + 1];
+        float cm = ns->twiddle[2 * m], sm = ns->twiddle[2 * m + 1];
+
+        /* Split the packed spectrum: X = E - j W O */
+        float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+        float or_ = 0.5f * (ar - br), oi = 0.5f * (ai + bi);
+        float xkr = er + (ck * oi - sk * or_);
+        float xki = ei - (ck * or_ + sk * oi);
+        float xmr = er + (cm * oi + sm * or_);
+        float xmi = -ei - (sm * oi - cm * or_);
+
+        float gk = bin_gain(ns, stream, k, bin_level(xkr, xki), learn_noise);
+        float gm = (m == k) ? gk : bin_gain(ns, stream, m, bin_level(xmr, xmi), learn_noise);
+        xkr *= gk;
+        xki *= gk;
+        xmr *= gm;
+        xmi *= gm;
+
+        /* Merge back: Z = E + j O, O = (X[k] - X*[m]) / 2 * W^-k;
+         * stored conjugated for an inverse through the forward FFT */
+        float sr = 0.5f * (xkr + xmr), si = 0.5f * (xki - xmi);
+        float dr = 0.5f * (xkr - xmr), di = 0.5f * (xki + xmi);
+        float okr = dr * ck - di * sk, oki = dr * sk + di * ck;
+        float omr = -dr * cm - di * sm, omi = -dr * sm + di * cm;
+        buf[2 * k] = sr - oki;
+        buf[2 * k + 1] = -(si + okr);
+        buf[2 * m] = sr - omi;
+        buf[2 * m + 1] = -(-si + omr);
+    }
+
+    if (learn_noise) {
+        ns->noise_frames++;
+    }
+
+    voice_dsp_fft(buf, HALF, ns->twiddle);
+
+    /* Synthesis window, overlap-add; odd samples are the conjugated
+     * imaginary parts */
+    const float scale = 32768.0f / HALF;
+    for (uint32_t n = 0; n < VOICE_FRAME_SIZE; n++) {
+        float x = (n & 1) ? -buf[n] : buf[n];
+        float y = stream->overlap[n] + x * scale * ns->window[n];
+        output[n] = voice_dsp_sat16((int32_t)lrintf(y));
+    }
+    for (uint32_t n = VOICE_FRAME_SIZE; n < DENOISE_WINDOW; n++) {
+        float x = (n & 1) ? -buf[n] : buf[n];
+        stream->overlap[n - VOICE_FRAME_SIZE] = x * scale * ns->window[n];
+    }
+}
+#endif
+
+/* Start a calibration */
+void voice_denoise_calibrate_begin(voice_denoise_t* ns) {
+    for (uint32_t b = 0; b < DENOISE_BANDS; b++) {
+        voice_noise_min_reset(&ns->bands[b], VOICE_DB(BAND_BIAS_DB));
+    }
+}
+
+/* Add the latest band levels */
+void voice_denoise_calibrate_update(voice_denoise_t* ns,
+                                    const voice_denoise_stream_t* stream) {
+    for (uint32_t b = 0; b < DENOISE_BANDS; b++) {
+        uint32_t first = b * DENOISE_BAND_BINS;
+        uint32_t count = DENOISE_BINS - first;
+        if (count > DENOISE_BAND_BINS) {
+            count = DENOISE_BAND_BINS;
+        }
+
+        voice_db_t sum = 0;
+        for (uint32_t k = first; k < first + count; k++) {
+            sum += stream->smoothed[k];
+        }
+        voice_noise_min_update(&ns->bands[b], sum / (voice_db_t)count);
+    }
+}
+
+/* Seed the noise from the calibration */
+void voice_denoise_calibrate_end(voice_denoise_t* ns) {
+    if (ns->bands[0].frames == 0) {
+        return;
+    }
+
+    /* The learnt noise falls faster than it rises, so it sits below
+     * the mean level the estimate compensates to */
+    for (uint32_t k = 0; k < DENOISE_BINS; k++) {
+        ns->noise[k] = voice_noise_min_estimate(&ns->bands[k / DENOISE_BAND_BINS]) +
+                       VOICE_DB(LEARNT_OFFSET_DB);
+    }
+    if (ns->noise_frames < STARTUP_FRAMES) {
+        ns->noise_frames = STARTUP_FRAMES;
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ * @file voice_denoise.h
+ * @brief W.I.T. Spectral Noise Suppressor
+ *
+ * Frame-rate Wiener suppressor for the beamformed mono signal. Each
+ * frame is analysed together with the one before it under a square-root
+ * Hann window, zero-padded to DENOISE_FFT_SIZE and transformed with the
+ * real FFT shared with the MFCC front-end. A per-bin noise level, learnt
+ * while the VAD reports no speech, sets a Wiener gain per bin. The
+ * gain is floored by the suppression level so speech is never gated
+ * out. The cleaned spectrum is transformed back and overlap-added, so
+ * output runs one frame behind input.
+ *
+ * Levels are kept in voice_db_t units. Fixed-point builds use the
+ * block-floating-point integer FFT, and integer logarithms for levels.
+ *
+ * Analysis state lives in a voice_denoise_stream_t apart from the learnt
+ * noise. History read back from the circular buffer can then be cleaned
+ * with the live noise estimate without disturbing the live stream.
+ *
+ * Calibration seeds the noise from a stretch of the live stream, speech
+ * or not. Every frame's bin levels are averaged over bands of
+ * DENOISE_BAND_BINS. Each band's minimum statistics (voice_noise.h)
+ * then give the noise for all of its bins.
+ */
+
+#ifndef WIT_VOICE_DENOISE_H
+#define WIT_VOICE_DENOISE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "voice_core.h"
+#include "voice_dsp.h"
+#include "voice_noise.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Configuration */
+#define DENOISE_WINDOW              (2 * VOICE_FRAME_SIZE)  // Two frames, 50% overlap
+/* Transform length: the next power of two holding the window, at least
+ * 512 (the MFCC front-end's) */
+#define DENOISE_FFT_SIZE            (DENOISE_WINDOW <= 512 ? 512 : \
+                                     DENOISE_WINDOW <= 1024 ? 1024 : 2048)
+#define DENOISE_BINS                (DENOISE_FFT_SIZE / 2 + 1)
+#define DENOISE_MAX_ATTENUATION_DB  24.0f   // Gain floor at level 1.0
+#define DENOISE_GAIN_STEPS          64      // Gain table entries, 0.5 dB of SNR apart
+#define DENOISE_BAND_BINS           8       // Bins per calibration band
+#define DENOISE_BANDS               ((DENOISE_BINS + DENOISE_BAND_BINS - 1) / DENOISE_BAND_BINS)
+
+#if DENOISE_WINDOW > DENOISE_FFT_SIZE
+#error "DENOISE_WINDOW must fit in DENOISE_FFT_SIZE (VOICE_FRAME_SIZE at most 1024)"
+#endif
+
+/* Analysis state of one contiguous stream */
+typedef struct {
+    int16_t analysis[DENOISE_WINDOW];       // Previous and current frame
+#if VOICE_FIXED_POINT
+    int32_t overlap[VOICE_FRAME_SIZE];      // Synthesis tail, Q8 samples
+#else
+    float overlap[VOICE_FRAME_SIZE];        // Synthesis tail, samples
+#endif
+    voice_db_t smoothed[DENOISE_BINS];      // Smoothed level per bin
+} voice_denoise_stream_t;
+
+/* Suppressor state */
+typedef struct {
+    voice_coef_t window[DENOISE_WINDOW];    // Square-root Hann
+    voice_coef_t twiddle[DENOISE_FFT_SIZE];
+    voice_coef_t gain_table[DENOISE_GAIN_STEPS];
+    voice_coef_t gain_floor;                // Smallest gain at this level
+    voice_db_t noise[DENOISE_BINS];         // Learnt noise level per bin
+    uint32_t noise_frames;                  // Frames learnt since reset
+    voice_noise_min_t bands[DENOISE_BANDS]; // Calibration minima
+    voice_fft_t* work;                      // DENOISE_FFT_SIZE values, caller-owned
+} voice_denoise_t;
+
+/**
+ * @brief Build window, twiddle and gain tables
+ * @param ns Suppressor state
+ * @param work FFT work buffer of DENOISE_FFT_SIZE floats
+ *
+ * The work buffer is scratch only. The voice core lends its MFCC
+ * buffer when the front-end runs on the same task. The suppressor
+ * starts at level 0 (disabled) with no noise learnt.
+ */
+void voice_denoise_init(voice_denoise_t* ns, float* work);
+
+/**
+ * @brief Set the suppression level
+ * @param ns Suppressor state
+ * @param level 0.0 (no attenuation) to 1.0 (up to DENOISE_MAX_ATTENUATION_DB)
+ */
+void voice_denoise_set_level(voice_denoise_t* ns, float level);
+
+/**
+ * @brief Forget the learnt noise
+ * @param ns Suppressor state
+ */
+void voice_denoise_reset(voice_denoise_t* ns);
+
+/**
+ * @brief Start a stream from silence
+ * @param ns Suppressor state
+ * @param stream Stream state
+ */
+void voice_denoise_stream_reset(const voice_denoise_t* ns,
+                                voice_denoise_stream_t* stream);
+
+/**
+ * @brief Clean one frame
+ * @param ns Suppressor state
+ * @param stream Stream the frame continues
+ * @param input Mono input, VOICE_FRAME_SIZE samples
+ * @param learn_noise Update the noise estimate from this frame
+ * @param output Cleaned previous frame, VOICE_FRAME_SIZE samples
+ *
+ * Pass learn_noise only for live frames without speech. The noise
+ * estimate follows them: quickly for the first frames after a reset,
+ * then over about 16 frames, or about 4 when the noise falls.
+ */
+void voice_denoise_process(voice_denoise_t* ns,
+                           voice_denoise_stream_t* stream,
+                           const int16_t* input,
+                           bool learn_noise,
+                           int16_t* output);
+
+/**
+ * @brief Start a calibration
+ * @param ns Suppressor state
+ */
+void voice_denoise_calibrate_begin(voice_denoise_t* ns);
+
+/**
+ * @brief Add a stream's latest frame to the calibration
+ * @param ns Suppressor state
+ * @param stream Stream just passed to voice_denoise_process()
+ */
+void voice_denoise_calibrate_update(voice_denoise_t* ns,
+                                    const voice_denoise_stream_t* stream);
+
+/**
+ * @brief Replace the learnt noise with the calibration's
+ * @param ns Suppressor state
+ *
+ * Without any frames calibrated the learnt noise is kept. Learning
+ * carries on from the calibrated noise at its steady rate.
+ */
+void voice_denoise_calibrate_end(voice_denoise_t* ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_DENOISE_H */
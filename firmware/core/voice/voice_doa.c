@@ -0,0 +1,322 @@
+/**
+ * @file voice_doa.c
+ * @brief W.I.T. GCC-PHAT Direction-of-Arrival Tracker Implementation
+ */
+
+#include "voice_doa.h"
+#include <string.h>
+#include <math.h>
+
+/* Internal Constants */
+#define HALF                    (DOA_FFT_SIZE / 2)
+#define FFT_INPUT_BITS          20      // Block-float headroom of the transform (bits)
+
+/* Steps between two steering indices, either way round */
+static int circular_distance(int a, int b) {
+    int d = (a > b) ? a - b : b - a;
+    return (d > BEAMFORM_ANGLE_STEPS / 2) ? BEAMFORM_ANGLE_STEPS - d : d;
+}
+
+/* Total delay of a steering entry in 1/BEAMFORM_FRAC_PHASES samples */
+static int steer_lag(const beamform_steer_t* st) {
+    return st->delay * BEAMFORM_FRAC_PHASES + st->phase;
+}
+
+/* Build pair delay tables */
+void voice_doa_init(voice_doa_t* doa, const voice_beamformer_t* bf) {
+    memset(doa, 0, sizeof(voice_doa_t));
+    voice_dsp_fft_twiddle(doa->twiddle, DOA_FFT_SIZE);
+
+    int p = 0;
+    for (int a = 0; a < VOICE_CHANNELS; a++) {
+        for (int b = a + 1; b < VOICE_CHANNELS; b++, p++) {
+            voice_doa_pair_t* pair = &doa->pairs[p];
+            pair->a = (uint8_t)a;
+            pair->b = (uint8_t)b;
+
+            /* Directions sharing a delay share its correlation */
+            for (int d = 0; d < BEAMFORM_ANGLE_STEPS; d++) {
+                int lag = steer_lag(&bf->steering[d][b]) - steer_lag(&bf->steering[d][a]);
+                int i = 0;
+                while (i < pair->num_lags && pair->lag[i] != lag) {
+                    i++;
+                }
+                if (i == pair->num_lags) {
+                    float phase = 2.0f * (float)M_PI * lag /
+                                  (BEAMFORM_FRAC_PHASES * DOA_FFT_SIZE);
+                    pair->lag[i] = (int16_t)lag;
+                    pair->step[i][0] = VOICE_COEF(cosf(phase));
+                    pair->step[i][1] = VOICE_COEF(sinf(phase));
+                    pair->num_lags++;
+                }
+                doa->lag_index[d][p] = (uint8_t)i;
+            }
+        }
+    }
+
+    voice_doa_reset(doa, bf->active_index);
+}
+
+/* Restart from a known direction */
+void voice_doa_reset(voice_doa_t* doa, int steer_index) {
+    memset(doa->cross, 0, sizeof(doa->cross));
+    doa->frames = 0;
+    doa->estimate = steer_index;
+    doa->confidence = 0;
+    doa->steer = steer_index;
+    doa->candidate = steer_index;
+    doa->candidate_frames = 0;
+}
+
+#if VOICE_FIXED_POINT
+/* Integer square root */
+static uint32_t isqrt64(uint64_t x) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/* Unit phasors of one microphone over the band */
+static void channel_phasors(voice_doa_t* doa, const int16_t* samples, int ch) {
+    int32_t* buf = doa->work;
+
+    uint32_t peak = 0;
+    for (int n = 0; n < VOICE_FRAME_SIZE; n++) {
+        int32_t x = samples[n * VOICE_CHANNELS + ch];
+        peak |= (uint32_t)(x < 0 ? -x : x);
+    }
+    int32_t frac_bits = 0;
+    while (peak != 0 && (peak << (frac_bits + 1)) < (1u << FFT_INPUT_BITS)) {
+        frac_bits++;
+    }
+
+    for (int n = 0; n < VOICE_FRAME_SIZE; n++) {
+        buf[n] = samples[n * VOICE_CHANNELS + ch] * (1 << frac_bits);
+    }
+    memset(&buf[VOICE_FRAME_SIZE], 0, (DOA_FFT_SIZE - VOICE_FRAME_SIZE) * sizeof(int32_t));
+
+    voice_dsp_fft(buf, HALF, doa->twiddle);
+
+    for (int i = 0; i < DOA_BINS; i++) {
+        int k = DOA_BIN_FIRST + i;
+        int m = HALF - k;
+        int32_t ar = buf[2 * k], ai = buf[2 * k + 1];
+        int32_t br = buf[2 * m], bi = buf[2 * m + 1];
+        int64_t ck = doa->twiddle[2 * k], sk = doa->twiddle[2 * k + 1];
+
+        /* Split the packed spectrum: X = E - j W O */
+        int32_t er = (ar + br) >> 1, ei = (ai - bi) >> 1;
+        int64_t or_ = (ar - br) >> 1, oi = (ai + bi) >> 1;
+        int64_t xr = er + ((ck * oi - sk * or_) >> 15);
+        int64_t xi = ei - ((ck * or_ + sk * oi) >> 15);
+
+        /* PHAT: keep the phase only */
+        uint32_t mag = isqrt64((uint64_t)(xr * xr + xi * xi));
+        if (mag == 0) {
+            doa->unit[ch][i][0] = 0;
+            doa->unit[ch][i][1] = 0;
+        } else {
+            doa->unit[ch][i][0] = voice_dsp_sat16((int32_t)((xr * 32767) / mag));
+            doa->unit[ch][i][1] = voice_dsp_sat16((int32_t)((xi * 32767) / mag));
+        }
+    }
+}
+
+/* Average one pair's cross-spectrum */
+static void accumulate_pair(voice_doa_t* doa, int p) {
+    const voice_doa_pair_t* pair = &doa->pairs[p];
+    for (int i = 0; i < DOA_BINS; i++) {
+        int32_t ar = doa->unit[pair->a][i][0], ai = doa->unit[pair->a][i][1];
+        int32_t br = doa->unit[pair->b][i][0], bi = doa->unit[pair->b][i][1];
+        int32_t gr = (ar * br + ai * bi) >> 15;
+        int32_t gi = (ai * br - ar * bi) >> 15;
+
+        voice_doa_acc_t* c = doa->cross[p][i];
+        if (doa->frames == 0) {
+            c[0] = gr;
+            c[1] = gi;
+        } else {
+            c[0] += (gr - c[0]) >> DOA_SMOOTH_SHIFT;
+            c[1] += (gi - c[1]) >> DOA_SMOOTH_SHIFT;
+        }
+    }
+}
+
+/* Cross-correlation of a pair at one of its lags (Q15 per bin) */
+static int32_t pair_correlation(const voice_doa_t* doa, int p, int lag) {
+    const voice_coef_t* step = doa->pairs[p].step[lag];
+    int32_t sr = step[0], si = step[1];
+
+    /* Phase at the first bin, then advance bin by bin */
+    int32_t wr = 32767, wi = 0;
+    for (int k = 0; k < DOA_BIN_FIRST; k++) {
+        int32_t r = (wr * sr - wi * si + (1 << 14)) >> 15;
+        wi = (wr * si + wi * sr + (1 << 14)) >> 15;
+        wr = r;
+    }
+
+    int32_t sum = 0;
+    for (int i = 0; i < DOA_BINS; i++) {
+        const voice_doa_acc_t* c = doa->cross[p][i];
+        sum += (c[0] * wr - c[1] * wi) >> 15;
+        int32_t r = (wr * sr - wi * si + (1 << 14)) >> 15;
+        wi = (wr * si + wi * sr + (1 << 14)) >> 15;
+        wr = r;
+    }
+    return sum;
+}
+
+typedef int32_t doa_power_t;
+#define MIN_POWER               ((doa_power_t)(DOA_MIN_CONFIDENCE * DOA_PAIRS * DOA_BINS * 32768))
+#else
+/* Unit phasors of one microphone over the band */
+static void channel_phasors(voice_doa_t* doa, const int16_t* samples, int ch) {
+    float* buf = doa->work;
+
+    for (int n = 0; n < VOICE_FRAME_SIZE; n++) {
+        buf[n] = samples[n * VOICE_CHANNELS + ch];
+    }
+    memset(&buf[VOICE_FRAME_SIZE], 0, (DOA_FFT_SIZE - VOICE_FRAME_SIZE) * sizeof(float));
+
+    voice_dsp_fft(buf, HALF, doa->twiddle);
+
+    for (int i = 0; i < DOA_BINS; i++) {
+        int k = DOA_BIN_FIRST + i;
+        int m = HALF - k;
+        float ar = buf[2 * k], ai = buf[2 * k + 1];
+        float br = buf[2 * m], bi = buf[2 * m + 1];
+        float ck = doa->twiddle[2 * k], sk = doa->twiddle[2 * k + 1];
+
+        /* Split the packed spectrum: X = E - j W O */
+        float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+        float or_ = 0.5f * (ar - br), oi = 0.5f * (ai + bi);
+        float xr = er + (ck * oi - sk * or_);
+        float xi = ei - (ck * or_ + sk * oi);
+
+        /* PHAT: keep the phase only */
+        float mag = sqrtf(xr * xr + xi * xi);
+        float scale = (mag > 0.0f) ? 1.0f / mag : 0.0f;
+        doa->unit[ch][i][0] = xr * scale;
+        doa->unit[ch][i][1] = xi * scale;
+    }
+}
+
+/* Average one pair's cross-spectrum */
+static void accumulate_pair(voice_doa_t* doa, int p) {
+    const voice_doa_pair_t* pair = &doa->pairs[p];
+    const float alpha = 1.0f / (1 << DOA_SMOOTH_SHIFT);
+    for (int i = 0; i < DOA_BINS; i++) {
+        float ar = doa->unit[pair->a][i][0], ai = doa->unit[pair->a][i][1];
+        float br = doa->unit[pair->b][i][0], bi = doa->unit[pair->b][i][1];
+        float gr = ar * br + ai * bi;
+        float gi = ai * br - ar * bi;
+
+        voice_doa_acc_t* c = doa->cross[p][i];
+        if (doa->frames == 0) {
+            c[0] = gr;
+            c[1] = gi;
+        } else {
+            c[0] += (gr - c[0]) * alpha;
+            c[1] += (gi - c[1]) * alpha;
+        }
+    }
+}
+
+/* Cross-correlation of a pair at one of its lags */
+static float pair_correlation(const voice_doa_t* doa, int p, int lag) {
+    const voice_coef_t* step = doa->pairs[p].step[lag];
+    float sr = step[0], si = step[1];
+
+    /* Phase at the first bin, then advance bin by bin */
+    float wr = 1.0f, wi = 0.0f;
+    for (int k = 0; k < DOA_BIN_FIRST; k++) {
+        float r = wr * sr - wi * si;
+        wi = wr * si + wi * sr;
+        wr = r;
+    }
+
+    float sum = 0.0f;
+    for (int i = 0; i < DOA_BINS; i++) {
+        const voice_doa_acc_t* c = doa->cross[p][i];
+        sum += c[0] * wr - c[1] * wi;
+        float r = wr * sr - wi * si;
+        wi = wr * si + wi * sr;
+        wr = r;
+    }
+    return sum;
+}
+
+typedef float doa_power_t;
+#define MIN_POWER               (DOA_MIN_CONFIDENCE * DOA_PAIRS * DOA_BINS)
+#endif
+
+/* Add a frame and track the direction */
+bool voice_doa_update(voice_doa_t* doa, const int16_t* samples, int* steer_index) {
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        channel_phasors(doa, samples, ch);
+    }
+    for (int p = 0; p < DOA_PAIRS; p++) {
+        accumulate_pair(doa, p);
+    }
+    doa->frames++;
+
+    /* Correlations at every delay in use, then steered power per direction */
+    doa_power_t correlation[DOA_PAIRS][BEAMFORM_ANGLE_STEPS];
+    for (int p = 0; p < DOA_PAIRS; p++) {
+        for (int i = 0; i < doa->pairs[p].num_lags; i++) {
+            correlation[p][i] = pair_correlation(doa, p, i);
+        }
+    }
+
+    int best = 0;
+    doa_power_t best_power = 0;
+    for (int d = 0; d < BEAMFORM_ANGLE_STEPS; d++) {
+        doa_power_t power = 0;
+        for (int p = 0; p < DOA_PAIRS; p++) {
+            power += correlation[p][doa->lag_index[d][p]];
+        }
+        if (d == 0 || power > best_power) {
+            best = d;
+            best_power = power;
+        }
+    }
+    doa->estimate = best;
+    doa->confidence = (voice_coef_t)(best_power / (DOA_PAIRS * DOA_BINS));
+
+    /* Weak or diffuse fields and small moves leave the beam alone */
+    if (best_power < MIN_POWER ||
+        circular_distance(best, doa->steer) < DOA_HYSTERESIS_STEPS) {
+        doa->candidate_frames = 0;
+        return false;
+    }
+
+    /* The run may drift a step while the average settles; it ends on
+     * the newest estimate */
+    if (doa->candidate_frames > 0 && circular_distance(best, doa->candidate) <= 1) {
+        doa->candidate_frames++;
+    } else {
+        doa->candidate_frames = 1;
+    }
+    doa->candidate = best;
+    if (doa->candidate_frames < DOA_HOLD_FRAMES) {
+        return false;
+    }
+
+    doa->steer = doa->candidate;
+    doa->candidate_frames = 0;
+    *steer_index = doa->steer;
+    return true;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file voice_doa.h
+ * @brief W.I.T. GCC-PHAT Direction-of-Arrival Tracker
+ *
+ * Estimates the talker direction for adaptive beam steering. Each
+ * frame fed to the tracker is transformed per microphone and reduced to
+ * unit phasors over the speech band (the PHAT weighting), and the
+ * cross-spectrum of every microphone pair is averaged over frames. The
+ * steered response power of a look direction is the sum over pairs of
+ * their generalized cross-correlation at the pair's delay for that
+ * direction. Delays come from the beamformer's steering table, so
+ * candidate directions are exactly the beams it can form, at its 1/8
+ * sample resolution.
+ *
+ * A new direction must beat the current one by DOA_HYSTERESIS_STEPS
+ * and hold for DOA_HOLD_FRAMES confident frames before the tracker
+ * reports it, so the beam does not wander with reflections or noise.
+ * Fixed-point builds transform in block floating point and keep the
+ * phasors and averages in Q15.
+ */
+
+#ifndef WIT_VOICE_DOA_H
+#define WIT_VOICE_DOA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "voice_core.h"
+#include "voice_dsp.h"
+#include "voice_beamform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Configuration */
+/* Zero-padded frame transform: the next power of two holding a frame,
+ * at least 256 */
+#define DOA_FFT_SIZE            (VOICE_FRAME_SIZE <= 256 ? 256 : \
+                                 VOICE_FRAME_SIZE <= 512 ? 512 : 1024)
+#define DOA_MIN_HZ              300     // Speech band used for the estimate
+#define DOA_MAX_HZ              4000
+#define DOA_SMOOTH_SHIFT        2       // Cross-spectrum averaging, 1/4 per frame
+#define DOA_MIN_CONFIDENCE      0.3f    // Normalized peak power that counts as a source
+#define DOA_HYSTERESIS_STEPS    2       // Smaller moves are ignored (steering steps)
+#define DOA_HOLD_FRAMES         5       // Agreeing frames before the beam moves
+
+#define DOA_BIN_FIRST           ((DOA_MIN_HZ * DOA_FFT_SIZE + VOICE_SAMPLE_RATE / 2) / VOICE_SAMPLE_RATE)
+#define DOA_BIN_LAST            (DOA_MAX_HZ * DOA_FFT_SIZE / VOICE_SAMPLE_RATE)
+#define DOA_BINS                (DOA_BIN_LAST - DOA_BIN_FIRST + 1)
+#define DOA_PAIRS               (VOICE_CHANNELS * (VOICE_CHANNELS - 1) / 2)
+
+#if VOICE_FRAME_SIZE > DOA_FFT_SIZE || DOA_BIN_LAST > DOA_FFT_SIZE / 4
+#error "DOA transform too short for the frame size or band (VOICE_FRAME_SIZE at most 1024)"
+#endif
+
+/* Averaged cross-spectrum value (Q15 in fixed point) */
+#if VOICE_FIXED_POINT
+typedef int32_t voice_doa_acc_t;
+#else
+typedef float voice_doa_acc_t;
+#endif
+
+/* Microphone pair and the delays its look directions need */
+typedef struct {
+    uint8_t a, b;                                   // Microphones, a < b
+    uint8_t num_lags;                               // Distinct delays
+    int16_t lag[BEAMFORM_ANGLE_STEPS];              // Lead of b over a, 1/BEAMFORM_FRAC_PHASES samples
+    voice_coef_t step[BEAMFORM_ANGLE_STEPS][2];     // Phase advance per bin at each lag
+} voice_doa_pair_t;
+
+/* Tracker state */
+typedef struct {
+    voice_doa_pair_t pairs[DOA_PAIRS];
+    uint8_t lag_index[BEAMFORM_ANGLE_STEPS][DOA_PAIRS];
+    voice_coef_t twiddle[DOA_FFT_SIZE];
+    voice_fft_t work[DOA_FFT_SIZE];
+    voice_coef_t unit[VOICE_CHANNELS][DOA_BINS][2];     // Frame phasors per microphone
+    voice_doa_acc_t cross[DOA_PAIRS][DOA_BINS][2];      // Averaged pair cross-spectra
+    uint32_t frames;                                    // Frames averaged since reset
+    int estimate;                                       // Best direction of the last frame
+    voice_coef_t confidence;                            // Its normalized power (at most 1)
+    int steer;                                          // Direction reported to the beam
+    int candidate;                                      // Direction waiting to take over
+    uint32_t candidate_frames;
+} voice_doa_t;
+
+/**
+ * @brief Build pair delay tables from a beamformer's steering table
+ * @param doa Tracker state
+ * @param bf Initialized beamformer
+ *
+ * The tracker starts at the beamformer's current direction.
+ */
+void voice_doa_init(voice_doa_t* doa, const voice_beamformer_t* bf);
+
+/**
+ * @brief Restart tracking from a known direction
+ * @param doa Tracker state
+ * @param steer_index Steering index now in use
+ *
+ * Clears the averaged spectra, so the next estimate uses new frames only.
+ */
+void voice_doa_reset(voice_doa_t* doa, int steer_index);
+
+/**
+ * @brief Add one frame and track the direction
+ * @param doa Tracker state
+ * @param samples Interleaved input, VOICE_FRAME_SIZE x VOICE_CHANNELS
+ * @param steer_index Direction to steer to, when it changes
+ * @return true when the beam should move to *steer_index
+ *
+ * Feed frames that hold speech only; silence would average the noise
+ * field into the estimate.
+ */
+bool voice_doa_update(voice_doa_t* doa, const int16_t* samples, int* steer_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_DOA_H */
@@ -0,0 +1,376 @@
+/**
+ * @file voice_dsp.c
+ * @brief W.I.T. Voice DSP Kernels Implementation
+ */
+
+#include "voice_dsp.h"
+#include <string.h>
+#include <math.h>
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#define VOICE_DSP_HELIUM        1
+#elif defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#define VOICE_DSP_ARM_DSP       1
+#endif
+
+/* Kernel bodies are inlined into every specialized variant so the
+ * channel count and frame size fold into constants */
+#if defined(__GNUC__)
+#define VOICE_DSP_INLINE        static inline __attribute__((always_inline))
+#else
+#define VOICE_DSP_INLINE        static inline
+#endif
+
+/* Internal Constants */
+#define DB_PER_LOG2             3.01029996f     // 10 * log10(2)
+#define FULL_SCALE_LOG2         30.0f           // log2(32768^2)
+#define DB_PER_LOG2_Q16         197283          // 10 * log10(2) in Q16
+#define LOG2_TABLE_BITS         6
+
+/* log2(1 + i / 64) in Q16 */
+static const uint32_t log2_table[(1 << LOG2_TABLE_BITS) + 1] = {
+    0, 1466, 2909, 4331, 5732, 7112, 8473, 9814,
+    11136, 12440, 13727, 14996, 16248, 17484, 18704, 19909,
+    21098, 22272, 23433, 24579, 25711, 26830, 27936, 29029,
+    30109, 31178, 32234, 33279, 34312, 35334, 36346, 37346,
+    38336, 39316, 40286, 41246, 42196, 43137, 44068, 44990,
+    45904, 46809, 47705, 48593, 49472, 50344, 51207, 52063,
+    52911, 53751, 54584, 55410, 56229, 57040, 57845, 58643,
+    59434, 60219, 60997, 61769, 62534, 63294, 64047, 64794,
+    65536
+};
+
+/* Scalar accumulation for samples [start, num_samples) */
+VOICE_DSP_INLINE void sum_squares_scalar(const int16_t* samples, size_t start,
+                               size_t num_samples, uint8_t channels,
+                               uint64_t* sums) {
+    for (size_t i = start; i < num_samples; i++) {
+        const int16_t* frame = &samples[i * channels];
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            int32_t s = frame[ch];
+            sums[ch] += (uint32_t)(s * s);
+        }
+    }
+}
+
+#if defined(VOICE_DSP_HELIUM)
+/* Helium: de-interleaving loads feed one 64-bit MAC chain per channel */
+VOICE_DSP_INLINE size_t sum_squares_helium(const int16_t* samples, size_t num_samples,
+                                 uint8_t channels, uint64_t* sums) {
+    size_t i = 0;
+
+    if (channels == 4) {
+        int64_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+        for (; i + 8 <= num_samples; i += 8) {
+            int16x8x4_t v = vld4q_s16(&samples[i * 4]);
+            acc0 = vmlaldavaq_s16(acc0, v.val[0], v.val[0]);
+            acc1 = vmlaldavaq_s16(acc1, v.val[1], v.val[1]);
+            acc2 = vmlaldavaq_s16(acc2, v.val[2], v.val[2]);
+            acc3 = vmlaldavaq_s16(acc3, v.val[3], v.val[3]);
+        }
+        sums[0] += (uint64_t)acc0;
+        sums[1] += (uint64_t)acc1;
+        sums[2] += (uint64_t)acc2;
+        sums[3] += (uint64_t)acc3;
+    } else if (channels == 2) {
+        int64_t acc0 = 0, acc1 = 0;
+        for (; i + 8 <= num_samples; i += 8) {
+            int16x8x2_t v = vld2q_s16(&samples[i * 2]);
+            acc0 = vmlaldavaq_s16(acc0, v.val[0], v.val[0]);
+            acc1 = vmlaldavaq_s16(acc1, v.val[1], v.val[1]);
+        }
+        sums[0] += (uint64_t)acc0;
+        sums[1] += (uint64_t)acc1;
+    } else if (channels == 1) {
+        int64_t acc0 = 0;
+        for (; i + 8 <= num_samples; i += 8) {
+            int16x8_t v = vld1q_s16(&samples[i]);
+            acc0 = vmlaldavaq_s16(acc0, v, v);
+        }
+        sums[0] += (uint64_t)acc0;
+    }
+
+    return i;
+}
+#endif
+
+#if defined(VOICE_DSP_ARM_DSP)
+/* ARM DSP: one 32-bit load covers a channel pair, dual 16x16 MACs */
+VOICE_DSP_INLINE size_t sum_squares_arm_dsp(const int16_t* samples, size_t num_samples,
+                                  uint8_t channels, uint64_t* sums) {
+    if ((channels & 1) != 0) {
+        return 0;
+    }
+
+    int64_t acc[VOICE_DSP_MAX_CHANNELS] = {0};
+    uint8_t pairs = channels / 2;
+
+    for (size_t i = 0; i < num_samples; i++) {
+        const int16_t* frame = &samples[i * channels];
+        for (uint8_t p = 0; p < pairs; p++) {
+            int32_t w;
+            memcpy(&w, &frame[p * 2], sizeof(w));
+            acc[p * 2] = __smlalbb(acc[p * 2], w, w);
+            acc[p * 2 + 1] = __smlaltt(acc[p * 2 + 1], w, w);
+        }
+    }
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        sums[ch] += (uint64_t)acc[ch];
+    }
+
+    return num_samples;
+}
+#endif
+
+/* Per-channel sum of squares over a frame of known geometry */
+VOICE_DSP_INLINE void sum_squares_frame(const int16_t* samples,
+                                        size_t num_samples,
+                                        uint8_t channels,
+                                        uint64_t* sums) {
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        sums[ch] = 0;
+    }
+
+    size_t done = 0;
+#if defined(VOICE_DSP_HELIUM)
+    done = sum_squares_helium(samples, num_samples, channels, sums);
+#elif defined(VOICE_DSP_ARM_DSP)
+    done = sum_squares_arm_dsp(samples, num_samples, channels, sums);
+#endif
+
+    sum_squares_scalar(samples, done, num_samples, channels, sums);
+}
+
+/* Split an interleaved frame into one contiguous line per channel */
+VOICE_DSP_INLINE void deinterleave_frame(const int16_t* samples,
+                                         size_t num_samples,
+                                         uint8_t channels,
+                                         int16_t* const* lines) {
+    for (size_t i = 0; i < num_samples; i++) {
+        const int16_t* frame = &samples[i * channels];
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            lines[ch][i] = frame[ch];
+        }
+    }
+}
+
+/* Per-channel sum of squares */
+void voice_dsp_sum_squares(const int16_t* samples,
+                           size_t num_samples,
+                           uint8_t channels,
+                           uint64_t* sums) {
+    if (!samples || !sums || channels == 0 || channels > VOICE_DSP_MAX_CHANNELS) {
+        return;
+    }
+
+    sum_squares_frame(samples, num_samples, channels, sums);
+}
+
+/* Generic kernels read the geometry from the table */
+static void sum_squares_generic(const voice_dsp_kernels_t* kernels,
+                                const int16_t* samples, uint64_t* sums) {
+    sum_squares_frame(samples, kernels->frame_size, kernels->channels, sums);
+}
+
+static void deinterleave_generic(const voice_dsp_kernels_t* kernels,
+                                 const int16_t* samples, int16_t* const* lines) {
+    deinterleave_frame(samples, kernels->frame_size, kernels->channels, lines);
+}
+
+/* Specialized kernels, one pair per configuration */
+#define VOICE_DSP_DEFINE_KERNELS(ch, n) \
+    static void sum_squares_##ch##x##n(const voice_dsp_kernels_t* kernels, \
+                                       const int16_t* samples, uint64_t* sums) { \
+        (void)kernels; \
+        sum_squares_frame(samples, n, ch, sums); \
+    } \
+    static void deinterleave_##ch##x##n(const voice_dsp_kernels_t* kernels, \
+                                        const int16_t* samples, int16_t* const* lines) { \
+        (void)kernels; \
+        deinterleave_frame(samples, n, ch, lines); \
+    }
+
+#define VOICE_DSP_KERNEL_ENTRY(ch, n) \
+    { ch, n, true, sum_squares_##ch##x##n, deinterleave_##ch##x##n },
+
+VOICE_DSP_KERNEL_CONFIGS(VOICE_DSP_DEFINE_KERNELS)
+
+static const voice_dsp_kernels_t kernel_table[] = {
+    VOICE_DSP_KERNEL_CONFIGS(VOICE_DSP_KERNEL_ENTRY)
+};
+
+/* Pick the specialized kernels for a geometry */
+bool voice_dsp_select_kernels(voice_dsp_kernels_t* kernels,
+                              uint8_t channels,
+                              uint16_t frame_size) {
+    if (!kernels || channels == 0 || channels > VOICE_DSP_MAX_CHANNELS ||
+        frame_size == 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < sizeof(kernel_table) / sizeof(kernel_table[0]); i++) {
+        if (kernel_table[i].channels == channels &&
+            kernel_table[i].frame_size == frame_size) {
+            *kernels = kernel_table[i];
+            return true;
+        }
+    }
+
+    /* Uncommon geometry: same results through the generic loops */
+    kernels->channels = channels;
+    kernels->frame_size = frame_size;
+    kernels->specialized = false;
+    kernels->sum_squares = sum_squares_generic;
+    kernels->deinterleave = deinterleave_generic;
+    return true;
+}
+
+/* Fast log2: exponent from the float bits, atanh series on the mantissa */
+float voice_dsp_fast_log2(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127;
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+
+    /* Center the mantissa on 1.0 so the series converges quickly */
+    if (m > 1.41421356f) {
+        m *= 0.5f;
+        exponent++;
+    }
+
+    float s = (m - 1.0f) / (m + 1.0f);
+    float s2 = s * s;
+
+    return (float)exponent + s * (2.88539008f + s2 * (0.96179669f + s2 * 0.57707802f));
+}
+
+/* Sum of squares to dBFS */
+float voice_dsp_energy_db(uint64_t sum_squares, size_t num_samples) {
+    if (sum_squares == 0 || num_samples == 0) {
+        return VOICE_DSP_FLOOR_DB;
+    }
+
+    float log2_mean = voice_dsp_fast_log2((float)sum_squares) -
+                      voice_dsp_fast_log2((float)num_samples) -
+                      FULL_SCALE_LOG2;
+    float db = DB_PER_LOG2 * log2_mean;
+
+    return (db < VOICE_DSP_FLOOR_DB) ? VOICE_DSP_FLOOR_DB : db;
+}
+
+/* Index of the highest set bit */
+static int32_t highest_bit(uint64_t x) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(x);
+#else
+    int32_t bit = 0;
+    while (x >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/* Integer log2: exponent from the top bit, mantissa by table lookup */
+int32_t voice_dsp_log2_q16(uint64_t x) {
+    int32_t exponent = highest_bit(x);
+
+    /* Mantissa as Q16 in [1, 2) */
+    uint32_t m = (exponent >= 16) ? (uint32_t)(x >> (exponent - 16))
+                                  : (uint32_t)(x << (16 - exponent));
+    uint32_t frac = m & 0xFFFFu;
+    uint32_t index = frac >> (16 - LOG2_TABLE_BITS);
+    uint32_t rem = frac & ((1u << (16 - LOG2_TABLE_BITS)) - 1);
+
+    /* Linear interpolation between table entries */
+    int32_t lo = log2_table[index];
+    int32_t hi = log2_table[index + 1];
+    int32_t mantissa = lo + (int32_t)(((hi - lo) * rem) >> (16 - LOG2_TABLE_BITS));
+
+    return (exponent << 16) + mantissa;
+}
+
+/* Sum of squares to Q8 dBFS */
+voice_db_q8_t voice_dsp_energy_db_q8(uint64_t sum_squares, size_t num_samples) {
+    const voice_db_q8_t floor_db = VOICE_DB_Q8(VOICE_DSP_FLOOR_DB);
+
+    if (sum_squares == 0 || num_samples == 0) {
+        return floor_db;
+    }
+
+    int32_t log2_mean = voice_dsp_log2_q16(sum_squares) -
+                        voice_dsp_log2_q16(num_samples) -
+                        ((int32_t)FULL_SCALE_LOG2 << 16);
+
+    /* Q16 * Q16 -> Q32, down to Q8 */
+    voice_db_q8_t db = (voice_db_q8_t)(((int64_t)log2_mean * DB_PER_LOG2_Q16) >> 24);
+
+    return (db < floor_db) ? floor_db : db;
+}
+
+/* Real FFT twiddles */
+void voice_dsp_fft_twiddle(voice_coef_t* twiddle, uint32_t fft_size) {
+    for (uint32_t k = 0; k < fft_size / 2; k++) {
+        float angle = 2.0f * M_PI * k / fft_size;
+        twiddle[2 * k] = VOICE_COEF(cosf(angle));
+        twiddle[2 * k + 1] = VOICE_COEF(sinf(angle));
+    }
+}
+
+/* Radix-2 FFT over interleaved re/im pairs */
+void voice_dsp_fft(voice_fft_t* data, uint32_t n, const voice_coef_t* twiddle) {
+    /* Bit reversal */
+    for (uint32_t i = 1, j = 0; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            voice_fft_t re = data[2 * i], im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+
+    /* Butterflies; twiddle table is for length 2n, so step by 2 */
+    for (uint32_t len = 2; len <= n; len <<= 1) {
+        uint32_t half = len >> 1;
+        uint32_t step = 2 * (n / len);
+        for (uint32_t i = 0; i < n; i += len) {
+            for (uint32_t k = 0; k < half; k++) {
+                voice_fft_t* a = &data[2 * (i + k)];
+                voice_fft_t* b = &data[2 * (i + k + half)];
+#if VOICE_FIXED_POINT
+                int64_t wr = twiddle[2 * k * step];
+                int64_t wi = -twiddle[2 * k * step + 1];
+                int32_t vr = (int32_t)((b[0] * wr - b[1] * wi + (1 << 14)) >> 15);
+                int32_t vi = (int32_t)((b[0] * wi + b[1] * wr + (1 << 14)) >> 15);
+                int32_t ar = a[0], ai = a[1];
+                a[0] = (ar + vr + 1) >> 1;
+                a[1] = (ai + vi + 1) >> 1;
+                b[0] = (ar - vr + 1) >> 1;
+                b[1] = (ai - vi + 1) >> 1;
+#else
+                float wr = twiddle[2 * k * step];
+                float wi = -twiddle[2 * k * step + 1];
+                float vr = b[0] * wr - b[1] * wi;
+                float vi = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - vr;
+                b[1] = a[1] - vi;
+                a[0] += vr;
+                a[1] += vi;
+#endif
+            }
+        }
+    }
+}
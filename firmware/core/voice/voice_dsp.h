@@ -0,0 +1,209 @@
+/**
+ * @file voice_dsp.h
+ * @brief W.I.T. Voice DSP Kernels
+ *
+ * Hot-path signal kernels shared by the voice core. Kernels read
+ * interleaved int16 frames in place and use ARM DSP / Helium
+ * intrinsics when the target provides them, with a portable scalar
+ * fallback producing identical results.
+ *
+ * Building with VOICE_FIXED_POINT=1 selects an integer-only frame path
+ * for targets without a hardware FPU: levels become Q8 dB, filter
+ * coefficients Q15, and logarithms come from an integer table.
+ * Floating point is then only used while building tables at init and
+ * when statistics are reported.
+ */
+
+#ifndef WIT_VOICE_DSP_H
+#define WIT_VOICE_DSP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Configuration */
+#ifndef VOICE_FIXED_POINT
+#define VOICE_FIXED_POINT           0       // 1 = integer-only frame path
+#endif
+
+#define VOICE_DSP_MAX_CHANNELS      8       // Matches AUDIO_MAX_CHANNELS
+#define VOICE_DSP_FLOOR_DB          -120.0f // Energy reported for silence
+#define VOICE_DSP_DB_ONE            256     // One dB in Q8 dB units
+
+/* Q8 dB level (1/256 dB steps) */
+typedef int32_t voice_db_q8_t;
+
+#define VOICE_DB_Q8(db)             ((voice_db_q8_t)((db) * VOICE_DSP_DB_ONE + \
+                                     ((db) < 0 ? -0.5f : 0.5f)))
+
+/* Level and coefficient types of the selected frame path */
+#if VOICE_FIXED_POINT
+typedef voice_db_q8_t voice_db_t;
+typedef int16_t voice_coef_t;               // Q15
+#define VOICE_DB(db)                VOICE_DB_Q8(db)
+#define VOICE_DB_TO_FLOAT(level)    ((float)(level) / VOICE_DSP_DB_ONE)
+#define VOICE_COEF(x)               voice_dsp_q15(x)
+#define voice_dsp_level_db          voice_dsp_energy_db_q8
+#else
+typedef float voice_db_t;
+typedef float voice_coef_t;
+#define VOICE_DB(db)                ((voice_db_t)(db))
+#define VOICE_DB_TO_FLOAT(level)    (level)
+#define VOICE_COEF(x)               ((voice_coef_t)(x))
+#define voice_dsp_level_db          voice_dsp_energy_db
+#endif
+
+/* FFT work sample of the selected frame path (block floating point
+ * in fixed point) */
+#if VOICE_FIXED_POINT
+typedef int32_t voice_fft_t;
+#else
+typedef float voice_fft_t;
+#endif
+
+/* Specialized frame geometries: channels x samples per frame
+ * (10/20/30 ms at 16 kHz) */
+#define VOICE_DSP_KERNEL_CONFIGS(X) \
+    X(1, 160) X(1, 320) X(1, 480) \
+    X(2, 160) X(2, 320) X(2, 480) \
+    X(4, 160) X(4, 320) X(4, 480) \
+    X(6, 160) X(6, 320) X(6, 480) \
+    X(8, 160) X(8, 320) X(8, 480)
+
+typedef struct voice_dsp_kernels voice_dsp_kernels_t;
+
+/* Frame kernels for one geometry, selected once at init */
+struct voice_dsp_kernels {
+    uint8_t channels;           // Interleaved channels
+    uint16_t frame_size;        // Samples per channel per frame
+    bool specialized;           // false: generic loops
+
+    /* Per-channel sum of squares of one frame */
+    void (*sum_squares)(const voice_dsp_kernels_t* kernels,
+                        const int16_t* samples, uint64_t* sums);
+
+    /* Split one frame into a contiguous line per channel */
+    void (*deinterleave)(const voice_dsp_kernels_t* kernels,
+                         const int16_t* samples, int16_t* const* lines);
+};
+
+/**
+ * @brief Select frame kernels for a geometry
+ * @param kernels Output kernel table
+ * @param channels Interleaved channels (1-8)
+ * @param frame_size Samples per channel per frame
+ * @return false for an invalid geometry
+ *
+ * Geometries in VOICE_DSP_KERNEL_CONFIGS get variants with the channel
+ * count and frame length as constants, so the per-sample loops are
+ * unrolled and vectorized with no inner-loop branches. Anything else
+ * gets generic loops with identical results.
+ */
+bool voice_dsp_select_kernels(voice_dsp_kernels_t* kernels,
+                              uint8_t channels,
+                              uint16_t frame_size);
+
+/**
+ * @brief Per-channel sum of squares over interleaved samples
+ * @param samples Interleaved int16 samples
+ * @param num_samples Samples per channel
+ * @param channels Number of interleaved channels (1-8)
+ * @param sums Output: one sum of squares per channel
+ *
+ * Single pass over the frame with integer accumulation; no
+ * per-channel copies are made.
+ */
+void voice_dsp_sum_squares(const int16_t* samples,
+                           size_t num_samples,
+                           uint8_t channels,
+                           uint64_t* sums);
+
+/**
+ * @brief Fast base-2 logarithm
+ * @param x Positive input
+ * @return Approximate log2(x), absolute error below 1e-5
+ */
+float voice_dsp_fast_log2(float x);
+
+/**
+ * @brief Convert a sum of squares to RMS level in dBFS
+ * @param sum_squares Sum of squared int16 samples
+ * @param num_samples Number of samples in the sum
+ * @return Level in dB relative to full scale, floored at VOICE_DSP_FLOOR_DB
+ */
+float voice_dsp_energy_db(uint64_t sum_squares, size_t num_samples);
+
+/**
+ * @brief Integer base-2 logarithm
+ * @param x Input, must be non-zero
+ * @return log2(x) in Q16, absolute error below 1e-4 (64-entry table,
+ *         linear interpolation; Q16 rounding alone is 1.5e-5)
+ */
+int32_t voice_dsp_log2_q16(uint64_t x);
+
+/**
+ * @brief Convert a sum of squares to RMS level in Q8 dBFS
+ * @param sum_squares Sum of squared int16 samples
+ * @param num_samples Number of samples in the sum
+ * @return Level in 1/256 dB, floored at VOICE_DSP_FLOOR_DB
+ *
+ * Integer-only counterpart of voice_dsp_energy_db().
+ */
+voice_db_q8_t voice_dsp_energy_db_q8(uint64_t sum_squares, size_t num_samples);
+
+/**
+ * @brief Build the twiddle table for a real FFT
+ * @param twiddle Output cos/sin pairs, fft_size values
+ * @param fft_size Real transform length (power of two)
+ *
+ * Entry k holds cos and sin of 2 pi k / fft_size for k < fft_size / 2.
+ * The half-length complex transform reads every other entry, and the
+ * real split and merge read them all.
+ */
+void voice_dsp_fft_twiddle(voice_coef_t* twiddle, uint32_t fft_size);
+
+/**
+ * @brief In-place radix-2 complex FFT
+ * @param data Interleaved re/im pairs, n of them
+ * @param n Complex transform length (power of two)
+ * @param twiddle Table from voice_dsp_fft_twiddle() for length 2n
+ *
+ * Real signals of length 2n are transformed by packing even and odd
+ * samples as re/im pairs. Fixed point halves every stage, rounding to
+ * nearest so the truncation bias does not pile up in the low bins, and
+ * its output is scaled by 1/n.
+ */
+void voice_dsp_fft(voice_fft_t* data, uint32_t n, const voice_coef_t* twiddle);
+
+/**
+ * @brief Round a coefficient to Q15
+ * @param x Value in [-1, 1]
+ * @return Nearest Q15 value, saturated to the int16 range
+ */
+static inline int16_t voice_dsp_q15(float x) {
+    float q = x * 32768.0f + (x < 0.0f ? -0.5f : 0.5f);
+    if (q >= 32767.0f) return 32767;
+    if (q <= -32768.0f) return -32768;
+    return (int16_t)q;
+}
+
+/**
+ * @brief Saturate a 32-bit value to int16
+ * @param x Value
+ * @return x clamped to [-32768, 32767]
+ */
+static inline int16_t voice_dsp_sat16(int32_t x) {
+    if (x > 32767) return 32767;
+    if (x < -32768) return -32768;
+    return (int16_t)x;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_DSP_H */
@@ -0,0 +1,67 @@
+/**
+ * @file voice_fifo.c
+ * @brief W.I.T. Lock-free Single-Producer Frame FIFO Implementation
+ */
+
+#include "voice_fifo.h"
+
+/* Initialize FIFO */
+bool voice_fifo_init(voice_fifo_t* fifo, void* storage,
+                     size_t slot_size, uint32_t capacity) {
+    if (!fifo || !storage || slot_size == 0 ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    fifo->slots = (uint8_t*)storage;
+    fifo->slot_size = slot_size;
+    fifo->capacity = capacity;
+    fifo->mask = capacity - 1;
+    atomic_init(&fifo->head, 0);
+    atomic_init(&fifo->tail, 0);
+
+    return true;
+}
+
+/* Reserve a free slot */
+void* voice_fifo_reserve(voice_fifo_t* fifo) {
+    uint32_t head = atomic_load_explicit(&fifo->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&fifo->tail, memory_order_acquire);
+
+    if (head - tail >= fifo->capacity) {
+        return NULL;
+    }
+
+    return &fifo->slots[(head & fifo->mask) * fifo->slot_size];
+}
+
+/* Publish the reserved slot */
+void voice_fifo_commit(voice_fifo_t* fifo) {
+    uint32_t head = atomic_load_explicit(&fifo->head, memory_order_relaxed);
+    atomic_store_explicit(&fifo->head, head + 1, memory_order_release);
+}
+
+/* Peek the oldest slot */
+void* voice_fifo_front(voice_fifo_t* fifo) {
+    uint32_t tail = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&fifo->head, memory_order_acquire);
+
+    if (head == tail) {
+        return NULL;
+    }
+
+    return &fifo->slots[(tail & fifo->mask) * fifo->slot_size];
+}
+
+/* Release the oldest slot */
+void voice_fifo_pop(voice_fifo_t* fifo) {
+    uint32_t tail = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+    atomic_store_explicit(&fifo->tail, tail + 1, memory_order_release);
+}
+
+/* Get fill level */
+uint32_t voice_fifo_count(const voice_fifo_t* fifo) {
+    uint32_t tail = atomic_load_explicit(&fifo->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&fifo->head, memory_order_acquire);
+    return head - tail;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file voice_fifo.h
+ * @brief W.I.T. Lock-free Single-Producer Frame FIFO
+ *
+ * Fixed-size slots handed from one producer task to one consumer task,
+ * typically on different cores. Slots are filled and drained in place;
+ * indices are published with release/acquire semantics, so neither side
+ * takes a lock or blocks. A full FIFO refuses the slot and the producer
+ * decides what to drop.
+ */
+
+#ifndef WIT_VOICE_FIFO_H
+#define WIT_VOICE_FIFO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* FIFO state */
+typedef struct {
+    uint8_t* slots;             // Storage: capacity * slot_size bytes
+    size_t slot_size;           // Bytes per slot
+    uint32_t capacity;          // Slots (power of two)
+    uint32_t mask;              // capacity - 1
+    _Atomic uint32_t head;      // Slots published by the producer
+    _Atomic uint32_t tail;      // Slots released by the consumer
+} voice_fifo_t;
+
+/**
+ * @brief Initialize FIFO over caller-provided storage
+ * @param fifo FIFO to initialize
+ * @param storage Storage for capacity * slot_size bytes
+ * @param slot_size Bytes per slot
+ * @param capacity Number of slots, must be a power of two
+ * @return true on success, false on invalid parameters
+ */
+bool voice_fifo_init(voice_fifo_t* fifo, void* storage,
+                     size_t slot_size, uint32_t capacity);
+
+/**
+ * @brief Get the next free slot (producer only)
+ * @param fifo FIFO handle
+ * @return Slot to fill, or NULL if the FIFO is full
+ */
+void* voice_fifo_reserve(voice_fifo_t* fifo);
+
+/**
+ * @brief Publish the slot returned by voice_fifo_reserve (producer only)
+ * @param fifo FIFO handle
+ */
+void voice_fifo_commit(voice_fifo_t* fifo);
+
+/**
+ * @brief Get the oldest published slot (consumer only)
+ * @param fifo FIFO handle
+ * @return Slot to read, or NULL if the FIFO is empty
+ */
+void* voice_fifo_front(voice_fifo_t* fifo);
+
+/**
+ * @brief Release the slot returned by voice_fifo_front (consumer only)
+ * @param fifo FIFO handle
+ */
+void voice_fifo_pop(voice_fifo_t* fifo);
+
+/**
+ * @brief Slots published and not yet released
+ * @param fifo FIFO handle
+ * @return Fill level, safe to call from either side
+ */
+uint32_t voice_fifo_count(const voice_fifo_t* fifo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_FIFO_H */
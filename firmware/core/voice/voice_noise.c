@@ -0,0 +1,118 @@
+/**
+ * @file voice_noise.c
+ * @brief W.I.T. Minimum-Statistics Noise Estimation Implementation
+ */
+
+#include "voice_noise.h"
+
+/* Move the smoothed level toward this frame's */
+static inline voice_db_t smooth(voice_db_t smoothed, voice_db_t level) {
+#if VOICE_FIXED_POINT
+    return smoothed + ((level - smoothed) >> VOICE_NOISE_SMOOTH_SHIFT);
+#else
+    return smoothed + (level - smoothed) * (1.0f / (1 << VOICE_NOISE_SMOOTH_SHIFT));
+#endif
+}
+
+/* Amount a minimum over frames sits below the mean level */
+static voice_db_t window_bias(voice_db_t bias, uint32_t frames) {
+#if VOICE_FIXED_POINT
+    return (voice_db_t)(((int64_t)bias * voice_dsp_log2_q16(frames)) >> 16);
+#else
+    return bias * voice_dsp_fast_log2((float)frames);
+#endif
+}
+
+/* Start a new minimum */
+void voice_noise_min_reset(voice_noise_min_t* m, voice_db_t bias) {
+    m->smoothed = VOICE_DB(VOICE_DSP_FLOOR_DB);
+    m->minimum = VOICE_DB(VOICE_DSP_FLOOR_DB);
+    m->bias = bias;
+    m->frames = 0;
+}
+
+/* Add one frame */
+void voice_noise_min_update(voice_noise_min_t* m, voice_db_t level) {
+    m->smoothed = (m->frames == 0) ? level : smooth(m->smoothed, level);
+    if (m->frames == 0 || m->smoothed < m->minimum) {
+        m->minimum = m->smoothed;
+    }
+    m->frames++;
+}
+
+/* Bias-compensated estimate */
+voice_db_t voice_noise_min_estimate(const voice_noise_min_t* m) {
+    return m->minimum + window_bias(m->bias, m->frames);
+}
+
+/* Initialize tracker */
+void voice_noise_tracker_init(voice_noise_tracker_t* tracker,
+                              uint32_t window_frames, voice_db_t bias) {
+    uint32_t subwindow_frames = window_frames / VOICE_NOISE_SUBWINDOWS;
+
+    tracker->subwindow_frames = (subwindow_frames > 0) ? subwindow_frames : 1;
+    tracker->bias = bias;
+    tracker->smoothed = VOICE_DB(VOICE_DSP_FLOOR_DB);
+    tracker->current = VOICE_DB(VOICE_DSP_FLOOR_DB);
+    tracker->frames = 0;
+    tracker->filled = 0;
+    tracker->next = 0;
+    tracker->started = false;
+}
+
+/* Restart at a known level */
+void voice_noise_tracker_seed(voice_noise_tracker_t* tracker, voice_db_t noise) {
+    voice_db_t minimum = noise - window_bias(tracker->bias,
+        tracker->subwindow_frames * VOICE_NOISE_SUBWINDOWS);
+
+    for (uint32_t i = 0; i < VOICE_NOISE_SUBWINDOWS; i++) {
+        tracker->minima[i] = minimum;
+    }
+    tracker->smoothed = noise;
+    tracker->frames = 0;
+    tracker->filled = VOICE_NOISE_SUBWINDOWS;
+    tracker->next = 0;
+    tracker->started = true;
+}
+
+/* Add one frame */
+void voice_noise_tracker_update(voice_noise_tracker_t* tracker, voice_db_t level) {
+    tracker->smoothed = tracker->started ? smooth(tracker->smoothed, level) : level;
+    tracker->started = true;
+
+    if (tracker->frames == 0 || tracker->smoothed < tracker->current) {
+        tracker->current = tracker->smoothed;
+    }
+
+    /* Close the sub-window, replacing the oldest */
+    if (++tracker->frames >= tracker->subwindow_frames) {
+        tracker->minima[tracker->next] = tracker->current;
+        tracker->next = (tracker->next + 1) % VOICE_NOISE_SUBWINDOWS;
+        if (tracker->filled < VOICE_NOISE_SUBWINDOWS) {
+            tracker->filled++;
+        }
+        tracker->frames = 0;
+    }
+}
+
+/* Bias-compensated estimate */
+bool voice_noise_tracker_estimate(const voice_noise_tracker_t* tracker,
+                                  voice_db_t* noise) {
+    if (tracker->filled < VOICE_NOISE_SUBWINDOWS) {
+        return false;
+    }
+
+    voice_db_t minimum = tracker->minima[0];
+    for (uint32_t i = 1; i < VOICE_NOISE_SUBWINDOWS; i++) {
+        if (tracker->minima[i] < minimum) {
+            minimum = tracker->minima[i];
+        }
+    }
+    if (tracker->frames > 0 && tracker->current < minimum) {
+        minimum = tracker->current;
+    }
+
+    *noise = minimum + window_bias(tracker->bias,
+        tracker->subwindow_frames * VOICE_NOISE_SUBWINDOWS);
+    return true;
+}
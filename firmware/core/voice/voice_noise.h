@@ -0,0 +1,120 @@
+/**
+ * @file voice_noise.h
+ * @brief W.I.T. Minimum-Statistics Noise Estimation
+ *
+ * Noise level estimates that keep working while speech is present. A
+ * level is smoothed frame by frame and its minimum taken over a window:
+ * speech raises the level but rarely fills a whole window, so the
+ * minimum follows the noise underneath. The minimum of a fluctuating
+ * level sits below its mean, by an amount that grows with the window.
+ * Estimates add that bias back as a fixed amount per doubling of the
+ * window. The amount depends on how much the level fluctuates, so each
+ * user measures its own.
+ *
+ * voice_noise_min_t takes the minimum over everything it has seen, for
+ * one-shot calibration. voice_noise_tracker_t slides its window in
+ * VOICE_NOISE_SUBWINDOWS steps, so a new noise level is picked up
+ * within one window whichever way it moves.
+ *
+ * Levels are kept in voice_db_t units.
+ */
+
+#ifndef WIT_VOICE_NOISE_H
+#define WIT_VOICE_NOISE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "voice_dsp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Configuration */
+#define VOICE_NOISE_SMOOTH_SHIFT    2       // Level smoothing, 1/4 per frame
+#define VOICE_NOISE_SUBWINDOWS      8       // Window steps of a tracker
+
+/* Minimum over an open-ended window */
+typedef struct {
+    voice_db_t smoothed;        // Smoothed level
+    voice_db_t minimum;         // Smallest smoothed level
+    voice_db_t bias;            // Bias per doubling of the window
+    uint32_t frames;            // Frames seen
+} voice_noise_min_t;
+
+/* Minimum over a sliding window */
+typedef struct {
+    voice_db_t smoothed;                        // Smoothed level
+    voice_db_t current;                         // Smallest level in the open sub-window
+    voice_db_t minima[VOICE_NOISE_SUBWINDOWS];  // Smallest level per closed sub-window
+    voice_db_t bias;                            // Bias per doubling of the window
+    uint32_t subwindow_frames;                  // Frames per sub-window
+    uint32_t frames;                            // Frames into the open sub-window
+    uint32_t filled;                            // Closed sub-windows kept
+    uint32_t next;                              // Sub-window to overwrite
+    bool started;                               // Smoothing has a first level
+} voice_noise_tracker_t;
+
+/**
+ * @brief Start a new minimum
+ * @param m Minimum state
+ * @param bias Bias per doubling of the window (voice_db_t units)
+ */
+void voice_noise_min_reset(voice_noise_min_t* m, voice_db_t bias);
+
+/**
+ * @brief Add one frame's level
+ * @param m Minimum state
+ * @param level Level of the frame
+ */
+void voice_noise_min_update(voice_noise_min_t* m, voice_db_t level);
+
+/**
+ * @brief Bias-compensated noise estimate
+ * @param m Minimum state, with at least one frame seen
+ * @return Estimated noise level
+ */
+voice_db_t voice_noise_min_estimate(const voice_noise_min_t* m);
+
+/**
+ * @brief Initialize a tracker
+ * @param tracker Tracker state
+ * @param window_frames Window length in frames (at least VOICE_NOISE_SUBWINDOWS)
+ * @param bias Bias per doubling of the window (voice_db_t units)
+ *
+ * The window is rounded down to whole sub-windows.
+ */
+void voice_noise_tracker_init(voice_noise_tracker_t* tracker,
+                              uint32_t window_frames, voice_db_t bias);
+
+/**
+ * @brief Restart a tracker at a known noise level
+ * @param tracker Tracker state
+ * @param noise Noise level, as voice_noise_tracker_estimate() would report it
+ *
+ * The tracker reports the level at once, and follows the input from
+ * the next frame.
+ */
+void voice_noise_tracker_seed(voice_noise_tracker_t* tracker, voice_db_t noise);
+
+/**
+ * @brief Add one frame's level
+ * @param tracker Tracker state
+ * @param level Level of the frame
+ */
+void voice_noise_tracker_update(voice_noise_tracker_t* tracker, voice_db_t level);
+
+/**
+ * @brief Bias-compensated noise estimate
+ * @param tracker Tracker state
+ * @param noise Estimated noise level
+ * @return false until a whole window has been seen or seeded
+ */
+bool voice_noise_tracker_estimate(const voice_noise_tracker_t* tracker,
+                                  voice_db_t* noise);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_NOISE_H */
@@ -0,0 +1,551 @@
+/**
+ * @file voice_pipeline.h
+ * @brief W.I.T. Voice Pipeline Extensions
+ *
+ * Extended voice core API: zero-copy ingestion of audio driver
+ * buffers, lock-free access to the circular buffer, a split
+ * dual-core processing layout, a worker pool shared by several
+ * microphone arrays and other pipeline controls layered on voice_core.
+ */
+
+#ifndef WIT_VOICE_PIPELINE_H
+#define WIT_VOICE_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "voice_core.h"
+#include "audio_driver.h"
+#include "voice_ring.h"
+#include "wake_word.h"
+#include "voice_arena.h"
+#include "voice_profile.h"
+#include "voice_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Real-time budget for one frame */
+#define VOICE_FRAME_BUDGET_US       (1e6f * VOICE_FRAME_SIZE / VOICE_SAMPLE_RATE)
+
+/* Pipeline Layout */
+#define VOICE_WAKE_QUEUE_LENGTH     8       // Frames between split stages (power of two)
+#define VOICE_CORE_ANY              -1      // No core affinity
+
+/* Wake Gating */
+#define VOICE_WAKE_BACKFILL_MS      800     // Pre-onset audio replayed into the front-end
+#define VOICE_WAKE_HANGOVER_MS      500     // Inference kept running after activity ends
+
+/* Streaming Recording */
+#define VOICE_RECORDING_CHUNK_MS    100     // Audio per chunk (whole frames)
+#define VOICE_RECORDING_CHUNKS      4       // Chunks buffered for the consumer (power of two)
+#define VOICE_RECORDING_CHUNK_SAMPLES (VOICE_SAMPLE_RATE / 1000 * VOICE_RECORDING_CHUNK_MS)
+#define VOICE_RECORDING_CHUNK_PACKETS (VOICE_RECORDING_CHUNK_SAMPLES / VOICE_FRAME_SIZE)
+
+/* Shared Worker Pool */
+#define VOICE_POOL_MAX_MEMBERS      4       // Arrays (contexts) per pool
+#define VOICE_POOL_MAX_WORKERS      4       // Front-end tasks per pool
+#define VOICE_POOL_SWITCH_DB        3.0f    // Beam SNR lead that moves a running wake stage
+
+/* Subscriber Streams */
+#define VOICE_MAX_SUBSCRIBERS       4       // voice_subscribe() readers per context
+#define VOICE_FEATURE_FRAC_BITS     7       // Published features are Q7 int16
+
+#ifndef VOICE_CORE_AFFINITY
+#if defined(ESP_PLATFORM)
+#define VOICE_CORE_AFFINITY         1       // Tasks pinned with xTaskCreatePinnedToCore
+#else
+#define VOICE_CORE_AFFINITY         0
+#endif
+#endif
+
+/* Worker pool shared by several contexts */
+typedef struct voice_pool voice_pool_t;
+
+/* Stream a subscriber reads */
+typedef enum {
+    VOICE_STREAM_RAW = 0,       // Interleaved capture, VOICE_CHANNELS values per position
+    VOICE_STREAM_MONO,          // Beamformed downmix, one value per position
+    VOICE_STREAM_FEATURES,      // Wake front-end frames, one frame per position
+    VOICE_STREAM_COUNT
+} voice_stream_t;
+
+#define VOICE_STREAM_BIT(stream)    (1u << (stream))
+
+/* Subscription to one stream */
+typedef struct voice_subscriber voice_subscriber_t;
+
+/* Processing layout */
+typedef struct {
+    /* The wake task takes each idle/listening frame through a FIFO of
+     * VOICE_WAKE_QUEUE_LENGTH; a frame that finds it full is skipped and
+     * counted in stats.buffer_overruns, never waited on. Cores are only
+     * honoured with VOICE_CORE_AFFINITY. */
+    bool split;                 // Run the wake stage on its own task
+    int32_t front_core;         // Beamforming, VAD, recording, callbacks
+    int32_t wake_core;          // Feature extraction and wake inference
+    /* Front-end and backends sleep while the energy VAD is quiet. Onset
+     * replays wake_backfill_ms from the circular buffer, beamformed as
+     * live, and pads the rest of the window with silence. */
+    bool wake_gating;           // Run the wake stage only around voice activity
+    uint32_t wake_backfill_ms;  // Ring history fed to the front-end at onset
+    uint32_t wake_hangover_ms;  // Activity hold before the wake stage sleeps
+    bool stream_recording;      // Deliver recordings in chunks, not one buffer
+    /* E.g. &voice_adpcm_encoder. Its frame_samples must be whole frames
+     * within a chunk, and its packets no larger than their PCM. */
+    const voice_encoder_t* recording_encoder; // Packet encoder for chunks (NULL = PCM)
+    /* Read back from the circular buffer and beamformed by the processing
+     * task, catching up within 64 frames. Capped by the buffer and, when
+     * streaming, by the chunks the consumer can hold; whole frames. */
+    uint32_t recording_preroll_ms; // Ring history that starts each recording
+    /* Tracks the minimum of the channel average, speech or not, so the
+     * window must outlast unbroken speech: 600-1000 ms suits commands.
+     * Whole VOICE_NOISE_SUBWINDOWS steps; the EMA runs until it fills. */
+    uint32_t noise_tracking_ms; // Minimum-statistics VAD floor window (0 = slow EMA)
+    /* AUDIO_LATENCY_LOW on activity, a wake or a recording, LOW_POWER
+     * after wake_hangover_ms without, on the driver that queued the last
+     * voice_process_buffer(); reported in stats.latency_mode. */
+    bool latency_control;       // Switch the capture driver's latency mode on activity
+    voice_pool_t* pool;         // Shared workers and wake stage (NULL = own tasks)
+    uint32_t subscriber_streams; // VOICE_STREAM_BIT()s to keep rings for (raw always)
+    /* Runs wake_engine_set_tuning() from the VAD noise floor; recordings
+     * with no VAD-active frame and voice_report_false_wake() count as
+     * false accepts. voice_set_sensitivity() scales the target. */
+    float wake_false_accepts_per_hour; // Auto-tune wake thresholds to this rate (0 = static)
+} voice_pipeline_config_t;
+
+/* Worker pool layout */
+typedef struct {
+    uint32_t num_workers;       // Front-end tasks (1-VOICE_POOL_MAX_WORKERS)
+    int32_t worker_core;        // Beamforming, VAD, recording, callbacks
+    int32_t wake_core;          // Beam selection, features and wake inference
+} voice_pool_config_t;
+
+/* Worker pool statistics */
+typedef struct {
+    uint32_t members;                           // Contexts attached
+    uint32_t slots;                             // Frame periods compared across arrays
+    uint32_t partial_slots;                     // Periods some array had no frame for
+    uint32_t wake_passes;                       // Periods the wake stage ran on
+    uint32_t source_switches;                   // Changes of the array it listens to
+    int32_t source;                             // Member listened to (-1 before the first period)
+    uint32_t wins[VOICE_POOL_MAX_MEMBERS];      // Periods each member's beam was chosen
+} voice_pool_stats_t;
+
+/* Subscriber statistics */
+typedef struct {
+    voice_stream_t stream;
+    uint8_t channels;           // Values per position
+    uint32_t position;          // Next position to read
+    uint32_t dropped;           // Positions lost to falling behind
+    uint32_t overruns;          // Times it fell behind
+} voice_subscriber_stats_t;
+
+/* Milestones of one utterance. Tick times are xTaskGetTickCount() in
+ * ms; audio_ms is on the capture clock of voice_frame_t.timestamp_ms. */
+typedef struct {
+    uint32_t trace_id;          // Utterance number from 1 (0 before the first)
+    uint32_t audio_ms;          // Capture time of the frame that completed the wake word
+    uint32_t queued_ms;         // Tick time that frame was queued, at DMA completion
+    uint32_t wake_ms;           // Tick time of the detection
+    uint32_t recording_start_ms; // Tick time the first recorded frame was processed
+    uint32_t recording_stop_ms; // Tick time recording stopped
+    bool recording;             // Still recording; recording_stop_ms is not yet set
+} voice_trace_t;
+
+/* Chunk of a streamed recording (beamformed mono) */
+typedef struct {
+    uint32_t sequence;          // Chunk index within the utterance
+    uint32_t trace_id;          // Utterance, as in voice_get_trace()
+    uint32_t timestamp_ms;      // Capture time of the first sample
+    uint32_t num_samples;       // Audio covered (0 only for a bare final chunk)
+    uint32_t dropped_samples;   // Audio lost to a slow consumer before this chunk
+    bool final;                 // Last chunk of the utterance
+    voice_codec_t codec;        // Encoding of the payload
+    uint32_t num_packets;       // Encoded packets in data (0 for PCM)
+    uint32_t data_bytes;        // Payload bytes
+    uint16_t packet_bytes[VOICE_RECORDING_CHUNK_PACKETS]; // Size of each packet, in order
+    union {
+        int16_t samples[VOICE_RECORDING_CHUNK_SAMPLES];         // PCM16 payload
+        uint8_t data[VOICE_RECORDING_CHUNK_SAMPLES * sizeof(int16_t)]; // Encoded payload
+    };
+} voice_recording_chunk_t;
+
+/* Extended statistics */
+typedef struct {
+    voice_stats_t base;                             // voice_get_stats() view
+    voice_stage_stats_t stages[VOICE_STAGE_COUNT];  // Per-stage timing
+    float frame_budget_us;                          // Real-time budget per frame
+    uint32_t frame_queue_length;                    // Queue capacity
+    uint32_t frame_queue_depth;                     // Frames waiting now
+    uint32_t frame_queue_high_water;                // Most frames ever waiting
+    uint32_t wake_queue_length;                     // Split stage queue (0 = serial)
+    uint32_t wake_queue_depth;                      // Frames waiting for the wake stage
+    uint32_t wake_queue_high_water;                 // Most frames ever waiting
+    uint32_t wake_queue_drops;                      // Frames the wake stage had no room for
+    uint32_t wake_gate_frames[WAKE_GATE_FULL + 1];  // Idle/listening frames per wake_gate_t tier
+    uint32_t wake_backfills;                        // Onsets replayed from the ring
+    uint32_t noise_calibrations;                    // voice_calibrate_noise() runs completed
+    float channel_floor_db[VOICE_CHANNELS];         // Per-channel VAD noise floor
+    audio_latency_mode_t latency_mode;              // Capture mode last requested
+    uint32_t latency_switches;                      // Capture mode changes requested
+    float beam_angle_deg;                           // Current look direction
+    uint32_t beam_steers;                           // Adaptive beam moves
+    float doa_confidence;                           // Direction tracker's last peak (0-1)
+    uint32_t subscribers;                           // voice_subscribe() readers attached
+    uint32_t subscriber_overruns;                   // Times one of them fell behind
+} voice_stats_ext_t;
+
+/* Pipelined Initialization */
+
+/**
+ * @brief Get the default (serial) pipeline layout
+ * @return Layout with split and wake gating disabled, no core affinity,
+ *         the default backfill and hangover, no noise tracking, no
+ *         latency control and no pool
+ */
+voice_pipeline_config_t voice_get_default_pipeline_config(void);
+
+/**
+ * @brief Initialize voice processing with an explicit pipeline layout
+ * @param config Voice configuration
+ * @param pipeline Processing layout (NULL for the default)
+ * @return Voice context or NULL on error
+ *
+ * Builds the voice_init() context with the tasks, queues and buffers
+ * the layout asks for; with pipeline->pool it has no tasks of its own
+ * and the first context to join is the pool's lead. Fails on a layout
+ * the pipeline cannot run, such as an unusable recording_encoder.
+ */
+voice_context_t* voice_init_pipeline(const voice_config_t* config,
+                                     const voice_pipeline_config_t* pipeline);
+
+
+#if VOICE_STATIC_ALLOC
+/* Static Allocation */
+
+/**
+ * @brief Arena size needed by voice_init_static()
+ * @param config Voice configuration
+ * @param pipeline Processing layout (NULL for the default)
+ * @return Size in bytes, or 0 for an invalid configuration
+ *
+ * Pool members after the lead keep no wake engine, so size each member
+ * just before it joins.
+ */
+size_t voice_context_required_size(const voice_config_t* config,
+                                   const voice_pipeline_config_t* pipeline);
+
+/**
+ * @brief Initialize voice processing in a caller-provided arena
+ * @param config Voice configuration
+ * @param pipeline Processing layout (NULL for the default)
+ * @param arena_memory Block of at least voice_context_required_size() bytes
+ * @param arena_size Size of the block
+ * @return Voice context or NULL on error
+ *
+ * Every buffer, queue, timer and task stack is carved from the block
+ * with VOICE_ARENA_ALIGN alignment, using the static FreeRTOS
+ * constructors, so init never touches the heap. Place the block in
+ * DMA-capable memory to keep the hot buffers there. After
+ * voice_deinit() the block may be reused for the next init.
+ */
+voice_context_t* voice_init_static(const voice_config_t* config,
+                                   const voice_pipeline_config_t* pipeline,
+                                   void* arena_memory,
+                                   size_t arena_size);
+#endif
+
+/* Shared Worker Pool */
+
+/**
+ * @brief Get the default pool layout
+ * @return Layout with two workers and no core affinity
+ */
+voice_pool_config_t voice_pool_get_default_config(void);
+
+/**
+ * @brief Create a worker pool for several microphone arrays
+ * @param config Pool layout (NULL for the default)
+ * @return Pool or NULL on error
+ *
+ * Contexts created with pipeline->pool set share the pool's
+ * num_workers front-end tasks instead of each running its own. A
+ * context with frames queued waits on the pool's run queue, and a free
+ * worker takes one frame at a time from it, so arrays are served in
+ * turn and one context's frames are never processed out of order or
+ * on two workers at once. All contexts run the same code as
+ * single-array ones; no state is shared between them.
+ *
+ * One pool task replaces the members' wake stages. Members hand it
+ * every frame's beamformed audio and its level over their noise floor,
+ * and it lines the frames up by timestamp, one period at a time. Each
+ * period it runs a single wake pass, on the beam with the highest SNR,
+ * through the lead's engine; voice_get_wake_engine() returns that
+ * engine for every member, and models are loaded into it once; the
+ * other members allocate none. A
+ * running wake stage moves to another array only when its beam leads
+ * by VOICE_POOL_SWITCH_DB; the front-end is then backfilled from that
+ * array's circular buffer as at an onset. The wake tier is the highest
+ * any member's gating asks for. A detection belongs to the array the
+ * stage was listening to, which records the utterance while the others
+ * keep capturing; its callback runs on that array's processing task.
+ * No wake pass runs on a frame captured while its array was past
+ * VOICE_STATE_LISTENING. A period is compared once every member has
+ * handed in a frame, or once any member is VOICE_WAKE_QUEUE_LENGTH
+ * frames ahead, so a stalled array does not hold the others up.
+ *
+ * Arrays must capture on a common clock and stamp their frames alike.
+ * Create the members before feeding any of them, and deinitialize the
+ * pool before its members.
+ */
+voice_pool_t* voice_pool_create(const voice_pool_config_t* config);
+
+#if VOICE_STATIC_ALLOC
+/**
+ * @brief Arena size needed by voice_pool_init_static()
+ * @param config Pool layout (NULL for the default)
+ * @return Size in bytes, or 0 for an invalid layout
+ */
+size_t voice_pool_required_size(const voice_pool_config_t* config);
+
+/**
+ * @brief Create a worker pool in a caller-provided arena
+ * @param config Pool layout (NULL for the default)
+ * @param arena_memory Block of at least voice_pool_required_size() bytes
+ * @param arena_size Size of the block
+ * @return Pool or NULL on error
+ */
+voice_pool_t* voice_pool_init_static(const voice_pool_config_t* config,
+                                     void* arena_memory,
+                                     size_t arena_size);
+#endif
+
+/**
+ * @brief Stop the pool's tasks and release it
+ * @param pool Pool handle
+ *
+ * Members stop processing; deinitialize them afterwards.
+ */
+void voice_pool_deinit(voice_pool_t* pool);
+
+/**
+ * @brief Get cross-array wake selection statistics
+ * @param pool Pool handle
+ * @param stats Output statistics
+ * @return VOICE_OK or error code
+ *
+ * Per-array timing, queues and decisions stay with each member's
+ * voice_get_stats_ext(); the wake stage's timing and backfills are the
+ * lead's.
+ */
+voice_error_t voice_pool_get_stats(const voice_pool_t* pool, voice_pool_stats_t* stats);
+
+/* Frame Ingestion */
+
+/**
+ * @brief Queue an audio driver buffer for processing without copying
+ * @param ctx Voice context
+ * @param driver Audio driver that owns the buffer
+ * @param buffer Buffer obtained from audio_driver_get_buffer()
+ * @return VOICE_OK or error code
+ *
+ * The buffer must hold interleaved S16 samples for VOICE_CHANNELS
+ * channels, any number per channel, so every driver latency mode can
+ * feed it. On success ownership passes to the voice core. A buffer of
+ * whole frames that starts on a frame boundary is split into frames
+ * read in place, and handed back with audio_driver_return_buffer() once
+ * its last frame has been processed and committed to the circular
+ * buffer. Any other buffer is copied into frame pool slots and handed
+ * back before this returns; a partial frame waits for the next buffer.
+ * Periods of whole frames that stay on whole periods from the start of
+ * capture, as audio_driver_set_latency_mode() keeps them, stay on the
+ * in-place path across mode changes. Periods shorter than a frame, such
+ * as AUDIO_LATENCY_LOW's 80 samples at 16 kHz, are always copied.
+ *
+ * The buffer is taken whole or not at all. If the frame queue or pool
+ * cannot take all of it, stats.buffer_overruns counts one overrun and
+ * the caller keeps ownership of the buffer.
+ *
+ * Drivers capturing S24 or S32 words can run audio_convert_fused() over
+ * the DMA buffer in place, applying gain and DC removal as they narrow
+ * to S16, and queue the same buffer with its format updated.
+ */
+voice_error_t voice_process_buffer(voice_context_t* ctx,
+                                  audio_driver_t* driver,
+                                  audio_buffer_t* buffer);
+
+/* Circular Buffer Access */
+
+/**
+ * @brief Attach a reader to the circular buffer
+ * @param ctx Voice context
+ * @param reader Reader to initialize at the current write position
+ * @return VOICE_OK or error code
+ *
+ * The reader is owned by a single consumer task and is drained with
+ * voice_ring_peek()/voice_ring_release(). The processing task never
+ * waits for it; samples it falls behind on are counted in
+ * reader->dropped.
+ */
+voice_error_t voice_open_buffer_reader(voice_context_t* ctx,
+                                      voice_ring_reader_t* reader);
+
+/* Subscriber Streams */
+
+/**
+ * @brief Subscribe to a stream
+ * @param ctx Voice context
+ * @param stream Stream to read
+ * @return Subscription starting at the stream's write position, or NULL
+ *         when all VOICE_MAX_SUBSCRIBERS are taken or the stream has no
+ *         ring (pipeline->subscriber_streams)
+ *
+ * Each subscription is read by one consumer task of its own, through
+ * its own cursor, and never on the DSP task. The processing task
+ * publishes raw and mono audio as it commits each frame. Features are
+ * published by whichever task runs the wake stage, only while the wake
+ * gate computes them (in a pool, by the lead). Neither waits for a
+ * subscriber. One that falls more than a ring behind skips to the
+ * oldest data still held, and the loss is counted in its stats. Use
+ * voice_register_audio_callback() only for work that fits in the frame
+ * budget; it runs on the processing task.
+ */
+voice_subscriber_t* voice_subscribe(voice_context_t* ctx, voice_stream_t stream);
+
+/**
+ * @brief Get unread data as spans inside the ring
+ * @param sub Subscription
+ * @param spans Output spans, oldest first; spans[1] may be empty
+ * @param max_positions Maximum positions to return
+ * @param timeout_ms Time to wait when nothing is unread (0 polls)
+ * @return Positions covered by the spans
+ *
+ * The spans are borrowed, not pinned: capture keeps writing, so copy or
+ * send the data before voice_subscriber_release() confirms it was not
+ * overwritten meanwhile. Features are VOICE_FEATURE_FRAC_BITS fixed
+ * point, saturated to int16.
+ */
+size_t voice_subscriber_peek(voice_subscriber_t* sub, voice_span_t spans[2],
+                             size_t max_positions, uint32_t timeout_ms);
+
+/**
+ * @brief Consume data previously returned by voice_subscriber_peek()
+ * @param sub Subscription
+ * @param positions Positions to consume
+ * @return true if the data was intact, false if capture overwrote it
+ *         while it was held (counted as an overrun)
+ */
+bool voice_subscriber_release(voice_subscriber_t* sub, size_t positions);
+
+/**
+ * @brief Get a subscription's position and losses
+ * @param sub Subscription
+ * @param stats Output statistics
+ * @return VOICE_OK or error code
+ */
+voice_error_t voice_subscriber_get_stats(const voice_subscriber_t* sub,
+                                         voice_subscriber_stats_t* stats);
+
+/**
+ * @brief End a subscription
+ * @param sub Subscription; its slot can be reused at once
+ */
+void voice_unsubscribe(voice_subscriber_t* sub);
+
+/* Streaming Recording */
+
+/**
+ * @brief Get the oldest undelivered recording chunk
+ * @param ctx Voice context initialized with pipeline->stream_recording
+ * @param chunk Output chunk, NULL if none arrived within the timeout
+ * @param timeout_ms Time to wait for a chunk (0 polls)
+ * @return VOICE_OK or error code
+ *
+ * Chunks are handed out in place, oldest first, to a single consumer
+ * task. The next chunk is not returned until this one is given back
+ * with voice_recording_release(). At most VOICE_RECORDING_CHUNKS are
+ * buffered. When the consumer falls further behind, the processing
+ * task drops new audio instead of waiting. Dropped frames are counted
+ * in stats.buffer_overruns and reported in the next chunk's
+ * dropped_samples. Every utterance ends with a final chunk, which may
+ * be empty. With an encoder, a chunk holds only whole packets.
+ * packet_bytes gives their sizes, and each packet decodes on its own.
+ * The final chunk pads the last packet with silence.
+ */
+voice_error_t voice_recording_acquire(voice_context_t* ctx,
+                                      const voice_recording_chunk_t** chunk,
+                                      uint32_t timeout_ms);
+
+/**
+ * @brief Give back the chunk returned by voice_recording_acquire()
+ * @param ctx Voice context
+ * @return VOICE_OK or error code
+ *
+ * Releasing the final chunk ends VOICE_STATE_PROCESSING, the same way
+ * voice_get_recording() does for buffered recordings.
+ */
+voice_error_t voice_recording_release(voice_context_t* ctx);
+
+/* Statistics */
+
+/**
+ * @brief Get per-stage timing and queue statistics
+ * @param ctx Voice context
+ * @param stats Output statistics
+ * @return VOICE_OK or error code
+ *
+ * Stages are timed with the core cycle counter. Stage samples are only
+ * taken when the stage runs (e.g. RECORD while recording speech);
+ * VOICE_STAGE_FRAME covers every frame end to end, and its average
+ * against frame_budget_us is what voice_get_stats() reports as
+ * cpu_usage_percent. Cleared by voice_reset().
+ */
+voice_error_t voice_get_stats_ext(const voice_context_t* ctx, voice_stats_ext_t* stats);
+
+/**
+ * @brief Get the trace of the latest utterance
+ * @param ctx Voice context
+ * @param trace Output trace
+ * @return VOICE_OK or error code
+ *
+ * A wake detection, or voice_start_recording() from idle, starts a new
+ * trace. wake_ms - queued_ms is the time capture took to reach a
+ * decision: queueing, the front-end and inference. Its recording chunks
+ * carry trace_id, so a host can join the trace to its own milestones
+ * (upload, recognition, routing) for the same utterance. Safe from any
+ * task: the copy is never torn, though recording_stop_ms is only final
+ * once recording stops.
+ */
+voice_error_t voice_get_trace(const voice_context_t* ctx, voice_trace_t* trace);
+
+/* Wake Word Engine */
+
+/**
+ * @brief Get the wake word engine driven by the processing task
+ * @param ctx Voice context
+ * @return Engine handle or NULL
+ *
+ * Load models with wake_engine_load_model() in the same order the wake
+ * words were registered; a detection by model N invokes the callback
+ * of wake word N. Members of a pool all return the lead's engine.
+ */
+wake_engine_t* voice_get_wake_engine(voice_context_t* ctx);
+
+/**
+ * @brief Report that the latest wake detection was false
+ * @param ctx Voice context
+ * @return VOICE_OK or error code
+ *
+ * For a host whose recognizer found no command in the utterance. Each
+ * detection counts once, however often it is reported, and one already
+ * judged false for a silent recording is not counted again.
+ */
+voice_error_t voice_report_false_wake(voice_context_t* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_PIPELINE_H */
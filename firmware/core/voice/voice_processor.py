@@ -0,0 +1,1033 @@
+#!/usr/bin/env python3
+"""
+W.I.T. Voice Processing Core
+Real-time voice processing pipeline for the W.I.T. Terminal
+"""
+
+import asyncio
+import bisect
+import json
+import socket
+import struct
+import time
+from dataclasses import dataclass, asdict, field
+from typing import Optional, List, Callable, Dict, Any
+from enum import Enum
+import numpy as np
+import logging
+
+# Audio processing
+import pyaudio
+import webrtcvad
+import speech_recognition as sr
+
+# For production, these would use local models
+# import pvporcupine  # For wake word detection
+# Local streaming ASR (faster_whisper) is imported when configured
+
+# Message queue
+import asyncio_mqtt as aiomqtt
+
+
+class CommandType(Enum):
+    """Types of commands the system can handle"""
+    EQUIPMENT_CONTROL = "equipment_control"
+    STATUS_QUERY = "status_query"
+    SYSTEM_CONTROL = "system_control"
+    SAFETY = "safety"
+    UNKNOWN = "unknown"
+
+
+@dataclass
+class VoiceCommand:
+    """Represents a processed voice command"""
+    text: str
+    confidence: float
+    command_type: CommandType
+    timestamp: float
+    latency_ms: float  # From the audio that completed the wake word, when traced
+    parameters: Dict[str, Any]
+    trace_id: Optional[str] = None
+
+
+@dataclass
+class Hypothesis:
+    """Recognizer output for the audio heard so far"""
+    text: str
+    confidence: float
+    is_final: bool
+
+
+@dataclass
+class UtteranceTrace:
+    """
+    Milestones of one utterance on the time.monotonic() clock, from the
+    audio that completed the wake word to the routed command. Stages a
+    terminal timed on its own clock (voice_get_trace()) go in device_ms
+    and take precedence.
+    """
+    trace_id: str
+    capture: Optional[float] = None     # Audio that completed the wake word arrived
+    wake: Optional[float] = None        # Wake word detected
+    speech_end: Optional[float] = None  # Recording stopped, or an early command's audio ended
+    upload: Optional[float] = None      # Latest audio reached the recognizer
+    asr: Optional[float] = None         # Hypothesis the command came from
+    route: Optional[float] = None       # Command published and handled
+    device_ms: Dict[str, float] = field(default_factory=dict)
+
+    # (stage, start milestone, end milestone), in utterance order
+    STAGES = (
+        ("dsp", "capture", "wake"),
+        ("listen", "wake", "speech_end"),
+        ("upload", "speech_end", "upload"),
+        ("recognition", "upload", "asr"),
+        ("routing", "asr", "route"),
+    )
+
+    def stages_ms(self) -> Dict[str, float]:
+        """Milliseconds per stage reached, with the total end to end"""
+        stages = dict(self.device_ms)
+        for name, start, end in self.STAGES:
+            begin, finish = getattr(self, start), getattr(self, end)
+            if name not in stages and begin is not None and finish is not None:
+                stages[name] = max(0.0, (finish - begin) * 1000)
+        if self.capture is not None and self.route is not None:
+            stages["total"] = (self.route - self.capture) * 1000
+        else:
+            stages["total"] = sum(stages.get(name, 0.0) for name, _, _ in self.STAGES)
+        return stages
+
+
+@dataclass
+class AudioMetrics:
+    """Real-time audio metrics"""
+    noise_level_db: float
+    signal_quality: float
+    is_speech: bool
+    vad_confidence: float
+
+
+def _json_default(value):
+    """JSON encoding for enums in event data"""
+    if isinstance(value, Enum):
+        return value.value
+    raise TypeError(f"{type(value).__name__} is not JSON serializable")
+
+
+def _utf8_prefix(text: str, limit: int) -> bytes:
+    """UTF-8 encoding of text, cut to at most limit bytes on a character boundary"""
+    return text.encode("utf-8")[:limit].decode("utf-8", errors="ignore").encode("utf-8")
+
+
+class AudioRing:
+    """
+    Preallocated ring of int16 samples, one writer (the audio callback)
+
+    Every sample is stored twice, one capacity apart, so the newest
+    samples up to a full capacity are always one contiguous numpy view:
+    nothing is copied or allocated to read them. A view is only valid
+    until the writer laps it; compare its start position against
+    overwritten() after use.
+    """
+
+    def __init__(self, capacity: int):
+        self.capacity = capacity
+        self.data = np.zeros(2 * capacity, dtype=np.int16)
+        self.position = 0  # Samples written since creation
+
+    @property
+    def available(self) -> int:
+        """Samples the ring can hand out"""
+        return min(self.position, self.capacity)
+
+    def write(self, samples: np.ndarray):
+        """Append samples (writer only)"""
+        if len(samples) > self.capacity:
+            # Only the newest capacity samples survive
+            self.position += len(samples) - self.capacity
+            samples = samples[-self.capacity:]
+        offset = self.position % self.capacity
+        first = min(len(samples), self.capacity - offset)
+        for base in (offset, offset + self.capacity):
+            self.data[base:base + first] = samples[:first]
+        rest = len(samples) - first
+        if rest:
+            # Wrapped: the tail lands at the start of both copies
+            self.data[:rest] = samples[first:]
+            self.data[self.capacity:self.capacity + rest] = samples[first:]
+        self.position += len(samples)
+
+    def view(self, start: int, length: int) -> np.ndarray:
+        """Contiguous view of length samples from position start"""
+        offset = start % self.capacity
+        return self.data[offset:offset + length]
+
+    def latest(self, length: int):
+        """Newest length samples as (view, start position)"""
+        length = min(length, self.available)
+        start = self.position - length
+        return self.view(start, length), start
+
+    def overwritten(self, start: int) -> bool:
+        """Whether samples from start on have been lapped by the writer"""
+        return self.position - start > self.capacity
+
+
+class StreamingRecognizer:
+    """
+    Local speech recognizer fed audio as it arrives
+
+    Implementations (faster-whisper, a whisper.cpp binding, ...) take
+    int16 mono audio in arbitrary slices and may return a partial
+    hypothesis from any accept() call. accept() and finish() run on a
+    worker thread, so they may block on inference.
+    """
+
+    def reset(self):
+        """Start a new utterance"""
+        raise NotImplementedError
+
+    def accept(self, audio: np.ndarray) -> Optional[Hypothesis]:
+        """Add audio; returns a partial hypothesis when one is ready"""
+        raise NotImplementedError
+
+    def finish(self) -> Optional[Hypothesis]:
+        """End the utterance and return the final hypothesis"""
+        raise NotImplementedError
+
+
+class FasterWhisperRecognizer(StreamingRecognizer):
+    """
+    faster-whisper, re-decoding the utterance every partial_interval
+    seconds of new audio; partials use greedy search, the final one a beam
+    """
+
+    def __init__(self, sample_rate: int, model: str = "tiny.en", device: str = "cpu",
+                 partial_interval: float = 0.5, max_seconds: float = 10.0):
+        from faster_whisper import WhisperModel
+        
+        self.model = WhisperModel(model, device=device, compute_type="int8")
+        self.sample_rate = sample_rate
+        self.partial_samples = int(sample_rate * partial_interval)
+        self.audio = np.zeros(int(sample_rate * max_seconds), dtype=np.float32)
+        self.reset()
+
+    def reset(self):
+        self.length = 0
+        self.decoded = 0
+
+    def accept(self, audio: np.ndarray) -> Optional[Hypothesis]:
+        count = min(len(audio), len(self.audio) - self.length)
+        np.multiply(audio[:count], 1.0 / 32768, out=self.audio[self.length:self.length + count],
+                    casting="unsafe")
+        self.length += count
+        if self.length - self.decoded < self.partial_samples:
+            return None
+        self.decoded = self.length
+        return self._decode(beam_size=1, is_final=False)
+
+    def finish(self) -> Optional[Hypothesis]:
+        hypothesis = self._decode(beam_size=5, is_final=True) if self.length else None
+        self.reset()
+        return hypothesis
+
+    def _decode(self, beam_size: int, is_final: bool) -> Optional[Hypothesis]:
+        segments, _ = self.model.transcribe(
+            self.audio[:self.length], language="en", beam_size=beam_size,
+            without_timestamps=True, condition_on_previous_text=False
+        )
+        segments = list(segments)
+        if not segments:
+            return None
+        text = " ".join(segment.text.strip() for segment in segments).strip()
+        confidence = float(np.exp(np.mean([segment.avg_logprob for segment in segments])))
+        return Hypothesis(text, confidence, is_final)
+
+
+# Recognizer factories by config name
+RECOGNIZERS: Dict[str, Callable[..., StreamingRecognizer]] = {
+    "faster-whisper": FasterWhisperRecognizer,
+}
+
+
+class TelemetryBatch:
+    """
+    Metrics and events coalesced into one binary frame per device
+
+    Frame layout (little-endian), decoded by the backend in
+    services/voice_telemetry.py:
+      header  "WVT", version u8, flags u8, device id (u8 length + UTF-8),
+              window start f64 (unix s), samples u16, events u16,
+              total commands u32, average latency f32 (ms)
+      sample  offset u16 (ms), noise level i16 (0.01 dB),
+              signal quality u8 (1/255), VAD confidence u8 (1/255),
+              flags u8 (1 = speech, 2 = listening)
+      event   offset u16 (ms), type (u8 length + UTF-8),
+              data (u16 length + JSON)
+    """
+    MAGIC = b"WVT"
+    VERSION = 1
+    MAX_WINDOW_S = 60.0  # Offsets are 16-bit milliseconds
+    MAX_ITEMS = 0xFFFF
+
+    SPEECH = 0x01
+    LISTENING = 0x02
+
+    def __init__(self, device_id: str):
+        self.device_id = _utf8_prefix(device_id, 255)
+        self.start = None
+        self.samples = []
+        self.events = []
+
+    def __len__(self):
+        return len(self.samples) + len(self.events)
+
+    def age(self, now: float) -> float:
+        """Seconds since the first item of the batch"""
+        return 0.0 if self.start is None else now - self.start
+
+    def _offset_ms(self, timestamp: float) -> int:
+        if self.start is None:
+            self.start = timestamp
+        return min(0xFFFF, max(0, int((timestamp - self.start) * 1000)))
+
+    def add_sample(self, metrics: AudioMetrics, is_listening: bool, timestamp: float):
+        """Append one metrics sample"""
+        flags = (self.SPEECH if metrics.is_speech else 0) | (self.LISTENING if is_listening else 0)
+        self.samples.append(struct.pack(
+            "<HhBBB",
+            self._offset_ms(timestamp),
+            int(max(-32768, min(32767, round(metrics.noise_level_db * 100)))),
+            int(max(0, min(255, round(metrics.signal_quality * 255)))),
+            int(max(0, min(255, round(metrics.vad_confidence * 255)))),
+            flags
+        ))
+
+    def add_event(self, event_type: str, data: Dict[str, Any], timestamp: float):
+        """Append one event; its data stays JSON"""
+        name = _utf8_prefix(event_type, 255)
+        body = json.dumps(data, default=_json_default, separators=(",", ":")).encode("utf-8")
+        self.events.append(
+            struct.pack("<HB", self._offset_ms(timestamp), len(name)) + name +
+            struct.pack("<H", len(body)) + body
+        )
+
+    def encode(self, total_commands: int, avg_latency_ms: float) -> bytes:
+        """Build the frame and start a new batch"""
+        header = (
+            struct.pack("<3sBBB", self.MAGIC, self.VERSION, 0, len(self.device_id)) +
+            self.device_id +
+            struct.pack("<dHHIf", self.start or time.time(), len(self.samples),
+                        len(self.events), total_commands & 0xFFFFFFFF, avg_latency_ms)
+        )
+        frame = b"".join([header] + self.samples + self.events)
+        self.start = None
+        self.samples = []
+        self.events = []
+        return frame
+
+
+class LatencyHistogram:
+    """
+    Per-stage latency histogram over one publishing window
+
+    Buckets are fixed, so windows from every terminal add up. Bucket i
+    counts stages of at most BOUNDS_MS[i]; the last counts the rest.
+    """
+    BOUNDS_MS = (10, 20, 50, 100, 200, 500, 1000, 2000, 5000)
+
+    def __init__(self):
+        self.reset()
+
+    def reset(self):
+        """Start a new window"""
+        self.start = time.time()
+        self.count = 0  # Utterances in the window
+        self.counts: Dict[str, List[int]] = {}
+        self.maxima: Dict[str, float] = {}
+
+    def age(self, now: float) -> float:
+        """Seconds since the window started"""
+        return now - self.start
+
+    def add(self, stages: Dict[str, float]):
+        """Count one utterance's stages"""
+        for name, ms in stages.items():
+            counts = self.counts.setdefault(name, [0] * (len(self.BOUNDS_MS) + 1))
+            counts[bisect.bisect_left(self.BOUNDS_MS, ms)] += 1
+            self.maxima[name] = max(self.maxima.get(name, 0.0), ms)
+        self.count += 1
+
+    def percentile(self, name: str, q: float) -> float:
+        """Upper edge of the bucket holding quantile q of a stage"""
+        counts = self.counts[name]
+        rank = q * sum(counts)
+        seen = 0
+        for i, count in enumerate(counts):
+            seen += count
+            if seen >= rank and count:
+                break
+        if i < len(self.BOUNDS_MS):
+            return min(float(self.BOUNDS_MS[i]), self.maxima[name])
+        return self.maxima[name]
+
+    def snapshot(self, device_id: str) -> Dict[str, Any]:
+        """Summarize the window and start a new one"""
+        now = time.time()
+        data = {
+            "device_id": device_id,
+            "window_start": self.start,
+            "window_s": now - self.start,
+            "utterances": self.count,
+            "bounds_ms": list(self.BOUNDS_MS),
+            "stages": {
+                name: {
+                    "counts": counts,
+                    "p50_ms": self.percentile(name, 0.5),
+                    "p90_ms": self.percentile(name, 0.9),
+                    "p99_ms": self.percentile(name, 0.99),
+                    "max_ms": self.maxima[name]
+                }
+                for name, counts in self.counts.items()
+            }
+        }
+        self.reset()
+        return data
+
+
+class WITVoiceProcessor:
+    """
+    Core voice processing engine for W.I.T. Terminal
+    Handles wake word detection, speech recognition, and command routing
+    """
+    
+    # Events that never wait for a telemetry batch
+    IMMEDIATE_EVENTS = {"command_recognized"}
+    
+    # Phrases by priority: (phrase, type, parameters, may fire on a partial).
+    # Only commands that stop or hold equipment act before the utterance ends.
+    COMMAND_PHRASES = [
+        ("emergency stop", CommandType.SAFETY, {"action": "emergency_stop"}, True),
+        ("stop printer", CommandType.EQUIPMENT_CONTROL, {"device": "printer", "action": "stop"}, True),
+        ("pause printer", CommandType.EQUIPMENT_CONTROL, {"device": "printer", "action": "pause"}, True),
+        ("pause job", CommandType.EQUIPMENT_CONTROL, {"device": "printer", "action": "pause"}, True),
+        ("start printer", CommandType.EQUIPMENT_CONTROL, {"device": "printer", "action": "start"}, False),
+        ("check temperature", CommandType.STATUS_QUERY, {"query": "temperature"}, False),
+        ("stop", CommandType.SAFETY, {"action": "stop"}, True),
+        ("pause", CommandType.EQUIPMENT_CONTROL, {"action": "pause"}, True),
+    ]
+    
+    def __init__(self, config: Dict[str, Any]):
+        self.config = config
+        self.logger = logging.getLogger("WIT.Voice")
+        
+        # Audio configuration
+        self.sample_rate = config.get("sample_rate", 16000)
+        self.chunk_size = config.get("chunk_size", 480)  # 30ms at 16kHz
+        self.channels = config.get("channels", 1)
+        
+        # Wake word configuration
+        self.wake_word = config.get("wake_word", "wit")
+        self.wake_sensitivity = config.get("wake_sensitivity", 0.5)
+        
+        # Processing state
+        self.is_running = False
+        self.is_listening = False
+        self.wake_word_detected = False
+        self.command_timeout = config.get("command_timeout", 5.0)
+        
+        # Audio components
+        self.audio = pyaudio.PyAudio()
+        self.stream = None
+        self.vad = webrtcvad.Vad(2)  # Aggressiveness level 0-3
+        self.recognizer = sr.Recognizer()
+        
+        # Local streaming ASR: a StreamingRecognizer, or a RECOGNIZERS name
+        self.asr = config.get("asr_engine")
+        self.early_confidence = config.get("early_command_confidence", 0.85)
+        self.end_silence = config.get("end_of_utterance_silence", 0.6)
+        self._utterance_start = None  # Set while an utterance is streaming
+        self._utterance_command = None
+        self._asr_position = None  # Next ring position to feed the recognizer
+        self._asr_start = 0  # Ring position the utterance starts at
+        
+        # Latency tracing: one trace per utterance, on the monotonic clock
+        self._trace: Optional[UtteranceTrace] = None
+        self._trace_sequence = 0
+        self._capture_time = None  # When the newest audio arrived
+        self.latency_histogram = LatencyHistogram()
+        self.latency_interval = config.get("latency_interval", 60.0)
+        
+        # Buffers
+        self.audio_ring = AudioRing(int(self.sample_rate * 10))  # 10 second buffer
+        self.command_buffer = []
+        
+        # Streaming VAD: 30 ms slices analysed as they arrive, with the
+        # confidence taken over the last vad_history slices
+        self.vad_slice = self.sample_rate * 30 // 1000
+        self.vad_position = 0
+        self.vad_history = 10
+        self._vad_bits = 0
+        self._vad_failed = False  # Logged once; metrics keep the last verdict
+        self._speech_position = 0  # Ring position just after the newest speech slice
+        self._level_scratch = np.zeros(self.vad_slice, dtype=np.float32)
+        
+        # Metrics
+        self.metrics = AudioMetrics(0, 0, False, 0)
+        self.total_commands = 0
+        self.avg_latency = 0
+        
+        # Command handlers
+        self.command_handlers: Dict[CommandType, List[Callable]] = {
+            cmd_type: [] for cmd_type in CommandType
+        }
+        
+        # MQTT client for system communication
+        self.mqtt_client = None
+        
+        # Telemetry: "json" publishes every sample and event, "batched"
+        # coalesces them into one binary frame per window
+        self.device_id = config.get("device_id", socket.gethostname())
+        self.telemetry_mode = config.get("telemetry_mode", "json")
+        self.metrics_interval = config.get("metrics_interval", 1.0)
+        self.telemetry_window = min(config.get("telemetry_window", 10.0),
+                                    TelemetryBatch.MAX_WINDOW_S)
+        self.telemetry_batch = TelemetryBatch(self.device_id)
+        
+    async def initialize(self):
+        """Initialize the voice processing system"""
+        self.logger.info("Initializing W.I.T. Voice Processor")
+        
+        try:
+            # Initialize audio stream
+            self.stream = self.audio.open(
+                format=pyaudio.paInt16,
+                channels=self.channels,
+                rate=self.sample_rate,
+                input=True,
+                frames_per_buffer=self.chunk_size,
+                stream_callback=self._audio_callback
+            )
+            
+            # Initialize MQTT connection
+            await self._connect_mqtt()
+            
+            # Load wake word model (in production)
+            # self.wake_word_engine = pvporcupine.create(keywords=[self.wake_word])
+            
+            # Load the local streaming recognizer
+            if isinstance(self.asr, str):
+                self.asr = RECOGNIZERS[self.asr](
+                    self.sample_rate,
+                    model=self.config.get("asr_model", "tiny.en"),
+                    device=self.config.get("asr_device", "cpu"),
+                    partial_interval=self.config.get("asr_partial_interval", 0.5),
+                    max_seconds=self.command_timeout
+                )
+            
+            self.is_running = True
+            self.logger.info("Voice processor initialized successfully")
+            
+        except Exception as e:
+            self.logger.error(f"Failed to initialize voice processor: {e}")
+            raise
+    
+    def _audio_callback(self, in_data, frame_count, time_info, status):
+        """Callback for audio stream processing"""
+        if status:
+            self.logger.warning(f"Audio stream status: {status}")
+        
+        # View the byte data in place and copy it once, into the ring
+        self.audio_ring.write(np.frombuffer(in_data, dtype=np.int16))
+        self._capture_time = time.monotonic()
+        
+        # Analyse every whole 30 ms slice that has arrived
+        if self.audio_ring.overwritten(self.vad_position):
+            self.vad_position = self.audio_ring.position - self.vad_slice
+        while self.vad_position + self.vad_slice <= self.audio_ring.position:
+            self._update_metrics(self.audio_ring.view(self.vad_position, self.vad_slice))
+            self.vad_position += self.vad_slice
+            if self.metrics.is_speech:
+                self._speech_position = self.vad_position
+        
+        return (in_data, pyaudio.paContinue)
+    
+    def _update_metrics(self, audio_slice: np.ndarray):
+        """Update real-time audio metrics from one VAD slice"""
+        # Calculate RMS for noise level, without overflowing int16
+        np.square(audio_slice, out=self._level_scratch, dtype=np.float32)
+        rms = float(np.sqrt(self._level_scratch.mean()))
+        self.metrics.noise_level_db = 20 * np.log10(rms + 1e-10)
+        
+        # Check for speech using VAD, straight from the ring's memory.
+        # webrtcvad takes the frame length from len(buf) in bytes, so
+        # hand it a byte view of the int16 slice, not the slice itself.
+        try:
+            is_speech = self.vad.is_speech(audio_slice.data.cast("B"), self.sample_rate)
+            mask = (1 << self.vad_history) - 1
+            self._vad_bits = ((self._vad_bits << 1) | int(is_speech)) & mask
+            self.metrics.is_speech = is_speech
+            self.metrics.vad_confidence = bin(self._vad_bits).count("1") / self.vad_history
+        except Exception as e:
+            if not self._vad_failed:
+                self._vad_failed = True
+                self.logger.error(f"VAD rejected a {len(audio_slice)}-sample slice: {e}")
+        
+        # Signal quality (simplified)
+        self.metrics.signal_quality = min(1.0, rms / 10000)
+    
+    async def start(self):
+        """Start the voice processing system"""
+        if not self.is_running:
+            await self.initialize()
+        
+        self.logger.info("Starting voice processing")
+        self.stream.start_stream()
+        
+        # Start processing tasks
+        tasks = [
+            asyncio.create_task(self._wake_word_detection_loop()),
+            asyncio.create_task(self._command_processing_loop()),
+            asyncio.create_task(self._metrics_broadcast_loop()),
+        ]
+        
+        try:
+            await asyncio.gather(*tasks)
+        except Exception as e:
+            self.logger.error(f"Error in voice processing: {e}")
+            await self.stop()
+    
+    async def stop(self):
+        """Stop the voice processing system"""
+        self.logger.info("Stopping voice processor")
+        self.is_running = False
+        
+        if self.stream:
+            self.stream.stop_stream()
+            self.stream.close()
+        
+        if self.mqtt_client:
+            await self._publish_latency(force=True)
+            await self._flush_telemetry()
+            await self.mqtt_client.disconnect()
+        
+        self.audio.terminate()
+    
+    async def _wake_word_detection_loop(self):
+        """Continuously monitor for wake word"""
+        while self.is_running:
+            if not self.is_listening and self.audio_ring.available >= self.chunk_size:
+                # Get audio chunk (a view, not a copy)
+                audio_chunk, start = self.audio_ring.latest(self.chunk_size)
+                
+                # Detect wake word (simulated for demo)
+                if self._detect_wake_word(audio_chunk):
+                    self.wake_word_detected = True
+                    self.is_listening = True
+                    trace = self._begin_trace(capture=self._capture_time)
+                    
+                    # The command starts right after the wake word
+                    self._asr_position = self._asr_start = start + len(audio_chunk)
+                    self.logger.info("Wake word detected!")
+                    
+                    # Notify system
+                    await self._publish_event("wake_word_detected", {
+                        "timestamp": time.time(),
+                        "confidence": 0.95,
+                        "trace_id": trace.trace_id
+                    })
+                    
+                    # Start listening timeout
+                    asyncio.create_task(self._listening_timeout())
+            
+            await asyncio.sleep(0.1)  # Check every 100ms
+    
+    def _detect_wake_word(self, audio_chunk: np.ndarray) -> bool:
+        """
+        Detect wake word in audio chunk
+        In production, this would use Porcupine or similar
+        """
+        # Simulated detection based on audio energy
+        energy = np.sum(audio_chunk**2) / len(audio_chunk)
+        return energy > 1000000 and np.random.random() < 0.1  # 10% chance for demo
+    
+    async def _listening_timeout(self):
+        """Handle listening timeout"""
+        await asyncio.sleep(self.command_timeout)
+        if self.is_listening:
+            self.is_listening = False
+            if self._trace and self._trace.asr is None and self.asr is None:
+                self._trace = None  # Nothing was recognized
+            self.logger.info("Listening timeout - returning to wake word detection")
+            await self._publish_event("listening_timeout", {})
+    
+    async def _command_processing_loop(self):
+        """Process voice commands when listening"""
+        while self.is_running:
+            if self.asr is not None:
+                if self.is_listening or self._asr_position is not None:
+                    await self._stream_from_ring()
+            elif self.is_listening and self.audio_ring.available >= self.sample_rate * 2:
+                # Last 2 seconds of audio, as one contiguous view
+                audio_data, start = self.audio_ring.latest(self.sample_rate * 2)
+                if self._trace:
+                    self._trace.speech_end = self._trace.upload = time.monotonic()
+                
+                # Process command
+                command = await self._process_voice_command(audio_data)
+                if self.audio_ring.overwritten(start):
+                    self.logger.warning("Command audio was overwritten during recognition")
+                
+                if command:
+                    await self._dispatch_command(command)
+                    
+                    # Reset listening state
+                    self.is_listening = False
+            
+            await asyncio.sleep(0.1)
+    
+    async def _dispatch_command(self, command: VoiceCommand):
+        """Count a recognized command, route it and close its trace"""
+        trace = self._trace if self._trace and self._trace.trace_id == command.trace_id else None
+        if trace:
+            if trace.asr is None:
+                trace.asr = time.monotonic()
+            if trace.speech_end is None:
+                trace.speech_end = trace.upload
+        
+        self.total_commands += 1
+        self.avg_latency = (
+            (self.avg_latency * (self.total_commands - 1) + command.latency_ms) 
+            / self.total_commands
+        )
+        await self._route_command(command)
+        
+        if trace:
+            trace.route = time.monotonic()
+            self.latency_histogram.add(trace.stages_ms())
+            self._trace = None
+    
+    def _begin_trace(self, capture: Optional[float] = None,
+                     trace_id: Optional[str] = None) -> UtteranceTrace:
+        """Start tracing a new utterance; a terminal's chunks bring their own ID"""
+        self._trace_sequence += 1
+        wake = time.monotonic() if capture is not None else None
+        self._trace = UtteranceTrace(trace_id or f"{self.device_id}-{self._trace_sequence}",
+                                     capture=capture, wake=wake)
+        return self._trace
+    
+    def _command_latency_ms(self, since: float) -> float:
+        """Milliseconds from the traced capture, or from since (time.time())"""
+        if self._trace and self._trace.capture is not None:
+            return (time.monotonic() - self._trace.capture) * 1000
+        return (time.time() - since) * 1000
+    
+    async def _publish_latency(self, force: bool = False):
+        """Publish the latency histogram once per latency_interval"""
+        histogram = self.latency_histogram
+        if not histogram.count:
+            return
+        if not force and histogram.age(time.time()) < self.latency_interval:
+            return
+        await self._publish_event("latency", histogram.snapshot(self.device_id))
+    
+    async def _stream_from_ring(self):
+        """Feed the local recognizer the audio captured since the last pass"""
+        ring = self.audio_ring
+        if self._asr_position is None:
+            # Listening without a detection position: from now on
+            self._asr_position = self._asr_start = ring.position
+        if ring.overwritten(self._asr_position):
+            self._asr_position = ring.position - ring.capacity
+        
+        count = ring.position - self._asr_position
+        if count:
+            audio = ring.view(self._asr_position, count)
+            self._asr_position += count
+            await self.process_recording_chunk(audio, final=False)
+        
+        # End of utterance: end_silence of audio after speech, or the
+        # listening timeout. Every VAD slice counts, not just the newest.
+        heard = self._speech_position > self._asr_start
+        silence = (ring.position - self._speech_position) / self.sample_rate
+        if not self.is_listening or (heard and silence >= self.end_silence):
+            if self._trace and self._trace.speech_end is None:
+                self._trace.speech_end = time.monotonic()
+            self._asr_position = None
+            await self.process_recording_chunk(None, final=True)
+    
+    async def process_recording_chunk(self, audio: Optional[np.ndarray], final: bool,
+                                      trace_id: Optional[str] = None,
+                                      device_ms: Optional[Dict[str, float]] = None):
+        """
+        Feed one chunk of an utterance to the local recognizer
+        Takes the local ring, or a terminal's streamed recording chunks
+        (decoded to int16 mono) as they arrive; final ends the utterance.
+        A terminal's chunks name their utterance in trace_id (its
+        voice_trace_t.trace_id), and device_ms adds the stages it timed.
+        """
+        if self.asr is None:
+            self.logger.warning("No local recognizer configured (asr_engine)")
+            return
+        
+        loop = asyncio.get_running_loop()
+        if self._utterance_start is None:
+            self._utterance_start = time.time()
+            self._utterance_command = None
+            if trace_id is not None or self._trace is None:
+                self._begin_trace(trace_id=trace_id)
+            await loop.run_in_executor(None, self.asr.reset)
+        
+        trace = self._trace
+        if trace:
+            if device_ms:
+                trace.device_ms.update(device_ms)
+            trace.upload = time.monotonic()
+            if final and trace.speech_end is None:
+                trace.speech_end = trace.upload
+        
+        if audio is not None and len(audio):
+            hypothesis = await loop.run_in_executor(None, self.asr.accept, audio)
+            if hypothesis:
+                await self._on_hypothesis(hypothesis)
+        
+        if final:
+            hypothesis = await loop.run_in_executor(None, self.asr.finish)
+            if hypothesis:
+                await self._on_hypothesis(hypothesis)
+            self._utterance_start = None
+            self._trace = None
+            self.is_listening = False
+    
+    async def _on_hypothesis(self, hypothesis: Hypothesis):
+        """Route a command from a final hypothesis, or early from a confident partial"""
+        if self._utterance_command is not None:
+            return  # One command per utterance
+        
+        parsed = self._parse_command(hypothesis.text)
+        if not parsed:
+            if hypothesis.is_final:
+                self.logger.info(f"No command in: {hypothesis.text!r}")
+            return
+        command_type, parameters, early = parsed
+        if not hypothesis.is_final and not (early and hypothesis.confidence >= self.early_confidence):
+            return
+        
+        if self._trace:
+            self._trace.asr = time.monotonic()
+        command = VoiceCommand(
+            text=hypothesis.text,
+            confidence=hypothesis.confidence,
+            command_type=command_type,
+            timestamp=time.time(),
+            latency_ms=self._command_latency_ms(self._utterance_start),
+            parameters=dict(parameters, partial=not hypothesis.is_final),
+            trace_id=self._trace.trace_id if self._trace else None
+        )
+        self._utterance_command = command
+        self.logger.info(f"Recognized command: {command.text} (confidence: {command.confidence:.2f}"
+                         f"{', partial' if not hypothesis.is_final else ''})")
+        await self._dispatch_command(command)
+    
+    def _parse_command(self, text: str):
+        """Match recognized text to (type, parameters, early) or None"""
+        words = " ".join("".join(c for c in text.lower() if c.isalnum() or c.isspace()).split())
+        padded = f" {words} "
+        for phrase, command_type, parameters, early in self.COMMAND_PHRASES:
+            if f" {phrase} " in padded:
+                return command_type, parameters, early
+        return None
+    
+    async def _process_voice_command(self, audio_data: np.ndarray) -> Optional[VoiceCommand]:
+        """
+        Process audio data into a voice command
+        In production, this would use Whisper or similar
+        audio_data is a view into the audio ring; copy it to keep it
+        """
+        start_time = time.time()
+        
+        try:
+            # Simulate speech recognition
+            # In production: text = self.whisper_model.transcribe(audio_data)
+            
+            # Demo command simulation
+            commands = [
+                ("start printer", CommandType.EQUIPMENT_CONTROL, {"device": "printer", "action": "start"}),
+                ("emergency stop", CommandType.SAFETY, {"action": "emergency_stop"}),
+                ("check temperature", CommandType.STATUS_QUERY, {"query": "temperature"}),
+                ("pause job", CommandType.EQUIPMENT_CONTROL, {"device": "printer", "action": "pause"}),
+            ]
+            
+            text, cmd_type, params = commands[np.random.randint(0, len(commands))]
+            confidence = np.random.uniform(0.8, 0.99)
+            
+            latency_ms = self._command_latency_ms(start_time)
+            
+            command = VoiceCommand(
+                text=text,
+                confidence=confidence,
+                command_type=cmd_type,
+                timestamp=time.time(),
+                latency_ms=latency_ms,
+                parameters=params,
+                trace_id=self._trace.trace_id if self._trace else None
+            )
+            
+            self.logger.info(f"Recognized command: {text} (confidence: {confidence:.2f})")
+            return command
+            
+        except Exception as e:
+            self.logger.error(f"Error processing voice command: {e}")
+            return None
+    
+    async def _route_command(self, command: VoiceCommand):
+        """Route command to appropriate handlers"""
+        # Publish to MQTT; safety commands go out ahead of everything else
+        await self._publish_event("command_recognized", asdict(command),
+                                  urgent=command.command_type == CommandType.SAFETY)
+        
+        # Call registered handlers
+        handlers = self.command_handlers.get(command.command_type, [])
+        for handler in handlers:
+            try:
+                await handler(command)
+            except Exception as e:
+                self.logger.error(f"Error in command handler: {e}")
+    
+    def register_command_handler(self, command_type: CommandType, handler: Callable):
+        """Register a handler for specific command types"""
+        self.command_handlers[command_type].append(handler)
+    
+    async def _metrics_broadcast_loop(self):
+        """Broadcast metrics periodically"""
+        while self.is_running:
+            await self._publish_latency()
+            if self.telemetry_mode == "batched":
+                now = time.time()
+                self.telemetry_batch.add_sample(self.metrics, self.is_listening, now)
+                if (self.telemetry_batch.age(now) >= self.telemetry_window or
+                        len(self.telemetry_batch) >= TelemetryBatch.MAX_ITEMS):
+                    await self._flush_telemetry()
+                await asyncio.sleep(self.metrics_interval)
+                continue
+            
+            metrics_data = {
+                "noise_level_db": self.metrics.noise_level_db,
+                "signal_quality": self.metrics.signal_quality,
+                "is_speech": self.metrics.is_speech,
+                "vad_confidence": self.metrics.vad_confidence,
+                "total_commands": self.total_commands,
+                "avg_latency_ms": self.avg_latency,
+                "is_listening": self.is_listening,
+                "timestamp": time.time()
+            }
+            
+            await self._publish_event("voice_metrics", metrics_data)
+            await asyncio.sleep(self.metrics_interval)
+    
+    async def _connect_mqtt(self):
+        """Connect to MQTT broker for system communication"""
+        try:
+            self.mqtt_client = aiomqtt.Client(
+                hostname=self.config.get("mqtt_host", "localhost"),
+                port=self.config.get("mqtt_port", 1883)
+            )
+            await self.mqtt_client.connect()
+            self.logger.info("Connected to MQTT broker")
+        except Exception as e:
+            self.logger.error(f"Failed to connect to MQTT: {e}")
+    
+    async def _publish_event(self, event_type: str, data: Dict[str, Any],
+                             urgent: bool = False):
+        """
+        Publish event to MQTT
+        In batched mode events wait for the next frame, except commands;
+        urgent (safety) events are also sent at QoS 1
+        """
+        if (self.telemetry_mode == "batched" and not urgent and
+                event_type not in self.IMMEDIATE_EVENTS):
+            self.telemetry_batch.add_event(event_type, data, time.time())
+            return
+        
+        if self.mqtt_client:
+            try:
+                topic = f"wit/voice/{event_type}"
+                payload = json.dumps(data, default=_json_default)
+                await self.mqtt_client.publish(topic, payload, qos=1 if urgent else 0)
+            except Exception as e:
+                self.logger.error(f"Failed to publish MQTT event: {e}")
+    
+    async def _flush_telemetry(self):
+        """Publish the pending telemetry batch as one frame"""
+        if not len(self.telemetry_batch) or not self.mqtt_client:
+            return
+        
+        frame = self.telemetry_batch.encode(self.total_commands, self.avg_latency)
+        try:
+            await self.mqtt_client.publish(f"wit/voice/telemetry/{self.device_id}", frame)
+        except Exception as e:
+            self.logger.error(f"Failed to publish telemetry batch: {e}")
+
+
+# Example usage and handlers
+async def handle_equipment_command(command: VoiceCommand):
+    """Handle equipment control commands"""
+    device = command.parameters.get("device")
+    action = command.parameters.get("action")
+    print(f"Equipment command: {action} on {device}")
+
+
+async def handle_safety_command(command: VoiceCommand):
+    """Handle safety-critical commands"""
+    action = command.parameters.get("action")
+    if action == "emergency_stop":
+        print("EMERGENCY STOP TRIGGERED!")
+        # Implement emergency stop logic
+
+
+async def main():
+    """Main entry point for voice processor"""
+    # Configure logging
+    logging.basicConfig(
+        level=logging.INFO,
+        format='%(asctime)s - %(name)s - %(levelname)s - %(message)s'
+    )
+    
+    # Configuration
+    config = {
+        "sample_rate": 16000,
+        "chunk_size": 480,
+        "channels": 1,
+        "wake_word": "wit",
+        "wake_sensitivity": 0.5,
+        "command_timeout": 5.0,
+        "mqtt_host": "localhost",
+        "mqtt_port": 1883,
+        "telemetry_mode": "batched",
+        "telemetry_window": 10.0
+        # "asr_engine": "faster-whisper",  # Local streaming ASR (pip install faster-whisper)
+    }
+    
+    # Create processor
+    processor = WITVoiceProcessor(config)
+    
+    # Register command handlers
+    processor.register_command_handler(
+        CommandType.EQUIPMENT_CONTROL, 
+        handle_equipment_command
+    )
+    processor.register_command_handler(
+        CommandType.SAFETY, 
+        handle_safety_command
+    )
+    
+    # Start processing
+    try:
+        await processor.start()
+    except KeyboardInterrupt:
+        print("\nShutting down...")
+        await processor.stop()
+
+
+if __name__ == "__main__":
+    asyncio.run(main())
\ No newline at end of file
@@ -0,0 +1,133 @@
+/**
+ * @file voice_profile.c
+ * @brief W.I.T. Pipeline Stage Profiling Implementation
+ */
+
+#include "voice_profile.h"
+#include <string.h>
+#include "FreeRTOS.h"
+
+#if defined(__XTENSA__)
+#define PROFILE_XTENSA          1
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+      defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+#define PROFILE_DWT             1
+#else
+#include <time.h>
+#define PROFILE_HOST            1
+#endif
+
+/* Counter frequency; defaults to the core clock on target */
+#ifndef VOICE_PROFILE_HZ
+#if defined(PROFILE_HOST)
+#define VOICE_PROFILE_HZ        1000000000u     // Nanoseconds
+#else
+#define VOICE_PROFILE_HZ        configCPU_CLOCK_HZ
+#endif
+#endif
+
+#if defined(PROFILE_DWT)
+/* Cortex-M debug registers */
+#define DEMCR                   (*(volatile uint32_t*)0xE000EDFCu)
+#define DWT_CTRL                (*(volatile uint32_t*)0xE0001000u)
+#define DWT_CYCCNT              (*(volatile uint32_t*)0xE0001004u)
+#define DEMCR_TRCENA            (1u << 24)
+#define DWT_CTRL_CYCCNTENA      (1u << 0)
+#endif
+
+/* Enable counter */
+void voice_profile_init(void) {
+#if defined(PROFILE_DWT)
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+/* Read counter */
+uint32_t voice_profile_now(void) {
+#if defined(PROFILE_XTENSA)
+    uint32_t ccount;
+    __asm__ volatile ("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+#elif defined(PROFILE_DWT)
+    return DWT_CYCCNT;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/* Counter frequency */
+uint32_t voice_profile_hz(void) {
+    return VOICE_PROFILE_HZ;
+}
+
+/* Log-scale bucket: exact below 4, then four buckets per octave */
+static uint32_t bucket_of(uint32_t cycles) {
+    if (cycles < 4) {
+        return cycles;
+    }
+    uint32_t msb = 31 - (uint32_t)__builtin_clz(cycles);
+    return (msb - 1) * 4 + ((cycles >> (msb - 2)) & 3);
+}
+
+/* Largest value that falls in a bucket */
+static uint32_t bucket_upper(uint32_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    uint32_t msb = bucket / 4 + 1;
+    uint64_t lower = (uint64_t)(4 + bucket % 4) << (msb - 2);
+    return (uint32_t)(lower + (1u << (msb - 2)) - 1);
+}
+
+/* Record sample */
+void voice_profile_record(voice_profile_stage_t* stage, uint32_t cycles) {
+    if (stage->count == 0 || cycles < stage->min_cycles) {
+        stage->min_cycles = cycles;
+    }
+    if (cycles > stage->max_cycles) {
+        stage->max_cycles = cycles;
+    }
+    stage->total_cycles += cycles;
+    stage->count++;
+    stage->histogram[bucket_of(cycles)]++;
+}
+
+/* Summarize stage */
+void voice_profile_summarize(const voice_profile_stage_t* stage,
+                             voice_stage_stats_t* stats) {
+    memset(stats, 0, sizeof(voice_stage_stats_t));
+    if (stage->count == 0) {
+        return;
+    }
+
+    float us_per_cycle = 1e6f / VOICE_PROFILE_HZ;
+
+    /* First bucket holding the 99th percentile sample */
+    uint32_t rank = stage->count - stage->count / 100;
+    uint32_t seen = 0;
+    uint32_t p99 = stage->max_cycles;
+    for (uint32_t b = 0; b < VOICE_PROFILE_BUCKETS; b++) {
+        seen += stage->histogram[b];
+        if (seen >= rank) {
+            p99 = bucket_upper(b);
+            break;
+        }
+    }
+    if (p99 > stage->max_cycles) {
+        p99 = stage->max_cycles;
+    }
+
+    stats->min_us = stage->min_cycles * us_per_cycle;
+    stats->avg_us = (float)stage->total_cycles / stage->count * us_per_cycle;
+    stats->p99_us = p99 * us_per_cycle;
+    stats->max_us = stage->max_cycles * us_per_cycle;
+    stats->count = stage->count;
+}
+
+/* Reset stage */
+void voice_profile_reset(voice_profile_stage_t* stage) {
+    memset(stage, 0, sizeof(voice_profile_stage_t));
+}
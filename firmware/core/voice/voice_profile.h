@@ -0,0 +1,99 @@
+/**
+ * @file voice_profile.h
+ * @brief W.I.T. Pipeline Stage Profiling
+ *
+ * Cycle-counter timing for the stages of the voice processing task.
+ * Each stage keeps min/max/total and a log-scale histogram (four
+ * buckets per octave) so percentiles can be read back without storing
+ * samples. Recording a sample is a handful of integer operations.
+ */
+
+#ifndef WIT_VOICE_PROFILE_H
+#define WIT_VOICE_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Configuration */
+#define VOICE_PROFILE_BUCKETS       128     // Covers the full 32-bit range
+
+/* Timed stages of the processing task */
+typedef enum {
+    VOICE_STAGE_BEAMFORM = 0,
+    VOICE_STAGE_VAD,
+    VOICE_STAGE_DOA,            // Direction tracking, adaptive beam only
+    VOICE_STAGE_DENOISE,
+    VOICE_STAGE_WAKE,
+    VOICE_STAGE_RECORD,
+    VOICE_STAGE_CALLBACK,
+    VOICE_STAGE_COMMIT,
+    VOICE_STAGE_FRAME,          // Whole frame, receive to release
+    VOICE_STAGE_COUNT
+} voice_stage_t;
+
+/* Accumulated timings for one stage */
+typedef struct {
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t count;
+    uint32_t histogram[VOICE_PROFILE_BUCKETS];
+} voice_profile_stage_t;
+
+/* Summary for one stage */
+typedef struct {
+    float min_us;
+    float avg_us;
+    float p99_us;               // Upper edge of the 99th percentile bucket
+    float max_us;
+    uint32_t count;             // Samples recorded
+} voice_stage_stats_t;
+
+/**
+ * @brief Enable the cycle counter (no-op where always running)
+ */
+void voice_profile_init(void);
+
+/**
+ * @brief Read the cycle counter
+ * @return Free-running counter, wraps at 32 bits
+ */
+uint32_t voice_profile_now(void);
+
+/**
+ * @brief Counter ticks per second
+ * @return Counter frequency in Hz
+ */
+uint32_t voice_profile_hz(void);
+
+/**
+ * @brief Record one sample
+ * @param stage Stage accumulator
+ * @param cycles Elapsed cycles
+ */
+void voice_profile_record(voice_profile_stage_t* stage, uint32_t cycles);
+
+/**
+ * @brief Summarize a stage
+ * @param stage Stage accumulator
+ * @param stats Output summary in microseconds
+ */
+void voice_profile_summarize(const voice_profile_stage_t* stage,
+                             voice_stage_stats_t* stats);
+
+/**
+ * @brief Clear a stage accumulator
+ * @param stage Stage accumulator
+ */
+void voice_profile_reset(voice_profile_stage_t* stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_PROFILE_H */
@@ -0,0 +1,132 @@
+/**
+ * @file voice_ring.c
+ * @brief W.I.T. Lock-free Audio Ring Buffer Implementation
+ */
+
+#include "voice_ring.h"
+#include <string.h>
+
+/* Round up to a power of two */
+uint32_t voice_ring_capacity_for(uint32_t min_samples) {
+    uint32_t capacity = 1;
+    while (capacity < min_samples && capacity < 0x80000000u) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/* Initialize ring */
+bool voice_ring_init(voice_ring_t* ring, int16_t* storage,
+                     uint32_t capacity, uint8_t channels) {
+    if (!ring || !storage || channels == 0 ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    ring->data = storage;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    ring->channels = channels;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->reserve, 0);
+
+    return true;
+}
+
+/* Append samples */
+void voice_ring_write(voice_ring_t* ring, const int16_t* src, size_t samples) {
+    if (samples == 0 || samples > ring->capacity) {
+        return;
+    }
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    /* Announce the region about to be overwritten before touching it */
+    atomic_store_explicit(&ring->reserve, head + (uint32_t)samples,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    /* Two-segment copy across the wrap point */
+    uint32_t pos = head & ring->mask;
+    size_t first = ring->capacity - pos;
+    if (first > samples) {
+        first = samples;
+    }
+
+    memcpy(&ring->data[pos * ring->channels], src,
+           first * ring->channels * sizeof(int16_t));
+    if (samples > first) {
+        memcpy(ring->data, &src[first * ring->channels],
+               (samples - first) * ring->channels * sizeof(int16_t));
+    }
+
+    /* Publish */
+    atomic_store_explicit(&ring->head, head + (uint32_t)samples,
+                          memory_order_release);
+}
+
+/* Get write position */
+uint32_t voice_ring_position(const voice_ring_t* ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire);
+}
+
+/* Attach reader */
+void voice_ring_reader_init(voice_ring_reader_t* reader, const voice_ring_t* ring) {
+    reader->ring = ring;
+    reader->cursor = voice_ring_position(ring);
+    reader->dropped = 0;
+}
+
+/* Attach reader in the past */
+void voice_ring_reader_init_at(voice_ring_reader_t* reader, const voice_ring_t* ring,
+                               uint32_t position) {
+    reader->ring = ring;
+    reader->cursor = position;
+    reader->dropped = 0;
+}
+
+/* Get readable spans */
+size_t voice_ring_peek(voice_ring_reader_t* reader, voice_span_t spans[2],
+                       size_t max_samples) {
+    const voice_ring_t* ring = reader->ring;
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t available = head - reader->cursor;
+
+    /* Lapped by the producer: skip to the oldest sample still held */
+    if (available > ring->capacity) {
+        reader->dropped += available - ring->capacity;
+        reader->cursor = head - ring->capacity;
+        available = ring->capacity;
+    }
+
+    size_t count = (available < max_samples) ? available : max_samples;
+    uint32_t pos = reader->cursor & ring->mask;
+    size_t first = ring->capacity - pos;
+    if (first > count) {
+        first = count;
+    }
+
+    spans[0].data = &ring->data[pos * ring->channels];
+    spans[0].samples = first;
+    spans[1].data = ring->data;
+    spans[1].samples = count - first;
+
+    return count;
+}
+
+/* Consume samples */
+bool voice_ring_release(voice_ring_reader_t* reader, size_t samples) {
+    const voice_ring_t* ring = reader->ring;
+
+    /* Order the caller's reads of the spans before checking for overwrite */
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t reserve = atomic_load_explicit(&ring->reserve, memory_order_relaxed);
+
+    bool intact = (reserve - reader->cursor) <= ring->capacity;
+    if (!intact) {
+        reader->dropped += (uint32_t)samples;
+    }
+
+    reader->cursor += (uint32_t)samples;
+    return intact;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file voice_ring.h
+ * @brief W.I.T. Lock-free Audio Ring Buffer
+ *
+ * Single-producer ring of interleaved int16 audio. The producer never
+ * blocks: it publishes its write index with release semantics and
+ * readers consume through their own cursor using zero-copy spans.
+ * A reader that falls more than one capacity behind is resynchronized
+ * and the lost samples are counted instead of stalling capture.
+ *
+ * Positions are counted in samples per channel, so one position covers
+ * all channels at one instant and reads are always channel-aligned.
+ */
+
+#ifndef WIT_VOICE_RING_H
+#define WIT_VOICE_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Contiguous run of interleaved samples inside the ring */
+typedef struct {
+    const int16_t* data;        // First sample of the run
+    size_t samples;             // Samples per channel in the run
+} voice_span_t;
+
+/* Ring state (producer side) */
+typedef struct {
+    int16_t* data;              // Storage: capacity * channels values
+    uint32_t capacity;          // Samples per channel (power of two)
+    uint32_t mask;              // capacity - 1
+    uint8_t channels;           // Interleaved channels per sample
+    _Atomic uint32_t head;      // Samples published to readers
+    _Atomic uint32_t reserve;   // Samples being written (>= head)
+} voice_ring_t;
+
+/* Reader cursor (owned by the consuming task) */
+typedef struct {
+    const voice_ring_t* ring;
+    uint32_t cursor;            // Next sample to consume
+    uint32_t dropped;           // Samples lost to overruns
+} voice_ring_reader_t;
+
+/**
+ * @brief Round a sample count up to a valid ring capacity
+ * @param min_samples Minimum samples per channel
+ * @return Power-of-two capacity
+ */
+uint32_t voice_ring_capacity_for(uint32_t min_samples);
+
+/**
+ * @brief Initialize ring over caller-provided storage
+ * @param ring Ring to initialize
+ * @param storage Storage for capacity * channels samples
+ * @param capacity Samples per channel, must be a power of two
+ * @param channels Interleaved channels per sample
+ * @return true on success, false on invalid parameters
+ */
+bool voice_ring_init(voice_ring_t* ring, int16_t* storage,
+                     uint32_t capacity, uint8_t channels);
+
+/**
+ * @brief Append samples (producer only)
+ * @param ring Ring handle
+ * @param src Interleaved samples
+ * @param samples Samples per channel, at most capacity
+ *
+ * Writes wrap transparently in up to two segments. Never blocks.
+ */
+void voice_ring_write(voice_ring_t* ring, const int16_t* src, size_t samples);
+
+/**
+ * @brief Total samples published since init
+ * @param ring Ring handle
+ * @return Write position
+ */
+uint32_t voice_ring_position(const voice_ring_t* ring);
+
+/**
+ * @brief Attach a reader at the current write position
+ * @param reader Reader to initialize
+ * @param ring Ring to read from
+ */
+void voice_ring_reader_init(voice_ring_reader_t* reader, const voice_ring_t* ring);
+
+/**
+ * @brief Attach a reader at an earlier write position
+ * @param reader Reader to initialize
+ * @param ring Ring to read from
+ * @param position Write position to start from (see voice_ring_position)
+ *
+ * Samples the ring no longer holds are skipped on the first peek and
+ * counted in dropped.
+ */
+void voice_ring_reader_init_at(voice_ring_reader_t* reader, const voice_ring_t* ring,
+                               uint32_t position);
+
+/**
+ * @brief Get readable data as contiguous spans
+ * @param reader Reader handle
+ * @param spans Output spans, oldest first; spans[1] may be empty
+ * @param max_samples Maximum samples per channel to return
+ * @return Samples per channel covered by the spans
+ */
+size_t voice_ring_peek(voice_ring_reader_t* reader, voice_span_t spans[2],
+                       size_t max_samples);
+
+/**
+ * @brief Consume samples previously returned by voice_ring_peek
+ * @param reader Reader handle
+ * @param samples Samples per channel to consume
+ * @return true if the data was intact, false if the producer
+ *         overwrote it while it was held (counted in dropped)
+ */
+bool voice_ring_release(voice_ring_reader_t* reader, size_t samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_VOICE_RING_H */
@@ -0,0 +1,579 @@
+/**
+ * @file wake_features.c
+ * @brief W.I.T. Streaming MFCC Front-end Implementation
+ */
+
+#include "wake_features.h"
+#include "voice_dsp.h"
+#include <string.h>
+#include <math.h>
+#include "FreeRTOS.h"
+
+/* Internal Constants */
+#define LN_2                    0.69314718f
+#define LOG_FLOOR               1e-10f
+#define LN_2_Q16                45426       // ln(2) in Q16
+#define LOG_FLOOR_Q16           -1509025    // ln(LOG_FLOOR) in Q16
+#define FFT_INPUT_BITS          22          // Block-float peak (bits); mel sums reach 2^58 at most
+#define FULL_SCALE_LOG2         30          // log2(32768^2)
+
+static float hz_to_mel(float hz) {
+    return 2595.0f * log10f(1.0f + hz / 700.0f);
+}
+
+static float mel_to_hz(float mel) {
+    return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+#if VOICE_FIXED_POINT
+/* Natural log in Q16 of x * 2^-scale_log2, floored like fast_ln() */
+static int32_t fixed_ln(uint64_t x, int32_t scale_log2) {
+    if (x == 0) {
+        return LOG_FLOOR_Q16;
+    }
+
+    int32_t log2_x = voice_dsp_log2_q16(x) - (scale_log2 << 16);
+    int32_t ln = (int32_t)(((int64_t)log2_x * LN_2_Q16) >> 16);
+
+    return (ln < LOG_FLOOR_Q16) ? LOG_FLOOR_Q16 : ln;
+}
+#else
+/* Natural log through the shared fast log2 */
+static float fast_ln(float x) {
+    return voice_dsp_fast_log2(fmaxf(x, LOG_FLOOR)) * LN_2;
+}
+#endif
+
+/* Build window, twiddle, mel and DCT tables */
+static void build_tables(wake_frontend_t* fe) {
+    const wake_feature_config_t* cfg = &fe->config;
+    uint32_t bins = WAKE_FEATURE_FFT_SIZE / 2 + 1;
+
+    fe->pre_emphasis = VOICE_COEF(cfg->pre_emphasis);
+
+    for (uint32_t n = 0; n < fe->frame_len; n++) {
+        fe->window[n] = VOICE_COEF(0.54f - 0.46f * cosf(2.0f * M_PI * n / (fe->frame_len - 1)));
+    }
+
+    voice_dsp_fft_twiddle(fe->twiddle, WAKE_FEATURE_FFT_SIZE);
+
+    /* Mel band edges as fractional FFT bins */
+    float low = hz_to_mel(WAKE_FEATURE_LOW_HZ);
+    float high = hz_to_mel(cfg->sample_rate / 2.0f);
+    float edges[WAKE_WORD_FEATURE_DIM + 2];
+    for (uint32_t m = 0; m < cfg->num_filters + 2; m++) {
+        float hz = mel_to_hz(low + (high - low) * m / (cfg->num_filters + 1));
+        edges[m] = hz * WAKE_FEATURE_FFT_SIZE / cfg->sample_rate;
+    }
+
+    /* Each bin sits between two edges: falling slope of the lower
+     * filter, rising slope of the upper one */
+    for (uint32_t k = 0; k < bins; k++) {
+        fe->mel_band[k] = -1;
+        fe->mel_weight[k] = VOICE_COEF(0.0f);
+        for (uint32_t m = 0; m < cfg->num_filters + 1; m++) {
+            if ((float)k >= edges[m] && (float)k < edges[m + 1]) {
+                fe->mel_band[k] = (int8_t)m;
+                fe->mel_weight[k] = VOICE_COEF(((float)k - edges[m]) /
+                                               (edges[m + 1] - edges[m]));
+                break;
+            }
+        }
+    }
+
+    float scale = sqrtf(2.0f / cfg->num_filters);
+    for (uint32_t i = 0; i < cfg->num_coeffs; i++) {
+        for (uint32_t f = 0; f < cfg->num_filters; f++) {
+            fe->dct[i * cfg->num_filters + f] =
+                VOICE_COEF(scale * cosf(M_PI * i * (f + 0.5f) / cfg->num_filters));
+        }
+    }
+}
+
+#if VOICE_FIXED_POINT
+/* Compute one feature frame from the analysis buffer into row.
+ *
+ * Block floating point: the windowed frame is formed with as many
+ * fractional bits below the input LSB as leave its peak under
+ * FFT_INPUT_BITS, so quiet frames keep their low bands after
+ * pre-emphasis. With the 1/half FFT scaling and a Q15 mel weight, a
+ * filter output carries 2 * (15 + frac_bits - log2(half)) + 15
+ * fractional bits, which the logarithm removes again. */
+static void compute_frame(wake_frontend_t* fe, float* row) {
+    const wake_feature_config_t* cfg = &fe->config;
+    const uint32_t half = WAKE_FEATURE_FFT_SIZE / 2;
+    int32_t* buf = (int32_t*)fe->fft_buffer;
+    int32_t* log_mel = (int32_t*)fe->mel_energies;
+    uint64_t mel[WAKE_WORD_FEATURE_DIM];
+
+    /* Frame energy and peak; OR of the magnitudes has the same top bit
+     * as their maximum */
+    uint64_t energy = 0;
+    uint32_t peak = 0;
+    for (uint32_t n = 0; n < fe->frame_len; n++) {
+        int32_t x = fe->analysis[n];
+        energy += (uint32_t)(x * x);
+        peak |= (uint32_t)(x < 0 ? -x : x);
+    }
+
+    /* Pre-emphasis can double the peak */
+    int32_t frac_bits = 0;
+    while (peak != 0 && ((2 * peak) << (frac_bits + 1)) < (1u << FFT_INPUT_BITS)) {
+        frac_bits++;
+    }
+
+    /* Pre-emphasis and window in Q30, down to frac_bits; zero-pad */
+    int32_t prev = fe->analysis[0];
+    for (uint32_t n = 0; n < fe->frame_len; n++) {
+        int32_t x = fe->analysis[n];
+        int64_t y = (int64_t)x * 32768 - (int64_t)fe->pre_emphasis * prev;
+        prev = x;
+        buf[n] = (int32_t)((y * fe->window[n]) >> (30 - frac_bits));
+    }
+    memset(&buf[fe->frame_len], 0,
+           (WAKE_FEATURE_FFT_SIZE - fe->frame_len) * sizeof(int32_t));
+
+    int32_t stages = 0;
+    for (uint32_t len = half; len > 1; len >>= 1) {
+        stages++;
+    }
+
+    /* Real FFT as a half-length complex FFT of even/odd pairs */
+    voice_dsp_fft(buf, half, fe->twiddle);
+
+    memset(mel, 0, cfg->num_filters * sizeof(uint64_t));
+
+    for (uint32_t k = 0; k <= half; k++) {
+        int32_t xr, xi;
+        if (k == 0 || k == half) {
+            xr = (k == 0) ? buf[0] + buf[1] : buf[0] - buf[1];
+            xi = 0;
+        } else {
+            /* Split the packed spectrum: X = E - j W O */
+            int32_t ar = buf[2 * k], ai = buf[2 * k + 1];
+            int32_t br = buf[2 * (half - k)], bi = -buf[2 * (half - k) + 1];
+            int32_t er = (ar + br) >> 1, ei = (ai + bi) >> 1;
+            int64_t or_ = (ar - br) >> 1, oi = (ai - bi) >> 1;
+            int64_t c = fe->twiddle[2 * k], s = fe->twiddle[2 * k + 1];
+            xr = er + (int32_t)((c * oi - s * or_) >> 15);
+            xi = ei - (int32_t)((c * or_ + s * oi) >> 15);
+        }
+
+        /* Accumulate power straight into the triangular filters */
+        int band = fe->mel_band[k];
+        if (band >= 0) {
+            uint64_t power = (uint64_t)((int64_t)xr * xr + (int64_t)xi * xi);
+            uint64_t w = (uint64_t)fe->mel_weight[k];
+            if (band > 0) {
+                mel[band - 1] += (32768u - w) * power;
+            }
+            if ((uint32_t)band < cfg->num_filters) {
+                mel[band] += w * power;
+            }
+        }
+    }
+
+    int32_t mel_scale = 2 * (15 + frac_bits - stages) + 15;
+    for (uint32_t f = 0; f < cfg->num_filters; f++) {
+        log_mel[f] = fixed_ln(mel[f], mel_scale);
+    }
+
+    /* DCT-II to cepstral coefficients; Q15 x Q16 back to Q16 */
+    for (uint32_t i = 0; i < cfg->num_coeffs; i++) {
+        const voice_coef_t* basis = &fe->dct[i * cfg->num_filters];
+        int64_t sum = 0;
+        for (uint32_t f = 0; f < cfg->num_filters; f++) {
+            sum += (int64_t)basis[f] * log_mel[f];
+        }
+        row[i] = (float)(int32_t)(sum >> 15) * (1.0f / 65536.0f);
+    }
+
+    if (cfg->use_energy) {
+        row[cfg->num_coeffs] = (float)fixed_ln(energy, FULL_SCALE_LOG2) * (1.0f / 65536.0f);
+    }
+}
+#else
+/* Compute one feature frame from the analysis buffer into row */
+static void compute_frame(wake_frontend_t* fe, float* row) {
+    const wake_feature_config_t* cfg = &fe->config;
+    const uint32_t half = WAKE_FEATURE_FFT_SIZE / 2;
+    float* buf = fe->fft_buffer;
+
+    /* Pre-emphasis, window, zero-pad */
+    float energy = 0.0f;
+    float prev = fe->analysis[0];
+    for (uint32_t n = 0; n < fe->frame_len; n++) {
+        float x = fe->analysis[n] * (1.0f / 32768.0f);
+        float y = x - cfg->pre_emphasis * prev * (1.0f / 32768.0f);
+        prev = fe->analysis[n];
+        energy += x * x;
+        buf[n] = y * fe->window[n];
+    }
+    memset(&buf[fe->frame_len], 0,
+           (WAKE_FEATURE_FFT_SIZE - fe->frame_len) * sizeof(float));
+
+    /* Real FFT as a half-length complex FFT of even/odd pairs */
+    voice_dsp_fft(buf, half, fe->twiddle);
+
+    memset(fe->mel_energies, 0, cfg->num_filters * sizeof(float));
+
+    for (uint32_t k = 0; k <= half; k++) {
+        float xr, xi;
+        if (k == 0 || k == half) {
+            xr = (k == 0) ? buf[0] + buf[1] : buf[0] - buf[1];
+            xi = 0.0f;
+        } else {
+            /* Split the packed spectrum: X = E - j W O */
+            float ar = buf[2 * k], ai = buf[2 * k + 1];
+            float br = buf[2 * (half - k)], bi = -buf[2 * (half - k) + 1];
+            float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+            float or_ = 0.5f * (ar - br), oi = 0.5f * (ai - bi);
+            float c = fe->twiddle[2 * k], s = fe->twiddle[2 * k + 1];
+            xr = er + (c * oi - s * or_);
+            xi = ei - (c * or_ + s * oi);
+        }
+
+        /* Accumulate power straight into the triangular filters */
+        int band = fe->mel_band[k];
+        if (band >= 0) {
+            float power = xr * xr + xi * xi;
+            float w = fe->mel_weight[k];
+            if (band > 0) {
+                fe->mel_energies[band - 1] += (1.0f - w) * power;
+            }
+            if ((uint32_t)band < cfg->num_filters) {
+                fe->mel_energies[band] += w * power;
+            }
+        }
+    }
+
+    for (uint32_t f = 0; f < cfg->num_filters; f++) {
+        fe->mel_energies[f] = fast_ln(fe->mel_energies[f]);
+    }
+
+    /* DCT-II to cepstral coefficients */
+    for (uint32_t i = 0; i < cfg->num_coeffs; i++) {
+        const float* basis = &fe->dct[i * cfg->num_filters];
+        float sum = 0.0f;
+        for (uint32_t f = 0; f < cfg->num_filters; f++) {
+            sum += basis[f] * fe->mel_energies[f];
+        }
+        fe->mfcc[i] = sum;
+    }
+
+    memcpy(row, fe->mfcc, cfg->num_coeffs * sizeof(float));
+    if (cfg->use_energy) {
+        row[cfg->num_coeffs] = fast_ln(energy);
+    }
+}
+#endif
+
+/* Derive frame geometry from the configuration */
+static wake_error_t frontend_geometry(wake_frontend_t* fe,
+                                      const wake_feature_config_t* config,
+                                      uint32_t window_ms) {
+    if (!fe || !config || config->sample_rate == 0 ||
+        config->frame_stride_ms == 0 || config->num_filters == 0 ||
+        config->num_filters > WAKE_WORD_FEATURE_DIM ||
+        config->num_coeffs == 0 || config->num_coeffs > config->num_filters) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    memset(fe, 0, sizeof(wake_frontend_t));
+    memcpy(&fe->config, config, sizeof(wake_feature_config_t));
+
+    fe->frame_len = config->sample_rate * config->frame_size_ms / 1000;
+    fe->hop = config->sample_rate * config->frame_stride_ms / 1000;
+    fe->base_dim = config->num_coeffs + (config->use_energy ? 1 : 0);
+    fe->dim = fe->base_dim * (config->use_deltas ? 2 : 1);
+    fe->window_frames = window_ms / config->frame_stride_ms;
+
+    if (fe->frame_len > WAKE_FEATURE_FFT_SIZE || fe->frame_len < fe->hop ||
+        fe->hop == 0 || fe->dim > WAKE_WORD_FEATURE_DIM || fe->window_frames == 0) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    return WAKE_OK;
+}
+
+/* Every buffer the front-end owns, shared by allocation and sizing */
+#define FRONTEND_BUFFERS        10
+
+static void frontend_buffers(wake_frontend_t* fe,
+                             void** slots[FRONTEND_BUFFERS],
+                             size_t sizes[FRONTEND_BUFFERS]) {
+    const wake_feature_config_t* cfg = &fe->config;
+    uint32_t bins = WAKE_FEATURE_FFT_SIZE / 2 + 1;
+    int n = 0;
+
+#define FRONTEND_BUFFER(field, bytes) \
+    slots[n] = (void**)&fe->field; sizes[n] = (bytes); n++
+
+    FRONTEND_BUFFER(analysis, fe->frame_len * sizeof(int16_t));
+    FRONTEND_BUFFER(window, fe->frame_len * sizeof(voice_coef_t));
+    FRONTEND_BUFFER(twiddle, WAKE_FEATURE_FFT_SIZE * sizeof(voice_coef_t));
+    FRONTEND_BUFFER(dct, cfg->num_coeffs * cfg->num_filters * sizeof(voice_coef_t));
+    FRONTEND_BUFFER(mel_band, bins * sizeof(int8_t));
+    FRONTEND_BUFFER(mel_weight, bins * sizeof(voice_coef_t));
+    FRONTEND_BUFFER(ring, 2 * fe->window_frames * fe->dim * sizeof(float));
+
+    /* Private scratch until the caller binds its own */
+    FRONTEND_BUFFER(fft_buffer, WAKE_FEATURE_FFT_SIZE * sizeof(float));
+    FRONTEND_BUFFER(mel_energies, cfg->num_filters * sizeof(float));
+    FRONTEND_BUFFER(mfcc, cfg->num_coeffs * sizeof(float));
+
+#undef FRONTEND_BUFFER
+}
+
+/* Initialize front-end from the heap or an arena */
+static wake_error_t frontend_init(wake_frontend_t* fe,
+                                  const wake_feature_config_t* config,
+                                  uint32_t window_ms,
+                                  voice_arena_t* arena) {
+    wake_error_t err = frontend_geometry(fe, config, window_ms);
+    if (err != WAKE_OK) {
+        return err;
+    }
+
+    void** slots[FRONTEND_BUFFERS];
+    size_t sizes[FRONTEND_BUFFERS];
+    frontend_buffers(fe, slots, sizes);
+
+    fe->owns_scratch = true;
+    fe->from_arena = (arena != NULL);
+
+    for (int i = 0; i < FRONTEND_BUFFERS; i++) {
+        *slots[i] = arena ? voice_arena_alloc(arena, sizes[i]) : pvPortMalloc(sizes[i]);
+        if (!*slots[i]) {
+            wake_frontend_deinit(fe);
+            return WAKE_ERR_MEMORY;
+        }
+    }
+
+    build_tables(fe);
+    wake_frontend_reset(fe);
+
+    return WAKE_OK;
+}
+
+/* Initialize front-end */
+wake_error_t wake_frontend_init(wake_frontend_t* fe,
+                                const wake_feature_config_t* config,
+                                uint32_t window_ms) {
+    return frontend_init(fe, config, window_ms, NULL);
+}
+
+#if VOICE_STATIC_ALLOC
+/* Initialize front-end in an arena */
+wake_error_t wake_frontend_init_static(wake_frontend_t* fe,
+                                       const wake_feature_config_t* config,
+                                       uint32_t window_ms,
+                                       voice_arena_t* arena) {
+    if (!arena) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+    return frontend_init(fe, config, window_ms, arena);
+}
+
+/* Arena bytes for a front-end */
+size_t wake_frontend_required_size(const wake_feature_config_t* config,
+                                   uint32_t window_ms) {
+    wake_frontend_t fe;
+    if (frontend_geometry(&fe, config, window_ms) != WAKE_OK) {
+        return 0;
+    }
+
+    void** slots[FRONTEND_BUFFERS];
+    size_t sizes[FRONTEND_BUFFERS];
+    frontend_buffers(&fe, slots, sizes);
+
+    size_t total = 0;
+    for (int i = 0; i < FRONTEND_BUFFERS; i++) {
+        total += VOICE_ARENA_SIZE(sizes[i]);
+    }
+    return total;
+}
+#endif
+
+/* Release scratch we allocated ourselves */
+static void free_scratch(wake_frontend_t* fe) {
+    if (!fe->owns_scratch || fe->from_arena) {
+        fe->owns_scratch = false;
+        return;
+    }
+    if (fe->fft_buffer) vPortFree(fe->fft_buffer);
+    if (fe->mel_energies) vPortFree(fe->mel_energies);
+    if (fe->mfcc) vPortFree(fe->mfcc);
+    fe->owns_scratch = false;
+}
+
+/* Deinitialize front-end */
+void wake_frontend_deinit(wake_frontend_t* fe) {
+    if (!fe) return;
+
+    free_scratch(fe);
+    if (fe->from_arena) {
+        /* Arena memory goes away with the arena */
+        memset(fe, 0, sizeof(wake_frontend_t));
+        return;
+    }
+    if (fe->analysis) vPortFree(fe->analysis);
+    if (fe->window) vPortFree(fe->window);
+    if (fe->twiddle) vPortFree(fe->twiddle);
+    if (fe->dct) vPortFree(fe->dct);
+    if (fe->mel_band) vPortFree(fe->mel_band);
+    if (fe->mel_weight) vPortFree(fe->mel_weight);
+    if (fe->ring) vPortFree(fe->ring);
+
+    memset(fe, 0, sizeof(wake_frontend_t));
+}
+
+/* Bind caller scratch */
+wake_error_t wake_frontend_bind_scratch(wake_frontend_t* fe,
+                                        float* fft_buffer, size_t fft_len,
+                                        float* mel_energies, size_t mel_len,
+                                        float* mfcc, size_t mfcc_len) {
+    if (!fe || !fft_buffer || !mel_energies || !mfcc ||
+        fft_len < WAKE_FEATURE_FFT_SIZE ||
+        mel_len < fe->config.num_filters ||
+        mfcc_len < fe->config.num_coeffs) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    free_scratch(fe);
+    fe->fft_buffer = fft_buffer;
+    fe->mel_energies = mel_energies;
+    fe->mfcc = mfcc;
+
+    return WAKE_OK;
+}
+
+/* Push audio */
+size_t wake_frontend_push(wake_frontend_t* fe,
+                          const int16_t* audio,
+                          size_t num_samples) {
+    size_t produced = 0;
+    uint32_t keep = fe->frame_len - fe->hop;
+
+    while (num_samples > 0) {
+        size_t take = fe->hop - fe->hop_fill;
+        if (take > num_samples) {
+            take = num_samples;
+        }
+
+        memcpy(&fe->analysis[keep + fe->hop_fill], audio, take * sizeof(int16_t));
+        fe->hop_fill += take;
+        audio += take;
+        num_samples -= take;
+
+        if (fe->hop_fill < fe->hop) {
+            break;
+        }
+
+        /* Write the new row twice so any window is contiguous */
+        uint32_t slot = fe->frames_total % fe->window_frames;
+        float* row = &fe->ring[slot * fe->dim];
+        compute_frame(fe, row);
+
+        if (fe->config.use_deltas) {
+            /* Causal delta against the frame two strides back */
+            uint32_t back = (fe->frames_total >= 2) ?
+                            (fe->frames_total - 2) % fe->window_frames : slot;
+            const float* old = &fe->ring[back * fe->dim];
+            for (uint32_t i = 0; i < fe->base_dim; i++) {
+                row[fe->base_dim + i] = 0.5f * (row[i] - old[i]);
+            }
+        }
+
+        memcpy(&fe->ring[(slot + fe->window_frames) * fe->dim], row,
+               fe->dim * sizeof(float));
+
+        fe->frames_total++;
+        produced++;
+
+        memmove(fe->analysis, &fe->analysis[fe->hop], keep * sizeof(int16_t));
+        fe->hop_fill = 0;
+    }
+
+    return produced;
+}
+
+/* Get latest window */
+bool wake_frontend_window(const wake_frontend_t* fe, wake_feature_view_t* view) {
+    if (fe->frames_total < fe->window_frames) {
+        return false;
+    }
+
+    uint32_t start = fe->frames_total % fe->window_frames;
+    view->data = &fe->ring[start * fe->dim];
+    view->frames = fe->window_frames;
+    view->dim = fe->dim;
+    view->stride = fe->dim;
+
+    return true;
+}
+
+/* Get newest frames; rows are doubled, so any run up to a window is contiguous */
+uint32_t wake_frontend_recent(const wake_frontend_t* fe, uint32_t frames,
+                              wake_feature_view_t* view) {
+    if (frames > fe->window_frames) {
+        frames = fe->window_frames;
+    }
+    if (frames > fe->frames_total) {
+        frames = fe->frames_total;
+    }
+
+    uint32_t start = (fe->frames_total - frames) % fe->window_frames;
+    view->data = &fe->ring[start * fe->dim];
+    view->frames = frames;
+    view->dim = fe->dim;
+    view->stride = fe->dim;
+
+    return frames;
+}
+
+/* Reset front-end */
+void wake_frontend_reset(wake_frontend_t* fe) {
+    memset(fe->analysis, 0, fe->frame_len * sizeof(int16_t));
+    fe->hop_fill = 0;
+    fe->frames_total = 0;
+}
+
+/* One-shot MFCC extraction */
+wake_error_t wake_extract_mfcc(const int16_t* audio,
+                               size_t num_samples,
+                               uint32_t sample_rate,
+                               float* features,
+                               size_t feature_size) {
+    if (!audio || !features || sample_rate == 0) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    wake_feature_config_t config = wake_get_default_feature_config();
+    config.sample_rate = sample_rate;
+    config.use_energy = false;
+    config.use_deltas = false;
+
+    wake_frontend_t fe;
+    wake_error_t err = wake_frontend_init(&fe, &config, config.frame_stride_ms);
+    if (err != WAKE_OK) {
+        return err;
+    }
+
+    /* Frames x num_coeffs, as many as fit */
+    size_t written = 0;
+    while (num_samples > 0 && written + fe.dim <= feature_size) {
+        size_t chunk = (num_samples < fe.hop) ? num_samples : fe.hop;
+        wake_feature_view_t view;
+        if (wake_frontend_push(&fe, audio, chunk) > 0 &&
+            wake_frontend_window(&fe, &view)) {
+            memcpy(&features[written], view.data, fe.dim * sizeof(float));
+            written += fe.dim;
+        }
+        audio += chunk;
+        num_samples -= chunk;
+    }
+
+    wake_frontend_deinit(&fe);
+    return WAKE_OK;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file wake_features.h
+ * @brief W.I.T. Streaming MFCC Front-end
+ *
+ * Incremental feature extraction for the wake word engine. Audio is
+ * pushed as it arrives and only the MFCC frames it completes are
+ * computed; finished frames land in a rolling feature matrix so the
+ * latest detection window is always available as a contiguous,
+ * strided view without copying.
+ *
+ * With VOICE_FIXED_POINT the frame is analysed with Q15 tables and a
+ * block-floating-point integer FFT; only the finished coefficients are
+ * converted to float for the feature matrix, which models read as-is.
+ */
+
+#ifndef WIT_WAKE_FEATURES_H
+#define WIT_WAKE_FEATURES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "wake_word.h"
+#include "voice_arena.h"
+#include "voice_dsp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Configuration */
+#define WAKE_FEATURE_FFT_SIZE       512     // Analysis FFT length
+#define WAKE_FEATURE_LOW_HZ         20.0f   // Lowest mel filter edge
+
+/* Front-end state */
+typedef struct {
+    wake_feature_config_t config;
+    uint32_t frame_len;         // Analysis frame length (samples)
+    uint32_t hop;               // Frame stride (samples)
+    uint32_t base_dim;          // Coefficients (+ energy)
+    uint32_t dim;               // Values per feature frame
+    uint32_t window_frames;     // Frames in a detection window
+
+    /* Framing */
+    int16_t* analysis;          // Last frame_len samples
+    uint32_t hop_fill;          // New samples since last frame
+    uint32_t frames_total;      // Frames produced since reset
+
+    /* Scratch (owned or bound from the caller; int32 in fixed point) */
+    float* fft_buffer;          // WAKE_FEATURE_FFT_SIZE floats
+    float* mel_energies;        // num_filters floats
+    float* mfcc;                // num_coeffs floats
+    bool owns_scratch;
+    bool from_arena;            // Buffers carved from an arena
+
+    /* Precomputed tables */
+    voice_coef_t pre_emphasis;  // Pre-emphasis coefficient
+    voice_coef_t* window;       // Hamming window, frame_len
+    voice_coef_t* twiddle;      // cos/sin pairs, FFT_SIZE / 2
+    voice_coef_t* dct;          // num_coeffs x num_filters
+    int8_t* mel_band;           // Lower band edge per FFT bin
+    voice_coef_t* mel_weight;   // Upper filter weight per FFT bin
+
+    /* Rolling feature matrix, every row written twice */
+    float* ring;                // 2 * window_frames * dim
+} wake_frontend_t;
+
+/**
+ * @brief Initialize the front-end
+ * @param fe Front-end state
+ * @param config Feature configuration
+ * @param window_ms Detection window length
+ * @return WAKE_OK or error code
+ */
+wake_error_t wake_frontend_init(wake_frontend_t* fe,
+                                const wake_feature_config_t* config,
+                                uint32_t window_ms);
+
+#if VOICE_STATIC_ALLOC
+/**
+ * @brief Initialize the front-end with buffers carved from an arena
+ * @param fe Front-end state
+ * @param config Feature configuration
+ * @param window_ms Detection window length
+ * @param arena Arena with wake_frontend_required_size() bytes free
+ * @return WAKE_OK or error code
+ */
+wake_error_t wake_frontend_init_static(wake_frontend_t* fe,
+                                       const wake_feature_config_t* config,
+                                       uint32_t window_ms,
+                                       voice_arena_t* arena);
+
+/**
+ * @brief Arena bytes needed by wake_frontend_init_static()
+ * @param config Feature configuration
+ * @param window_ms Detection window length
+ * @return Size in bytes, or 0 for an invalid configuration
+ */
+size_t wake_frontend_required_size(const wake_feature_config_t* config,
+                                   uint32_t window_ms);
+#endif
+
+/**
+ * @brief Release front-end memory
+ * @param fe Front-end state
+ */
+void wake_frontend_deinit(wake_frontend_t* fe);
+
+/**
+ * @brief Use caller-owned scratch buffers instead of private ones
+ * @param fe Front-end state
+ * @param fft_buffer FFT work buffer
+ * @param fft_len Length of fft_buffer in floats
+ * @param mel_energies Mel filter output buffer
+ * @param mel_len Length of mel_energies in floats
+ * @param mfcc Cepstral output buffer
+ * @param mfcc_len Length of mfcc in floats
+ * @return WAKE_OK, or WAKE_ERR_INVALID_PARAM if a buffer is too small
+ */
+wake_error_t wake_frontend_bind_scratch(wake_frontend_t* fe,
+                                        float* fft_buffer, size_t fft_len,
+                                        float* mel_energies, size_t mel_len,
+                                        float* mfcc, size_t mfcc_len);
+
+/**
+ * @brief Push audio and compute the feature frames it completes
+ * @param fe Front-end state
+ * @param audio Mono int16 samples
+ * @param num_samples Number of samples
+ * @return Number of new feature frames
+ */
+size_t wake_frontend_push(wake_frontend_t* fe,
+                          const int16_t* audio,
+                          size_t num_samples);
+
+/**
+ * @brief Get the latest detection window
+ * @param fe Front-end state
+ * @param view Output view (oldest frame first)
+ * @return true once a full window has been produced
+ */
+bool wake_frontend_window(const wake_frontend_t* fe, wake_feature_view_t* view);
+
+/**
+ * @brief Get the newest feature frames
+ * @param fe Front-end state
+ * @param frames Frames wanted, at most one window
+ * @param view Output view (oldest frame first)
+ * @return Frames in the view; fewer while the front-end is warming up
+ */
+uint32_t wake_frontend_recent(const wake_frontend_t* fe, uint32_t frames,
+                              wake_feature_view_t* view);
+
+/**
+ * @brief Discard buffered audio and features
+ * @param fe Front-end state
+ */
+void wake_frontend_reset(wake_frontend_t* fe);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_WAKE_FEATURES_H */
@@ -0,0 +1,1595 @@
+/**
+ * @file wake_word.c
+ * @brief W.I.T. Wake Word Detection Implementation
+ */
+
+#include "wake_word.h"
+#include "wake_features.h"
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Internal Constants */
+#define FORMAT_COUNT            (WAKE_MODEL_RAW_NN + 1)
+#define NN_HEADER_SIZE          12
+#define NN_LAYER_HEADER_SIZE    8
+
+static const char* const format_names[FORMAT_COUNT] = {
+    "onnx", "tflite", "hailo_hef", "raw_nn"
+};
+
+/* Pooled confidences of one noise band and the settings tuned from them */
+typedef struct {
+    uint32_t counts[WAKE_TUNE_BINS];
+    uint32_t total;
+    float threshold;
+    uint32_t window;
+    bool learned;               // Tuned at least once; threshold tracks the model's until then
+} wake_tune_band_t;
+
+/* Loaded model */
+typedef struct {
+    wake_model_info_t info;
+    const wake_backend_t* backend;
+    void* handle;
+    float threshold;
+    float pool[WAKE_WORD_POOLING_SIZE];
+    uint32_t pool_count;
+    uint32_t pool_idx;
+    uint32_t pool_window;       // Window the pool is filling at
+    wake_tune_band_t bands[WAKE_TUNE_BANDS];
+    float pending[WAKE_WORD_POOLING_SIZE]; // Newest pooled confidences, not yet learned
+    uint32_t pending_count;
+    float held[WAKE_WORD_POOLING_SIZE + 1]; // Pending and pooled at the last detection
+    uint32_t held_count;
+    uint8_t held_band;
+    bool cold;                  // Far below threshold; sits out the next stride
+    wake_model_mapper_t mapper;
+    bool mapped;                // Storage owned by mapper
+    bool resident;              // Backend holds a handle
+    bool loaded;
+} wake_model_slot_t;
+
+/* Window queued on an asynchronous backend */
+typedef struct {
+    float* input;               // Private copy of the feature window
+    float confidences[WAKE_WORD_MAX_MODELS];
+    void* handles[WAKE_WORD_MAX_MODELS];
+    int members[WAKE_WORD_MAX_MODELS];
+    size_t count;
+    uint32_t timestamp_ms;
+    TickType_t submit_tick;
+    TickType_t done_tick;       // Written by the completion
+    wake_error_t status;        // Written by the completion
+    _Atomic bool done;          // Completed, waiting for the engine's task
+    bool busy;
+} wake_inflight_t;
+
+/* Engine Structure */
+struct wake_engine {
+    wake_frontend_t frontend;
+    const wake_backend_t* backends[FORMAT_COUNT];
+
+    /* Models */
+    wake_model_slot_t models[WAKE_WORD_MAX_MODELS];
+    uint32_t pooling_window;
+    bool npu_enabled;
+    wake_gate_t gate;
+    bool powered;               // Backends last told to power up
+
+    /* Scheduling */
+    uint32_t stride_frames;
+    uint32_t frames_pending;
+
+    /* Threshold auto-tuning (guarded by async_lock) */
+    bool tuning;
+    wake_tuning_config_t tuning_config;
+    float sensitivity;
+    float noise_floor_db;
+    uint8_t band;
+    uint32_t retunes;
+    uint32_t skipped;
+    uint32_t false_accepts;
+
+    /* Detection */
+    wake_detection_t detection;
+    bool has_detection;
+    wake_detection_callback_t callback;
+    void* callback_data;
+
+    /* Asynchronous pipeline (guarded by async_lock) */
+    wake_inflight_t inflight[WAKE_ASYNC_DEPTH];
+    SemaphoreHandle_t async_lock;
+    uint32_t in_flight;
+    uint32_t max_in_flight;
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t dropped;
+    uint32_t failed;
+    TickType_t busy_since;
+    TickType_t busy_ticks;
+    TickType_t first_submit;
+#if VOICE_STATIC_ALLOC
+    StaticSemaphore_t async_lock_buffer;
+#endif
+    bool from_arena;
+
+    /* Statistics */
+    uint32_t inference_count;
+    uint32_t inference_time_ms;
+};
+
+/* Built-in RAW_NN backend */
+
+typedef struct {
+    uint16_t inputs;
+    uint16_t outputs;
+    uint8_t activation;
+    const float* weights;
+    const float* bias;
+} nn_layer_t;
+
+typedef struct {
+    uint16_t num_layers;
+    uint16_t input_frames;
+    uint16_t input_dim;
+    uint16_t max_width;
+    nn_layer_t* layers;
+    float* act[2];
+} nn_model_t;
+
+static uint16_t read_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Walk the layer table; fills layers when non-NULL */
+static wake_error_t nn_parse(const uint8_t* data, size_t size,
+                             nn_model_t* model, nn_layer_t* layers) {
+    if (!data || size < NN_HEADER_SIZE || ((uintptr_t)data & 3) != 0 ||
+        read_u32(data) != WAKE_NN_MAGIC || read_u16(data + 4) != WAKE_NN_VERSION) {
+        return WAKE_ERR_INVALID_MODEL;
+    }
+
+    model->num_layers = read_u16(data + 6);
+    model->input_frames = read_u16(data + 8);
+    model->input_dim = read_u16(data + 10);
+    model->max_width = 0;
+
+    if (model->num_layers == 0 || model->input_frames == 0 || model->input_dim == 0) {
+        return WAKE_ERR_INVALID_MODEL;
+    }
+
+    size_t offset = NN_HEADER_SIZE;
+    uint32_t expected_inputs = (uint32_t)model->input_frames * model->input_dim;
+
+    for (uint16_t l = 0; l < model->num_layers; l++) {
+        if (offset + NN_LAYER_HEADER_SIZE > size) {
+            return WAKE_ERR_INVALID_MODEL;
+        }
+
+        nn_layer_t layer;
+        layer.inputs = read_u16(data + offset);
+        layer.outputs = read_u16(data + offset + 2);
+        layer.activation = data[offset + 4];
+        offset += NN_LAYER_HEADER_SIZE;
+
+        size_t params = ((size_t)layer.inputs + 1) * layer.outputs;
+        if (layer.inputs != expected_inputs || layer.outputs == 0 ||
+            layer.activation > WAKE_NN_ACT_SIGMOID ||
+            offset + params * sizeof(float) > size) {
+            return WAKE_ERR_INVALID_MODEL;
+        }
+
+        layer.weights = (const float*)(data + offset);
+        layer.bias = layer.weights + (size_t)layer.inputs * layer.outputs;
+        offset += params * sizeof(float);
+
+        if (layers) {
+            layers[l] = layer;
+        }
+        if (layer.outputs > model->max_width) {
+            model->max_width = layer.outputs;
+        }
+        expected_inputs = layer.outputs;
+    }
+
+    /* Single confidence output */
+    return (expected_inputs == 1) ? WAKE_OK : WAKE_ERR_INVALID_MODEL;
+}
+
+static wake_error_t nn_load(const wake_model_info_t* info, void** handle) {
+    nn_model_t* model = (nn_model_t*)pvPortMalloc(sizeof(nn_model_t));
+    if (!model) {
+        return WAKE_ERR_MEMORY;
+    }
+    memset(model, 0, sizeof(nn_model_t));
+
+    wake_error_t err = nn_parse(info->data, info->size, model, NULL);
+    if (err != WAKE_OK) {
+        vPortFree(model);
+        return err;
+    }
+
+    model->layers = (nn_layer_t*)pvPortMalloc(model->num_layers * sizeof(nn_layer_t));
+    model->act[0] = (float*)pvPortMalloc(model->max_width * sizeof(float));
+    model->act[1] = (float*)pvPortMalloc(model->max_width * sizeof(float));
+    if (!model->layers || !model->act[0] || !model->act[1]) {
+        if (model->layers) vPortFree(model->layers);
+        if (model->act[0]) vPortFree(model->act[0]);
+        if (model->act[1]) vPortFree(model->act[1]);
+        vPortFree(model);
+        return WAKE_ERR_MEMORY;
+    }
+
+    nn_parse(info->data, info->size, model, model->layers);
+    *handle = model;
+    return WAKE_OK;
+}
+
+static void nn_unload(void* handle) {
+    nn_model_t* model = (nn_model_t*)handle;
+    if (!model) return;
+
+    vPortFree(model->layers);
+    vPortFree(model->act[0]);
+    vPortFree(model->act[1]);
+    vPortFree(model);
+}
+
+static float nn_activate(uint8_t activation, float x) {
+    switch (activation) {
+        case WAKE_NN_ACT_RELU:
+            return (x > 0.0f) ? x : 0.0f;
+        case WAKE_NN_ACT_SIGMOID:
+            return 1.0f / (1.0f + expf(-x));
+        default:
+            return x;
+    }
+}
+
+static wake_error_t nn_infer(void* handle, const wake_feature_view_t* input,
+                             float* confidence) {
+    nn_model_t* model = (nn_model_t*)handle;
+
+    if (input->frames < model->input_frames || input->dim < model->input_dim) {
+        return WAKE_ERR_INFERENCE;
+    }
+
+    /* First layer walks the strided window in place: latest frames only */
+    const float* base = input->data +
+                        (size_t)(input->frames - model->input_frames) * input->stride;
+    const nn_layer_t* layer = &model->layers[0];
+    float* out = model->act[0];
+
+    for (uint16_t o = 0; o < layer->outputs; o++) {
+        const float* w = &layer->weights[(size_t)o * layer->inputs];
+        float sum = layer->bias[o];
+        for (uint16_t f = 0; f < model->input_frames; f++) {
+            const float* row = &base[(size_t)f * input->stride];
+            const float* wf = &w[(size_t)f * model->input_dim];
+            for (uint16_t d = 0; d < model->input_dim; d++) {
+                sum += wf[d] * row[d];
+            }
+        }
+        out[o] = nn_activate(layer->activation, sum);
+    }
+
+    for (uint16_t l = 1; l < model->num_layers; l++) {
+        const float* in = model->act[(l - 1) & 1];
+        layer = &model->layers[l];
+        out = model->act[l & 1];
+
+        for (uint16_t o = 0; o < layer->outputs; o++) {
+            const float* w = &layer->weights[(size_t)o * layer->inputs];
+            float sum = layer->bias[o];
+            for (uint16_t i = 0; i < layer->inputs; i++) {
+                sum += w[i] * in[i];
+            }
+            out[o] = nn_activate(layer->activation, sum);
+        }
+    }
+
+    *confidence = out[0];
+    return WAKE_OK;
+}
+
+static const wake_backend_t nn_backend = {
+    .load = nn_load,
+    .unload = nn_unload,
+    .infer = nn_infer
+};
+
+/* Engine internals */
+
+static wake_model_slot_t* find_model(wake_engine_t* engine, const char* name) {
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        wake_model_slot_t* slot = &engine->models[i];
+        if (slot->loaded && name && slot->info.name &&
+            strcmp(slot->info.name, name) == 0) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+static void clear_pool(wake_model_slot_t* slot) {
+    slot->pool_count = 0;
+    slot->pool_idx = 0;
+}
+
+/* Average of the most recent confidences */
+static float pool_confidence(wake_model_slot_t* slot, float confidence) {
+    slot->pool[slot->pool_idx] = confidence;
+    slot->pool_idx = (slot->pool_idx + 1) % slot->pool_window;
+    if (slot->pool_count < slot->pool_window) {
+        slot->pool_count++;
+    }
+
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < slot->pool_count; i++) {
+        sum += slot->pool[i];
+    }
+    return sum / slot->pool_count;
+}
+
+static void engine_lock(wake_engine_t* engine) {
+    if (engine->async_lock) {
+        xSemaphoreTake(engine->async_lock, portMAX_DELAY);
+    }
+}
+
+static void engine_unlock(wake_engine_t* engine) {
+    if (engine->async_lock) {
+        xSemaphoreGive(engine->async_lock);
+    }
+}
+
+/* Start a model's bands from its static settings */
+static void reset_bands(wake_engine_t* engine, wake_model_slot_t* slot) {
+    memset(slot->bands, 0, sizeof(slot->bands));
+    for (int b = 0; b < WAKE_TUNE_BANDS; b++) {
+        slot->bands[b].threshold = slot->threshold;
+        slot->bands[b].window = engine->pooling_window;
+    }
+    slot->pending_count = 0;
+    slot->held_count = 0;
+    slot->cold = false;
+}
+
+/* Background exceedance allowed per window at the target rate */
+static float allowed_per_window(const wake_engine_t* engine) {
+    float windows_per_hour = 3600000.0f / WAKE_WORD_STRIDE_MS;
+    float rate = engine->tuning_config.false_accepts_per_hour *
+                 powf(2.0f, 4.0f * engine->sensitivity - 2.0f);
+    return rate / windows_per_hour;
+}
+
+/* Set a band's threshold just above the confidences over the allowance */
+static void retune_band(wake_engine_t* engine, wake_tune_band_t* band) {
+    const wake_tuning_config_t* config = &engine->tuning_config;
+    if (band->total < WAKE_TUNE_MIN_WINDOWS) {
+        return;
+    }
+
+    float allowed = allowed_per_window(engine) * band->total;
+    uint32_t tail = 0;
+    int bin = WAKE_TUNE_BINS;
+    while (bin > 0 && tail + band->counts[bin - 1] <= allowed) {
+        tail += band->counts[bin - 1];
+        bin--;
+    }
+    float tuned = (float)bin / WAKE_TUNE_BINS;
+
+    /* Pooling longer narrows the background; shorter detects sooner */
+    uint32_t window = band->window;
+    if (tuned > config->max_threshold && window < WAKE_WORD_POOLING_SIZE) {
+        window++;
+    } else if (tuned + 2.0f / WAKE_TUNE_BINS < config->min_threshold &&
+               window > config->min_pooling) {
+        window--;
+    }
+
+    if (tuned < config->min_threshold) {
+        tuned = config->min_threshold;
+    } else if (tuned > config->max_threshold) {
+        tuned = config->max_threshold;
+    }
+
+    if (window != band->window) {
+        /* Confidences pooled at the old window no longer apply */
+        memset(band->counts, 0, sizeof(band->counts));
+        band->total = 0;
+        band->window = window;
+        engine->retunes++;
+    }
+    if (tuned != band->threshold) {
+        band->threshold = tuned;
+        engine->retunes++;
+    }
+    band->learned = true;
+}
+
+/* Learn one pooled background confidence */
+static void learn_confidence(wake_engine_t* engine, wake_tune_band_t* band, float pooled) {
+    int bin = (int)(pooled * WAKE_TUNE_BINS);
+    if (bin >= WAKE_TUNE_BINS) {
+        bin = WAKE_TUNE_BINS - 1;
+    } else if (bin < 0) {
+        bin = 0;
+    }
+    band->counts[bin]++;
+    band->total++;
+
+    /* Forget slowly, so the band follows a room that changes */
+    if (band->total >= WAKE_TUNE_MAX_WINDOWS) {
+        band->total = 0;
+        for (int b = 0; b < WAKE_TUNE_BINS; b++) {
+            band->counts[b] /= 2;
+            band->total += band->counts[b];
+        }
+    }
+    retune_band(engine, band);
+}
+
+/* Learn the pending confidences of a model into a band */
+static void learn_pending(wake_engine_t* engine, wake_model_slot_t* slot, uint8_t band) {
+    for (uint32_t i = 0; i < slot->pending_count; i++) {
+        learn_confidence(engine, &slot->bands[band], slot->pending[i]);
+    }
+    slot->pending_count = 0;
+}
+
+/* Queue a pooled confidence; the oldest is learned once a window old */
+static void observe_confidence(wake_engine_t* engine, wake_model_slot_t* slot, float pooled) {
+    if (slot->pending_count >= slot->pool_window) {
+        learn_confidence(engine, &slot->bands[engine->band], slot->pending[0]);
+        slot->pending_count--;
+        memmove(slot->pending, slot->pending + 1, slot->pending_count * sizeof(float));
+    }
+    slot->pending[slot->pending_count++] = pooled;
+}
+
+/* Pool one model's confidence; true if it raised a detection */
+static bool score_model(wake_engine_t* engine, int index,
+                        float confidence, uint32_t timestamp_ms) {
+    wake_model_slot_t* slot = &engine->models[index];
+    uint32_t window = engine->pooling_window;
+    float threshold = slot->threshold;
+    if (engine->tuning) {
+        window = slot->bands[engine->band].window;
+        threshold = slot->bands[engine->band].threshold;
+    }
+    if (window != slot->pool_window) {
+        clear_pool(slot);
+        slot->pool_window = window;
+    }
+
+    float pooled = pool_confidence(slot, confidence);
+    if (slot->pool_count < window) {
+        return false;
+    }
+    if (engine->tuning) {
+        slot->cold = (pooled < threshold - engine->tuning_config.skip_margin);
+    }
+    if (pooled < threshold) {
+        if (engine->tuning) {
+            observe_confidence(engine, slot, pooled);
+        }
+        return false;
+    }
+
+    /* Keep the windows behind a detection out until it is judged */
+    if (engine->tuning) {
+        memcpy(slot->held, slot->pending, slot->pending_count * sizeof(float));
+        slot->held[slot->pending_count] = pooled;
+        slot->held_count = slot->pending_count + 1;
+        slot->held_band = engine->band;
+        slot->pending_count = 0;
+    }
+
+    engine->detection.wake_word = slot->info.name;
+    engine->detection.confidence = pooled;
+    engine->detection.timestamp_ms = timestamp_ms;
+    engine->detection.start_offset_ms = WAKE_WORD_WINDOW_MS;
+    engine->detection.end_offset_ms = 0;
+    engine->detection.model_index = (uint8_t)index;
+    engine->has_detection = true;
+
+    /* Refill the pool before this model can fire again */
+    clear_pool(slot);
+    return true;
+}
+
+/* Power backends to match the gate; caller holds the lock */
+static void update_power(wake_engine_t* engine) {
+    bool powered = engine->gate == WAKE_GATE_FULL || engine->in_flight > 0;
+    if (powered == engine->powered) {
+        return;
+    }
+    engine->powered = powered;
+
+    for (int f = 0; f < FORMAT_COUNT; f++) {
+        const wake_backend_t* backend = engine->backends[f];
+        bool seen = false;
+        for (int g = 0; g < f && !seen; g++) {
+            seen = (engine->backends[g] == backend);
+        }
+        if (backend && backend->set_power && !seen) {
+            backend->set_power(powered);
+        }
+    }
+}
+
+/* Score a group of results and deliver detections outside the lock */
+static void score_group(wake_engine_t* engine, const int* members,
+                        void* const* handles, const float* confidences,
+                        size_t count, uint32_t timestamp_ms) {
+    for (size_t k = 0; k < count; k++) {
+        wake_detection_t detection;
+        bool fired = false;
+
+        engine_lock(engine);
+        wake_model_slot_t* slot = &engine->models[members[k]];
+        /* Skip results for a model unloaded while in flight */
+        if (slot->loaded && slot->handle == handles[k] &&
+            score_model(engine, members[k], confidences[k], timestamp_ms)) {
+            detection = engine->detection;
+            fired = true;
+        }
+        engine_unlock(engine);
+
+        if (fired && engine->callback) {
+            engine->callback(&detection, engine->callback_data);
+        }
+    }
+}
+
+/* Allocate input tensors the first time an async backend is installed */
+static wake_error_t ensure_async(wake_engine_t* engine) {
+    if (engine->async_lock) {
+        return WAKE_OK;
+    }
+
+    size_t window = (size_t)engine->frontend.window_frames * engine->frontend.dim;
+    for (int i = 0; i < WAKE_ASYNC_DEPTH; i++) {
+        engine->inflight[i].input = (float*)pvPortMalloc(window * sizeof(float));
+        if (!engine->inflight[i].input) {
+            goto error_cleanup;
+        }
+    }
+
+    engine->async_lock = xSemaphoreCreateMutex();
+    if (!engine->async_lock) {
+        goto error_cleanup;
+    }
+    return WAKE_OK;
+
+error_cleanup:
+    for (int i = 0; i < WAKE_ASYNC_DEPTH; i++) {
+        if (engine->inflight[i].input) {
+            vPortFree(engine->inflight[i].input);
+            engine->inflight[i].input = NULL;
+        }
+    }
+    return WAKE_ERR_MEMORY;
+}
+
+/* Score completed windows and release their tensors (engine's task) */
+static void collect_completions(wake_engine_t* engine) {
+    for (uint32_t t = 0; t < WAKE_ASYNC_DEPTH; t++) {
+        wake_inflight_t* job = &engine->inflight[t];
+        if (!atomic_load_explicit(&job->done, memory_order_acquire)) {
+            continue;
+        }
+
+        engine_lock(engine);
+        engine->inference_time_ms += (job->done_tick - job->submit_tick) * portTICK_PERIOD_MS;
+        engine->inference_count++;
+        engine->completed++;
+        if (--engine->in_flight == 0) {
+            engine->busy_ticks += job->done_tick - engine->busy_since;
+            update_power(engine);
+        }
+        engine_unlock(engine);
+
+        if (job->status == WAKE_OK) {
+            score_group(engine, job->members, job->handles, job->confidences,
+                        job->count, job->timestamp_ms);
+        }
+
+        /* Hand the tensor back only after its results are consumed */
+        atomic_store_explicit(&job->done, false, memory_order_relaxed);
+        engine_lock(engine);
+        job->busy = false;
+        engine_unlock(engine);
+    }
+}
+
+/* Copy the window into a free input tensor and queue it */
+static wake_error_t submit_async(wake_engine_t* engine,
+                                 const wake_backend_t* backend,
+                                 void* const* handles, const int* members,
+                                 size_t count, const wake_feature_view_t* view,
+                                 uint32_t timestamp_ms) {
+    wake_inflight_t* job = NULL;
+    uint32_t ticket = 0;
+
+    engine_lock(engine);
+    for (uint32_t t = 0; t < WAKE_ASYNC_DEPTH; t++) {
+        if (!engine->inflight[t].busy) {
+            job = &engine->inflight[t];
+            ticket = t;
+            job->busy = true;
+            break;
+        }
+    }
+    if (!job) {
+        engine->dropped++;
+        engine_unlock(engine);
+        return WAKE_OK;
+    }
+    engine_unlock(engine);
+
+    /* The ring keeps moving, so the NPU gets a private copy */
+    for (uint32_t f = 0; f < view->frames; f++) {
+        memcpy(&job->input[(size_t)f * view->dim],
+               &view->data[(size_t)f * view->stride],
+               view->dim * sizeof(float));
+    }
+    wake_feature_view_t input = {
+        .data = job->input,
+        .frames = view->frames,
+        .dim = view->dim,
+        .stride = view->dim
+    };
+
+    memcpy(job->handles, handles, count * sizeof(void*));
+    memcpy(job->members, members, count * sizeof(int));
+    job->count = count;
+    job->timestamp_ms = timestamp_ms;
+
+    engine_lock(engine);
+    TickType_t now = xTaskGetTickCount();
+    job->submit_tick = now;
+    if (engine->submitted == 0) {
+        engine->first_submit = now;
+    }
+    if (engine->in_flight++ == 0) {
+        engine->busy_since = now;
+    }
+    if (engine->in_flight > engine->max_in_flight) {
+        engine->max_in_flight = engine->in_flight;
+    }
+    engine->submitted++;
+    engine_unlock(engine);
+
+    wake_error_t err = backend->submit(engine, job->handles, count, &input,
+                                       job->confidences, ticket);
+    if (err != WAKE_OK) {
+        /* Never queued: take the window back out of the accounting */
+        engine_lock(engine);
+        engine->submitted--;
+        engine->failed++;
+        if (--engine->in_flight == 0) {
+            update_power(engine);
+        }
+        job->busy = false;
+        engine_unlock(engine);
+    }
+    return err;
+}
+
+/* Any window still with its backend; caller holds the lock */
+static bool async_running(const wake_engine_t* engine) {
+    for (uint32_t t = 0; t < WAKE_ASYNC_DEPTH; t++) {
+        const wake_inflight_t* job = &engine->inflight[t];
+        if (job->busy && !atomic_load_explicit(&job->done, memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Release backend handle and mapping */
+static void release_model(wake_model_slot_t* slot) {
+    if (slot->resident) {
+        slot->backend->unload(slot->handle);
+    }
+    if (slot->mapped && slot->info.data) {
+        slot->mapper.unmap(slot->mapper.source, slot->info.data, slot->info.size);
+    }
+    memset(slot, 0, sizeof(wake_model_slot_t));
+}
+
+/* Page a mapped model in: map, validate in place, load */
+static wake_error_t make_resident(wake_model_slot_t* slot) {
+    const uint8_t* data = NULL;
+    size_t size = 0;
+
+    wake_error_t err = slot->mapper.map(slot->mapper.source, &data, &size);
+    if (err == WAKE_OK) {
+        slot->info.data = data;
+        slot->info.size = size;
+        err = wake_validate_model(data, size, slot->info.format);
+    }
+    if (err == WAKE_OK) {
+        err = slot->backend->load(&slot->info, &slot->handle);
+    }
+
+    if (err != WAKE_OK) {
+        release_model(slot);
+        return err;
+    }
+
+    slot->resident = true;
+    return WAKE_OK;
+}
+
+/* Run every loaded model on the current window, one call per backend
+ * when the backend can batch */
+static wake_error_t run_inference(wake_engine_t* engine,
+                                  const wake_feature_view_t* view,
+                                  uint32_t timestamp_ms) {
+    wake_error_t result = WAKE_OK;
+    bool done[WAKE_WORD_MAX_MODELS] = { false };
+
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        wake_model_slot_t* slot = &engine->models[i];
+        if (slot->loaded && !slot->resident) {
+            wake_error_t err = make_resident(slot);
+            if (err != WAKE_OK) {
+                result = err;
+            }
+        }
+    }
+
+    /* Cold models sit this stride out; they run again on the next */
+    engine_lock(engine);
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        wake_model_slot_t* slot = &engine->models[i];
+        if (slot->loaded && slot->cold) {
+            slot->cold = false;
+            done[i] = true;
+            engine->skipped++;
+        }
+    }
+    engine_unlock(engine);
+
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        wake_model_slot_t* slot = &engine->models[i];
+        if (!slot->loaded || done[i]) {
+            continue;
+        }
+
+        const wake_backend_t* backend = slot->backend;
+        bool batch = backend->infer_batch || backend->submit;
+        void* handles[WAKE_WORD_MAX_MODELS];
+        int members[WAKE_WORD_MAX_MODELS];
+        size_t count = 0;
+
+        for (int j = i; j < WAKE_WORD_MAX_MODELS; j++) {
+            wake_model_slot_t* other = &engine->models[j];
+            if (other->loaded && !done[j] && other->backend == backend &&
+                (j == i || batch)) {
+                handles[count] = other->handle;
+                members[count++] = j;
+                done[j] = true;
+            }
+        }
+
+        wake_error_t err;
+        if (backend->submit) {
+            err = submit_async(engine, backend, handles, members, count,
+                               view, timestamp_ms);
+        } else {
+            float confidences[WAKE_WORD_MAX_MODELS];
+            TickType_t start = xTaskGetTickCount();
+            err = (count > 1) ?
+                backend->infer_batch(handles, count, view, confidences) :
+                backend->infer(handles[0], view, &confidences[0]);
+            engine->inference_time_ms += (xTaskGetTickCount() - start) * portTICK_PERIOD_MS;
+            engine->inference_count++;
+
+            if (err == WAKE_OK) {
+                score_group(engine, members, handles, confidences, count,
+                            timestamp_ms);
+            }
+        }
+
+        if (err != WAKE_OK) {
+            result = err;
+        }
+    }
+
+    return result;
+}
+
+/* Core Functions */
+
+/* Create an engine from the heap or an arena */
+static wake_engine_t* engine_create(const wake_feature_config_t* feature_config,
+                                    voice_arena_t* arena) {
+    if (!feature_config) {
+        return NULL;
+    }
+
+    wake_engine_t* engine = arena ?
+        (wake_engine_t*)voice_arena_alloc(arena, sizeof(wake_engine_t)) :
+        (wake_engine_t*)pvPortMalloc(sizeof(wake_engine_t));
+    if (!engine) {
+        return NULL;
+    }
+    memset(engine, 0, sizeof(wake_engine_t));
+    engine->from_arena = (arena != NULL);
+
+    wake_error_t err;
+#if VOICE_STATIC_ALLOC
+    if (arena) {
+        err = wake_frontend_init_static(&engine->frontend, feature_config,
+                                        WAKE_WORD_WINDOW_MS, arena);
+    } else
+#endif
+    {
+        err = wake_frontend_init(&engine->frontend, feature_config,
+                                 WAKE_WORD_WINDOW_MS);
+    }
+    if (err != WAKE_OK) {
+        if (!arena) {
+            vPortFree(engine);
+        }
+        return NULL;
+    }
+
+    engine->backends[WAKE_MODEL_RAW_NN] = &nn_backend;
+    engine->pooling_window = WAKE_WORD_POOLING_SIZE;
+    engine->sensitivity = 0.5f;
+    engine->gate = WAKE_GATE_FULL;
+    engine->powered = true;
+    engine->stride_frames = WAKE_WORD_STRIDE_MS / feature_config->frame_stride_ms;
+    if (engine->stride_frames == 0) {
+        engine->stride_frames = 1;
+    }
+
+    return engine;
+}
+
+wake_engine_t* wake_engine_init(const wake_feature_config_t* feature_config) {
+    return engine_create(feature_config, NULL);
+}
+
+#if VOICE_STATIC_ALLOC
+wake_engine_t* wake_engine_init_static(const wake_feature_config_t* feature_config,
+                                       voice_arena_t* arena) {
+    if (!arena) {
+        return NULL;
+    }
+
+    wake_engine_t* engine = engine_create(feature_config, arena);
+    if (!engine) {
+        return NULL;
+    }
+
+    /* Async tensors and lock up front so nothing allocates later */
+    size_t window = (size_t)engine->frontend.window_frames * engine->frontend.dim;
+    for (int i = 0; i < WAKE_ASYNC_DEPTH; i++) {
+        engine->inflight[i].input =
+            (float*)voice_arena_alloc(arena, window * sizeof(float));
+        if (!engine->inflight[i].input) {
+            return NULL;
+        }
+    }
+    engine->async_lock = xSemaphoreCreateMutexStatic(&engine->async_lock_buffer);
+    return engine;
+}
+
+size_t wake_engine_required_size(const wake_feature_config_t* feature_config) {
+    size_t frontend = wake_frontend_required_size(feature_config, WAKE_WORD_WINDOW_MS);
+    if (frontend == 0) {
+        return 0;
+    }
+
+    uint32_t dim = (feature_config->num_coeffs + (feature_config->use_energy ? 1 : 0)) *
+                   (feature_config->use_deltas ? 2 : 1);
+    size_t window = (size_t)(WAKE_WORD_WINDOW_MS / feature_config->frame_stride_ms) * dim;
+
+    return VOICE_ARENA_SIZE(sizeof(wake_engine_t)) + frontend +
+           WAKE_ASYNC_DEPTH * VOICE_ARENA_SIZE(window * sizeof(float));
+}
+#endif
+
+void wake_engine_deinit(wake_engine_t* engine) {
+    if (!engine) return;
+
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        if (engine->models[i].loaded) {
+            release_model(&engine->models[i]);
+        }
+    }
+
+    if (engine->async_lock) {
+        vSemaphoreDelete(engine->async_lock);
+    }
+
+    wake_frontend_deinit(&engine->frontend);
+    if (engine->from_arena) {
+        return;
+    }
+
+    for (int i = 0; i < WAKE_ASYNC_DEPTH; i++) {
+        if (engine->inflight[i].input) {
+            vPortFree(engine->inflight[i].input);
+        }
+    }
+    vPortFree(engine);
+}
+
+wake_error_t wake_engine_load_model(wake_engine_t* engine,
+                                   const wake_model_info_t* model) {
+    if (!engine || !model || !model->name || !model->data || model->size == 0 ||
+        (unsigned)model->format >= FORMAT_COUNT) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (find_model(engine, model->name)) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (model->requires_npu && !engine->npu_enabled) {
+        return WAKE_ERR_NPU_INIT;
+    }
+
+    const wake_backend_t* backend = engine->backends[model->format];
+    if (!backend) {
+        return WAKE_ERR_INVALID_MODEL;
+    }
+
+    wake_error_t err = wake_validate_model(model->data, model->size, model->format);
+    if (err != WAKE_OK) {
+        return err;
+    }
+
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        wake_model_slot_t* slot = &engine->models[i];
+        if (slot->loaded) {
+            continue;
+        }
+
+        memset(slot, 0, sizeof(wake_model_slot_t));
+        err = backend->load(model, &slot->handle);
+        if (err != WAKE_OK) {
+            return err;
+        }
+
+        memcpy(&slot->info, model, sizeof(wake_model_info_t));
+        slot->backend = backend;
+        slot->threshold = model->threshold;
+        reset_bands(engine, slot);
+        slot->resident = true;
+        slot->loaded = true;
+        return WAKE_OK;
+    }
+
+    return WAKE_ERR_MEMORY;
+}
+
+wake_error_t wake_engine_load_model_mapped(wake_engine_t* engine,
+                                           const wake_model_info_t* model,
+                                           const wake_model_mapper_t* mapper) {
+    if (!engine || !model || !model->name || !mapper || !mapper->map ||
+        !mapper->unmap || (unsigned)model->format >= FORMAT_COUNT) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (find_model(engine, model->name)) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (model->requires_npu && !engine->npu_enabled) {
+        return WAKE_ERR_NPU_INIT;
+    }
+
+    const wake_backend_t* backend = engine->backends[model->format];
+    if (!backend) {
+        return WAKE_ERR_INVALID_MODEL;
+    }
+
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        wake_model_slot_t* slot = &engine->models[i];
+        if (slot->loaded) {
+            continue;
+        }
+
+        /* Storage is left untouched until the first inference */
+        memset(slot, 0, sizeof(wake_model_slot_t));
+        memcpy(&slot->info, model, sizeof(wake_model_info_t));
+        slot->info.data = NULL;
+        slot->info.size = 0;
+        slot->mapper = *mapper;
+        slot->backend = backend;
+        slot->threshold = model->threshold;
+        reset_bands(engine, slot);
+        slot->mapped = true;
+        slot->loaded = true;
+        return WAKE_OK;
+    }
+
+    return WAKE_ERR_MEMORY;
+}
+
+wake_error_t wake_engine_unload_model(wake_engine_t* engine,
+                                     const char* model_name) {
+    if (!engine || !model_name) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    wake_model_slot_t* slot = find_model(engine, model_name);
+    if (!slot) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (engine->async_lock) {
+        collect_completions(engine);
+    }
+
+    /* A backend may still be running the model's handle */
+    engine_lock(engine);
+    while (async_running(engine)) {
+        engine_unlock(engine);
+        vTaskDelay(1);
+        engine_lock(engine);
+    }
+    release_model(slot);
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_process(wake_engine_t* engine,
+                                const int16_t* audio_data,
+                                size_t num_samples,
+                                uint32_t timestamp_ms) {
+    if (!engine || !audio_data) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (engine->async_lock) {
+        collect_completions(engine);
+    }
+
+    if (engine->gate == WAKE_GATE_OFF) {
+        return WAKE_OK;
+    }
+
+    /* Only the frames this audio completes are computed */
+    engine->frames_pending += wake_frontend_push(&engine->frontend,
+                                                 audio_data, num_samples);
+
+    if (engine->gate != WAKE_GATE_FULL ||
+        engine->frames_pending < engine->stride_frames) {
+        return WAKE_OK;
+    }
+    engine->frames_pending = 0;
+
+    wake_feature_view_t view;
+    if (!wake_frontend_window(&engine->frontend, &view)) {
+        return WAKE_OK;
+    }
+
+    return run_inference(engine, &view, timestamp_ms);
+}
+
+uint32_t wake_engine_new_features(const wake_engine_t* engine,
+                                  uint32_t* position,
+                                  wake_feature_view_t* view) {
+    if (!engine || !position || !view) {
+        return 0;
+    }
+
+    uint32_t total = engine->frontend.frames_total;
+    uint32_t fresh = total - *position;
+    if (fresh > total) {
+        /* Reset since the last call */
+        fresh = total;
+    }
+    *position = total;
+
+    uint32_t held = wake_frontend_recent(&engine->frontend, fresh, view);
+    return fresh - held;
+}
+
+bool wake_engine_get_detection(wake_engine_t* engine,
+                              wake_detection_t* detection) {
+    if (!engine || !detection) {
+        return false;
+    }
+
+    engine_lock(engine);
+    bool detected = engine->has_detection;
+    if (detected) {
+        memcpy(detection, &engine->detection, sizeof(wake_detection_t));
+        engine->has_detection = false;
+    }
+    engine_unlock(engine);
+    return detected;
+}
+
+wake_error_t wake_engine_register_callback(wake_engine_t* engine,
+                                          wake_detection_callback_t callback,
+                                          void* user_data) {
+    if (!engine) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    engine->callback = callback;
+    engine->callback_data = user_data;
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_set_backend(wake_engine_t* engine,
+                                    wake_model_format_t format,
+                                    const wake_backend_t* backend) {
+    if (!engine || (unsigned)format >= FORMAT_COUNT ||
+        (backend && (!backend->load || !backend->unload || !backend->infer))) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (backend && backend->submit) {
+        wake_error_t err = ensure_async(engine);
+        if (err != WAKE_OK) {
+            return err;
+        }
+    }
+
+    engine_lock(engine);
+    engine->backends[format] = backend;
+    if (backend && backend->set_power && !engine->powered) {
+        backend->set_power(false);
+    }
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_complete(wake_engine_t* engine,
+                                  uint32_t ticket,
+                                  wake_error_t status) {
+    if (!engine || ticket >= WAKE_ASYNC_DEPTH) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    /* No lock and no scoring here: this may be an ISR. The ticket was
+     * marked busy before it reached the backend. */
+    wake_inflight_t* job = &engine->inflight[ticket];
+    if (atomic_load_explicit(&job->done, memory_order_relaxed)) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+    job->status = status;
+    job->done_tick = xTaskGetTickCountFromISR();
+    atomic_store_explicit(&job->done, true, memory_order_release);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_bind_scratch(wake_engine_t* engine,
+                                     float* fft_buffer, size_t fft_len,
+                                     float* mel_energies, size_t mel_len,
+                                     float* mfcc, size_t mfcc_len) {
+    if (!engine) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    return wake_frontend_bind_scratch(&engine->frontend, fft_buffer, fft_len,
+                                      mel_energies, mel_len, mfcc, mfcc_len);
+}
+
+/* Configuration Functions */
+
+wake_error_t wake_engine_set_threshold(wake_engine_t* engine,
+                                      const char* model_name,
+                                      float threshold) {
+    if (!engine || threshold < 0.0f || threshold > 1.0f) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    wake_model_slot_t* slot = find_model(engine, model_name);
+    if (!slot) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    engine_lock(engine);
+    slot->threshold = threshold;
+    for (int b = 0; b < WAKE_TUNE_BANDS; b++) {
+        if (!slot->bands[b].learned) {
+            slot->bands[b].threshold = threshold;
+        }
+    }
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_set_npu_enabled(wake_engine_t* engine, bool enable) {
+    if (!engine) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    engine->npu_enabled = enable;
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_set_gate(wake_engine_t* engine, wake_gate_t gate) {
+    if (!engine || (unsigned)gate > WAKE_GATE_FULL) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (engine->async_lock) {
+        collect_completions(engine);
+    }
+
+    engine_lock(engine);
+    engine->gate = gate;
+    update_power(engine);
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_set_pooling(wake_engine_t* engine,
+                                    uint32_t window_size) {
+    if (!engine || window_size == 0 || window_size > WAKE_WORD_POOLING_SIZE) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    engine_lock(engine);
+    engine->pooling_window = window_size;
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        clear_pool(&engine->models[i]);
+    }
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_set_tuning(wake_engine_t* engine,
+                                   const wake_tuning_config_t* config) {
+    if (!engine) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+    if (config && (config->false_accepts_per_hour <= 0.0f ||
+                   config->min_threshold < 0.0f ||
+                   config->min_threshold > config->max_threshold ||
+                   config->max_threshold > 1.0f ||
+                   config->min_pooling == 0 ||
+                   config->min_pooling > WAKE_WORD_POOLING_SIZE ||
+                   config->skip_margin < 0.0f)) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    engine_lock(engine);
+    engine->tuning = (config != NULL);
+    if (config) {
+        engine->tuning_config = *config;
+    }
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        if (engine->models[i].loaded) {
+            reset_bands(engine, &engine->models[i]);
+        }
+    }
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_set_noise_floor(wake_engine_t* engine, float noise_floor_db) {
+    if (!engine) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    engine_lock(engine);
+    engine->noise_floor_db = noise_floor_db;
+
+    /* Move only once the floor is clearly past the band's edges */
+    float low = WAKE_TUNE_BAND_FLOOR_DB + (engine->band - 1) * WAKE_TUNE_BAND_DB;
+    float high = low + WAKE_TUNE_BAND_DB;
+    bool below = engine->band > 0 && noise_floor_db < low - WAKE_TUNE_HYSTERESIS_DB;
+    bool above = engine->band < WAKE_TUNE_BANDS - 1 &&
+                 noise_floor_db > high + WAKE_TUNE_HYSTERESIS_DB;
+    if (below || above) {
+        int band = (int)floorf((noise_floor_db - WAKE_TUNE_BAND_FLOOR_DB) / WAKE_TUNE_BAND_DB) + 1;
+        if (band < 0) {
+            band = 0;
+        } else if (band > WAKE_TUNE_BANDS - 1) {
+            band = WAKE_TUNE_BANDS - 1;
+        }
+
+        /* What was seen so far belongs to the band it was seen in */
+        for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+            wake_model_slot_t* slot = &engine->models[i];
+            if (slot->loaded && engine->tuning) {
+                learn_pending(engine, slot, engine->band);
+            }
+        }
+        engine->band = (uint8_t)band;
+    }
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_set_sensitivity(wake_engine_t* engine, float sensitivity) {
+    if (!engine || sensitivity < 0.0f || sensitivity > 1.0f) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    engine_lock(engine);
+    engine->sensitivity = sensitivity;
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_report_false_accept(wake_engine_t* engine, uint8_t model_index) {
+    if (!engine || model_index >= WAKE_WORD_MAX_MODELS ||
+        !engine->models[model_index].loaded) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    engine_lock(engine);
+    wake_model_slot_t* slot = &engine->models[model_index];
+    engine->false_accepts++;
+    if (engine->tuning) {
+        for (uint32_t i = 0; i < slot->held_count; i++) {
+            learn_confidence(engine, &slot->bands[slot->held_band], slot->held[i]);
+        }
+    }
+    slot->held_count = 0;
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_get_tuning_stats(const wake_engine_t* engine,
+                                         wake_tuning_stats_t* stats) {
+    if (!engine || !stats) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    memset(stats, 0, sizeof(wake_tuning_stats_t));
+    stats->enabled = engine->tuning;
+    stats->band = engine->band;
+    stats->noise_floor_db = engine->noise_floor_db;
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        const wake_model_slot_t* slot = &engine->models[i];
+        if (!slot->loaded) {
+            continue;
+        }
+        const wake_tune_band_t* band = &slot->bands[engine->band];
+        stats->threshold[i] = engine->tuning ? band->threshold : slot->threshold;
+        stats->pooling[i] = engine->tuning ? band->window : engine->pooling_window;
+        stats->windows[i] = band->total;
+    }
+    stats->retunes = engine->retunes;
+    stats->skipped = engine->skipped;
+    stats->false_accepts = engine->false_accepts;
+    return WAKE_OK;
+}
+
+/* Utility Functions */
+
+wake_error_t wake_engine_get_stats(const wake_engine_t* engine,
+                                  float* avg_latency_ms,
+                                  float* npu_usage) {
+    if (!engine) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    if (avg_latency_ms) {
+        *avg_latency_ms = engine->inference_count ?
+            (float)engine->inference_time_ms / engine->inference_count : 0.0f;
+    }
+    if (npu_usage) {
+        wake_pipeline_stats_t stats;
+        wake_engine_get_pipeline_stats(engine, &stats);
+        *npu_usage = stats.npu_occupancy;
+    }
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_get_pipeline_stats(const wake_engine_t* engine,
+                                            wake_pipeline_stats_t* stats) {
+    if (!engine || !stats) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    TickType_t busy = engine->busy_ticks;
+    if (engine->in_flight > 0) {
+        busy += now - engine->busy_since;
+    }
+    TickType_t elapsed = now - engine->first_submit;
+
+    stats->queue_depth = engine->in_flight;
+    stats->max_queue_depth = engine->max_in_flight;
+    stats->submitted = engine->submitted;
+    stats->completed = engine->completed;
+    stats->dropped = engine->dropped;
+    stats->failed = engine->failed;
+    stats->npu_occupancy = (engine->submitted && elapsed) ?
+        100.0f * busy / elapsed : 0.0f;
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_reset(wake_engine_t* engine) {
+    if (!engine) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    wake_frontend_reset(&engine->frontend);
+    engine->frames_pending = 0;
+
+    engine_lock(engine);
+    engine->has_detection = false;
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        clear_pool(&engine->models[i]);
+        engine->models[i].pending_count = 0;
+        engine->models[i].cold = false;
+    }
+    engine_unlock(engine);
+    return WAKE_OK;
+}
+
+wake_error_t wake_engine_get_models(const wake_engine_t* engine,
+                                   const char** names,
+                                   size_t max_names,
+                                   size_t* num_models) {
+    if (!engine || !num_models || (!names && max_names > 0)) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    size_t count = 0;
+    for (int i = 0; i < WAKE_WORD_MAX_MODELS; i++) {
+        if (!engine->models[i].loaded) {
+            continue;
+        }
+        if (count < max_names) {
+            names[count] = engine->models[i].info.name;
+        }
+        count++;
+    }
+
+    *num_models = count;
+    return WAKE_OK;
+}
+
+/* Feature Extraction */
+
+wake_feature_config_t wake_get_default_feature_config(void) {
+    wake_feature_config_t config = {
+        .sample_rate = 16000,
+        .frame_size_ms = 25,
+        .frame_stride_ms = 10,
+        .num_filters = 40,
+        .num_coeffs = 13,
+        .pre_emphasis = 0.97f,
+        .use_energy = true,
+        .use_deltas = false
+    };
+    return config;
+}
+
+wake_tuning_config_t wake_get_default_tuning_config(void) {
+    wake_tuning_config_t config = {
+        .false_accepts_per_hour = 0.5f,
+        .min_threshold = 0.3f,
+        .max_threshold = 0.95f,
+        .min_pooling = 4,
+        .skip_margin = 0.3f
+    };
+    return config;
+}
+
+/* Model Management */
+
+wake_error_t wake_validate_model(const uint8_t* model_data,
+                                size_t model_size,
+                                wake_model_format_t format) {
+    if (!model_data || model_size == 0) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    switch (format) {
+        case WAKE_MODEL_RAW_NN: {
+            nn_model_t model;
+            return nn_parse(model_data, model_size, &model, NULL);
+        }
+
+        case WAKE_MODEL_TFLITE:
+            /* FlatBuffer file identifier */
+            return (model_size >= 8 && memcmp(model_data + 4, "TFL3", 4) == 0) ?
+                   WAKE_OK : WAKE_ERR_INVALID_MODEL;
+
+        case WAKE_MODEL_ONNX:
+            /* ModelProto starts with ir_version (field 1, varint) */
+            return (model_data[0] == 0x08) ? WAKE_OK : WAKE_ERR_INVALID_MODEL;
+
+        case WAKE_MODEL_HAILO_HEF:
+            /* Container is opaque; HailoRT validates on configure */
+            return WAKE_OK;
+
+        default:
+            return WAKE_ERR_INVALID_MODEL;
+    }
+}
+
+#ifdef __linux__
+static wake_error_t file_map(void* source, const uint8_t** data, size_t* size) {
+    int fd = open((const char*)source, O_RDONLY);
+    if (fd < 0) {
+        return WAKE_ERR_INVALID_MODEL;
+    }
+
+    struct stat st;
+    void* addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        return WAKE_ERR_INVALID_MODEL;
+    }
+
+    *data = (const uint8_t*)addr;
+    *size = (size_t)st.st_size;
+    return WAKE_OK;
+}
+
+static void file_unmap(void* source, const uint8_t* data, size_t size) {
+    (void)source;
+    munmap((void*)data, size);
+}
+
+wake_model_mapper_t wake_file_mapper(const char* path) {
+    wake_model_mapper_t mapper = {
+        .map = file_map,
+        .unmap = file_unmap,
+        .source = (void*)path
+    };
+    return mapper;
+}
+#endif
+
+wake_error_t wake_get_model_metadata(const uint8_t* model_data,
+                                    size_t model_size,
+                                    wake_model_format_t format,
+                                    char* metadata,
+                                    size_t metadata_size) {
+    if (!metadata || metadata_size == 0) {
+        return WAKE_ERR_INVALID_PARAM;
+    }
+
+    wake_error_t err = wake_validate_model(model_data, model_size, format);
+    if (err != WAKE_OK) {
+        return err;
+    }
+
+    if (format == WAKE_MODEL_RAW_NN) {
+        nn_model_t model;
+        nn_parse(model_data, model_size, &model, NULL);
+        snprintf(metadata, metadata_size,
+                 "format=raw_nn version=%u layers=%u frames=%u dim=%u size=%u",
+                 WAKE_NN_VERSION, model.num_layers, model.input_frames,
+                 model.input_dim, (unsigned)model_size);
+    } else {
+        snprintf(metadata, metadata_size, "format=%s size=%u",
+                 format_names[format], (unsigned)model_size);
+    }
+
+    return WAKE_OK;
+}
@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include "voice_arena.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +24,16 @@ extern "C" {
 #define WAKE_WORD_FEATURE_DIM       40      // MFCC feature dimension
 #define WAKE_WORD_MAX_MODELS        4       // Maximum simultaneous models
 #define WAKE_WORD_POOLING_SIZE      8       // Inference result pooling
+#define WAKE_ASYNC_DEPTH            2       // Windows in flight on the NPU
+
+/* Threshold auto-tuning */
+#define WAKE_TUNE_BINS              32      // Confidence histogram bins over 0-1
+#define WAKE_TUNE_BANDS             4       // Noise floor bands tuned apart
+#define WAKE_TUNE_BAND_FLOOR_DB     -70.0f  // Lower edge of the second band
+#define WAKE_TUNE_BAND_DB           10.0f   // Band width
+#define WAKE_TUNE_HYSTERESIS_DB     2.0f    // Floor movement past an edge before a switch
+#define WAKE_TUNE_MIN_WINDOWS       3000    // Windows a band learns first (5 min of inference)
+#define WAKE_TUNE_MAX_WINDOWS       (1u << 20) // Counts halve beyond this
 
 /* Error codes */
 typedef enum {
@@ -42,6 +53,13 @@ typedef enum {
     WAKE_MODEL_RAW_NN
 } wake_model_format_t;
 
+/* Processing tiers (see wake_engine_set_gate) */
+typedef enum {
+    WAKE_GATE_OFF = 0,          // Audio ignored, accelerators powered down
+    WAKE_GATE_FEATURES,         // Feature front-end only
+    WAKE_GATE_FULL              // Features and inference (default)
+} wake_gate_t;
+
 /* Detection result */
 typedef struct {
     const char* wake_word;      // Detected wake word
@@ -49,6 +67,7 @@ typedef struct {
     uint32_t timestamp_ms;      // Detection timestamp
     uint32_t start_offset_ms;   // Start offset in audio buffer
     uint32_t end_offset_ms;     // End offset in audio buffer
+    uint8_t model_index;        // Detecting model (load order)
 } wake_detection_t;
 
 /* Model information */
@@ -61,6 +80,13 @@ typedef struct {
     bool requires_npu;          // Requires NPU acceleration
 } wake_model_info_t;
 
+/* Model storage mapped on demand (XIP flash partition, mmap'd file) */
+typedef struct {
+    wake_error_t (*map)(void* source, const uint8_t** data, size_t* size);
+    void (*unmap)(void* source, const uint8_t* data, size_t size);
+    void* source;               // Partition or file handle
+} wake_model_mapper_t;
+
 /* Feature extraction config */
 typedef struct {
     uint32_t sample_rate;       // Input sample rate
@@ -73,9 +99,89 @@ typedef struct {
     bool use_deltas;            // Include delta features
 } wake_feature_config_t;
 
+/* Strided view of a feature window (frame-major, oldest first) */
+typedef struct {
+    const float* data;          // First value of the oldest frame
+    uint32_t frames;            // Frames in the window
+    uint32_t dim;               // Values per frame
+    uint32_t stride;            // Floats between consecutive frames
+} wake_feature_view_t;
+
 /* Wake word engine handle */
 typedef struct wake_engine wake_engine_t;
 
+/* Inference backend for one model format */
+typedef struct {
+    wake_error_t (*load)(const wake_model_info_t* model, void** handle);
+    void (*unload)(void* handle);
+    wake_error_t (*infer)(void* handle, const wake_feature_view_t* input,
+                          float* confidence);
+    /* Optional: run several models on the same input in one call */
+    wake_error_t (*infer_batch)(void* const* handles, size_t count,
+                                const wake_feature_view_t* input,
+                                float* confidences);
+    /* Optional: queue inference and return immediately; the backend
+     * fills confidences and then calls wake_engine_complete(), from any
+     * context */
+    wake_error_t (*submit)(wake_engine_t* engine, void* const* handles,
+                           size_t count, const wake_feature_view_t* input,
+                           float* confidences, uint32_t ticket);
+    /* Optional: power the accelerator up or down as the engine gates */
+    void (*set_power)(bool powered);
+} wake_backend_t;
+
+/* Threshold auto-tuning (see wake_engine_set_tuning) */
+typedef struct {
+    float false_accepts_per_hour; // Target at sensitivity 0.5
+    float min_threshold;        // Tuned thresholds stay within min-max
+    float max_threshold;
+    uint32_t min_pooling;       // Shortest pooling window (longest is WAKE_WORD_POOLING_SIZE)
+    float skip_margin;          // Pooled confidence this far below threshold skips a stride
+} wake_tuning_config_t;
+
+/* Threshold auto-tuning state, per model in load order */
+typedef struct {
+    bool enabled;
+    uint8_t band;               // Noise band in effect
+    float noise_floor_db;       // Floor it was chosen by
+    float threshold[WAKE_WORD_MAX_MODELS]; // In effect
+    uint32_t pooling[WAKE_WORD_MAX_MODELS]; // In effect
+    uint32_t windows[WAKE_WORD_MAX_MODELS]; // Background windows the band holds
+    uint32_t retunes;           // Threshold or pooling changes
+    uint32_t skipped;           // Inferences skipped on cold models
+    uint32_t false_accepts;     // Reported with wake_engine_report_false_accept()
+} wake_tuning_stats_t;
+
+/* Asynchronous pipeline statistics */
+typedef struct {
+    uint32_t queue_depth;       // Windows currently in flight
+    uint32_t max_queue_depth;   // In-flight high-water mark
+    uint32_t submitted;         // Windows submitted
+    uint32_t completed;         // Windows completed
+    uint32_t dropped;           // Windows skipped with every slot busy
+    uint32_t failed;            // Windows the backend refused to queue
+    float npu_occupancy;        // Percent of time with work in flight
+} wake_pipeline_stats_t;
+
+/*
+ * WAKE_MODEL_RAW_NN layout (little-endian, 4-byte aligned):
+ *   uint32 magic 'WWNN', uint16 version (1), uint16 num_layers,
+ *   uint16 input_frames, uint16 input_dim
+ * then per dense layer:
+ *   uint16 inputs, uint16 outputs, uint8 activation (wake_nn_act_t),
+ *   uint8 reserved[3], float weights[outputs][inputs], float bias[outputs]
+ * The first layer reads the latest input_frames x input_dim features;
+ * the last layer has one output, the detection confidence.
+ */
+#define WAKE_NN_MAGIC               0x4E4E5757u
+#define WAKE_NN_VERSION             1
+
+typedef enum {
+    WAKE_NN_ACT_LINEAR = 0,
+    WAKE_NN_ACT_RELU,
+    WAKE_NN_ACT_SIGMOID
+} wake_nn_act_t;
+
 /* Callback for detection events */
 typedef void (*wake_detection_callback_t)(const wake_detection_t* detection, 
                                          void* user_data);
@@ -89,6 +195,27 @@ typedef void (*wake_detection_callback_t)(const wake_detection_t* detection,
  */
 wake_engine_t* wake_engine_init(const wake_feature_config_t* feature_config);
 
+#if VOICE_STATIC_ALLOC
+/**
+ * @brief Initialize an engine with all memory carved from an arena
+ * @param feature_config Feature extraction configuration
+ * @param arena Arena with wake_engine_required_size() bytes free
+ * @return Engine handle or NULL on error
+ *
+ * Async input tensors are reserved up front. Model backends still
+ * allocate their own state on load.
+ */
+wake_engine_t* wake_engine_init_static(const wake_feature_config_t* feature_config,
+                                       voice_arena_t* arena);
+
+/**
+ * @brief Arena bytes needed by wake_engine_init_static()
+ * @param feature_config Feature extraction configuration
+ * @return Size in bytes, or 0 for an invalid configuration
+ */
+size_t wake_engine_required_size(const wake_feature_config_t* feature_config);
+#endif
+
 /**
  * @brief Deinitialize wake word engine
  * @param engine Engine handle
@@ -104,11 +231,30 @@ void wake_engine_deinit(wake_engine_t* engine);
 wake_error_t wake_engine_load_model(wake_engine_t* engine, 
                                    const wake_model_info_t* model);
 
+/**
+ * @brief Load a wake word model mapped in place from storage
+ * @param engine Engine handle
+ * @param model Model information (data and size are ignored)
+ * @param mapper Storage mapper
+ * @return WAKE_OK or error code
+ *
+ * The model is registered without touching its storage. On the first
+ * inference it is mapped, validated in place and handed to the
+ * backend, which reads the weights from the mapping; nothing is copied
+ * to RAM. A model that fails to map or validate is unloaded.
+ */
+wake_error_t wake_engine_load_model_mapped(wake_engine_t* engine,
+                                           const wake_model_info_t* model,
+                                           const wake_model_mapper_t* mapper);
+
 /**
  * @brief Unload wake word model
  * @param engine Engine handle
  * @param model_name Name of model to unload
  * @return WAKE_OK or error code
+ *
+ * Waits for windows still queued on an async backend before the
+ * model's handle is released.
  */
 wake_error_t wake_engine_unload_model(wake_engine_t* engine, 
                                      const char* model_name);
@@ -120,12 +266,34 @@ wake_error_t wake_engine_unload_model(wake_engine_t* engine,
  * @param num_samples Number of samples
  * @param timestamp_ms Current timestamp
  * @return WAKE_OK or error code
+ *
+ * Only the feature frames completed by this audio are computed; the
+ * rolling window is handed to the models as a strided view every
+ * WAKE_WORD_STRIDE_MS. Features are shared by all loaded models, and
+ * models on a backend with infer_batch run in a single call. Backends
+ * with submit are not waited on: the window is copied into one of
+ * WAKE_ASYNC_DEPTH input tensors and feature extraction carries on.
  */
 wake_error_t wake_engine_process(wake_engine_t* engine,
                                 const int16_t* audio_data,
                                 size_t num_samples,
                                 uint32_t timestamp_ms);
 
+/**
+ * @brief Get the feature frames computed since a previous call
+ * @param engine Engine handle
+ * @param position Frames already taken; advanced past the returned ones
+ * @param view Output view of the new frames (oldest first)
+ * @return Frames computed since *position that fell out of the window
+ *
+ * At most one detection window is returned, and after a reset the count
+ * restarts at the engine's first frame. Call from the task that runs
+ * wake_engine_process().
+ */
+uint32_t wake_engine_new_features(const wake_engine_t* engine,
+                                  uint32_t* position,
+                                  wake_feature_view_t* view);
+
 /**
  * @brief Check if wake word was detected
  * @param engine Engine handle
@@ -146,6 +314,56 @@ wake_error_t wake_engine_register_callback(wake_engine_t* engine,
                                           wake_detection_callback_t callback,
                                           void* user_data);
 
+/**
+ * @brief Install an inference backend for a model format
+ * @param engine Engine handle
+ * @param format Model format handled by the backend
+ * @param backend Backend operations (NULL to remove)
+ * @return WAKE_OK or error code
+ *
+ * WAKE_MODEL_RAW_NN has a built-in backend; other formats need a
+ * platform backend (TFLite Micro, ONNX runtime, HailoRT) before
+ * models of that format can be loaded. Accelerator backends should
+ * provide infer_batch so simultaneous keywords cost one dispatch.
+ */
+wake_error_t wake_engine_set_backend(wake_engine_t* engine,
+                                    wake_model_format_t format,
+                                    const wake_backend_t* backend);
+
+/**
+ * @brief Run the feature front-end on caller-owned scratch buffers
+ * @param engine Engine handle
+ * @param fft_buffer FFT work buffer
+ * @param fft_len Length of fft_buffer in floats
+ * @param mel_energies Mel filter output buffer
+ * @param mel_len Length of mel_energies in floats
+ * @param mfcc Cepstral output buffer
+ * @param mfcc_len Length of mfcc in floats
+ * @return WAKE_OK or error code
+ */
+wake_error_t wake_engine_bind_scratch(wake_engine_t* engine,
+                                     float* fft_buffer, size_t fft_len,
+                                     float* mel_energies, size_t mel_len,
+                                     float* mfcc, size_t mfcc_len);
+
+/**
+ * @brief Complete an asynchronous inference
+ * @param engine Engine handle
+ * @param ticket Ticket passed to the backend's submit
+ * @param status Inference result
+ * @return WAKE_OK or error code
+ *
+ * Called by the backend once the confidences for the ticket are
+ * written, from any context including an ISR: it only marks the ticket
+ * done, without locking. The engine's task scores the results at its
+ * next wake_engine_process() or wake_engine_set_gate() call and delivers
+ * detections through the detection callback from there. Returns
+ * WAKE_ERR_INVALID_PARAM for a ticket already completed.
+ */
+wake_error_t wake_engine_complete(wake_engine_t* engine,
+                                  uint32_t ticket,
+                                  wake_error_t status);
+
 /* Configuration Functions */
 
 /**
@@ -167,6 +385,20 @@ wake_error_t wake_engine_set_threshold(wake_engine_t* engine,
  */
 wake_error_t wake_engine_set_npu_enabled(wake_engine_t* engine, bool enable);
 
+/**
+ * @brief Select how much of the engine runs on incoming audio
+ * @param engine Engine handle
+ * @param gate Processing tier
+ * @return WAKE_OK or error code
+ *
+ * Below WAKE_GATE_FULL no inference is started and backends with
+ * set_power are powered down once their in-flight windows complete.
+ * They are powered up again before the next inference. Under
+ * WAKE_GATE_FEATURES the rolling window stays current, so inference
+ * can resume on the following stride.
+ */
+wake_error_t wake_engine_set_gate(wake_engine_t* engine, wake_gate_t gate);
+
 /**
  * @brief Set detection pooling window
  * @param engine Engine handle
@@ -176,6 +408,72 @@ wake_error_t wake_engine_set_npu_enabled(wake_engine_t* engine, bool enable);
 wake_error_t wake_engine_set_pooling(wake_engine_t* engine, 
                                     uint32_t window_size);
 
+/**
+ * @brief Tune thresholds and pooling at runtime to hold a false-accept rate
+ * @param engine Engine handle
+ * @param config Tuning configuration, NULL to return to the static settings
+ * @return WAKE_OK or error code
+ *
+ * Every model keeps a histogram of its pooled confidences per noise
+ * band (see wake_engine_set_noise_floor). Once a band has seen
+ * WAKE_TUNE_MIN_WINDOWS windows, its threshold is set just above the
+ * confidences that would exceed the target rate, within min-max. A
+ * band that needs more than max_threshold pools one window longer; one
+ * with room below min_threshold pools one shorter, down to min_pooling.
+ * Either change restarts the band's histogram, and changing the window
+ * in effect clears the model's pool.
+ *
+ * Windows are counted as inference runs them, one per stride, so a
+ * gated engine or a false accept spanning several windows makes the
+ * estimate err high. The windows behind a detection are held back
+ * until wake_engine_report_false_accept() says it was false; otherwise
+ * a real wake word would raise the threshold against itself.
+ *
+ * A model whose pooled confidence is more than skip_margin below its
+ * threshold sits out the next stride, so it is evaluated at most every
+ * other stride until it warms up.
+ */
+wake_error_t wake_engine_set_tuning(wake_engine_t* engine,
+                                   const wake_tuning_config_t* config);
+
+/**
+ * @brief Set the noise floor that picks the tuning band
+ * @param engine Engine handle
+ * @param noise_floor_db Current noise floor estimate in dB
+ * @return WAKE_OK or error code
+ */
+wake_error_t wake_engine_set_noise_floor(wake_engine_t* engine, float noise_floor_db);
+
+/**
+ * @brief Scale the tuning target
+ * @param engine Engine handle
+ * @param sensitivity 0.0-1.0; each 0.25 above 0.5 doubles the false-accept
+ *        target, each 0.25 below halves it
+ * @return WAKE_OK or error code
+ */
+wake_error_t wake_engine_set_sensitivity(wake_engine_t* engine, float sensitivity);
+
+/**
+ * @brief Report that the last detection of a model was a false accept
+ * @param engine Engine handle
+ * @param model_index wake_detection_t.model_index of the detection
+ * @return WAKE_OK or error code
+ *
+ * The windows held back at the detection join the histogram of the
+ * band they were seen in. Only the latest detection of each model can
+ * be reported, once.
+ */
+wake_error_t wake_engine_report_false_accept(wake_engine_t* engine, uint8_t model_index);
+
+/**
+ * @brief Get threshold auto-tuning state
+ * @param engine Engine handle
+ * @param stats Output state
+ * @return WAKE_OK or error code
+ */
+wake_error_t wake_engine_get_tuning_stats(const wake_engine_t* engine,
+                                         wake_tuning_stats_t* stats);
+
 /* Utility Functions */
 
 /**
@@ -189,6 +487,15 @@ wake_error_t wake_engine_get_stats(const wake_engine_t* engine,
                                   float* avg_latency_ms,
                                   float* npu_usage);
 
+/**
+ * @brief Get asynchronous pipeline statistics
+ * @param engine Engine handle
+ * @param stats Output statistics
+ * @return WAKE_OK or error code
+ */
+wake_error_t wake_engine_get_pipeline_stats(const wake_engine_t* engine,
+                                            wake_pipeline_stats_t* stats);
+
 /**
  * @brief Reset detection state
  * @param engine Engine handle
@@ -232,6 +539,12 @@ wake_error_t wake_extract_mfcc(const int16_t* audio,
  */
 wake_feature_config_t wake_get_default_feature_config(void);
 
+/**
+ * @brief Create default tuning configuration
+ * @return Default tuning configuration
+ */
+wake_tuning_config_t wake_get_default_tuning_config(void);
+
 /* Model Management */
 
 /**
@@ -245,6 +558,15 @@ wake_error_t wake_validate_model(const uint8_t* model_data,
                                 size_t model_size,
                                 wake_model_format_t format);
 
+#ifdef __linux__
+/**
+ * @brief Mapper for a model file on a Linux host (read-only mmap)
+ * @param path Model file path (must outlive the mapping)
+ * @return Mapper for wake_engine_load_model_mapped()
+ */
+wake_model_mapper_t wake_file_mapper(const char* path);
+#endif
+
 /**
  * @brief Get model metadata
  * @param model_data Model data
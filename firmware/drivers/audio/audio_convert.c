@@ -0,0 +1,484 @@
+/**
+ * @file audio_convert.c
+ * @brief W.I.T. Audio Format Conversion Kernels
+ *
+ * Every format pair has its own kernel. Loads bring samples to Q31 full
+ * scale, the plan's DC offset and gain are applied there, and stores
+ * narrow or widen to the destination, all in the one pass.
+ */
+
+#include "audio_driver.h"
+#include <string.h>
+#include <math.h>
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#define AUDIO_CONVERT_HELIUM    1
+#endif
+
+/* Kernel bodies are inlined into every format pair so loads and stores
+ * fold into the loop */
+#if defined(__GNUC__)
+#define AUDIO_CONVERT_INLINE    static inline __attribute__((always_inline))
+#else
+#define AUDIO_CONVERT_INLINE    static inline
+#endif
+
+/* Internal Constants */
+#define Q31_SCALE               2147483648.0f   // 2^31
+#define UNITY_MANTISSA          (1 << 30)       // 0.5 in Q31
+#define UNITY_SHIFT             1               // 0.5 * 2^1 = 1
+#define MAX_GAIN_SHIFT          31
+#define MAX_GAIN_DB             186.0f          // Beyond MAX_GAIN_SHIFT either way
+#define AUDIO_FORMAT_COUNT      (AUDIO_FORMAT_F32_LE + 1)
+
+typedef void (*convert_kernel_t)(const audio_convert_plan_t* plan, const void* src,
+                                 void* const* dst, size_t samples_per_channel);
+
+static inline int32_t saturate_q31(int64_t x) {
+    if (x > INT32_MAX) return INT32_MAX;
+    if (x < INT32_MIN) return INT32_MIN;
+    return (int32_t)x;
+}
+
+/* Loads: sample i of the source to Q31 */
+AUDIO_CONVERT_INLINE int32_t load_s16(const void* src, size_t i) {
+    return (int32_t)((uint32_t)(int32_t)((const int16_t*)src)[i] << 16);
+}
+
+AUDIO_CONVERT_INLINE int32_t load_s24(const void* src, size_t i) {
+    /* The top byte of the container is ignored */
+    return (int32_t)(((const uint32_t*)src)[i] << 8);
+}
+
+AUDIO_CONVERT_INLINE int32_t load_s32(const void* src, size_t i) {
+    return ((const int32_t*)src)[i];
+}
+
+AUDIO_CONVERT_INLINE int32_t load_f32(const void* src, size_t i) {
+    float x = ((const float*)src)[i] * Q31_SCALE;
+    if (x >= Q31_SCALE) return INT32_MAX;
+    if (x <= -Q31_SCALE) return INT32_MIN;
+    if (x != x) return 0;
+    return (int32_t)x;
+}
+
+/* Stores: Q31 to sample i of the destination */
+AUDIO_CONVERT_INLINE void store_s16(void* dst, size_t i, int32_t q31) {
+    ((int16_t*)dst)[i] = (int16_t)(q31 >> 16);
+}
+
+AUDIO_CONVERT_INLINE void store_s24(void* dst, size_t i, int32_t q31) {
+    ((int32_t*)dst)[i] = q31 >> 8;
+}
+
+AUDIO_CONVERT_INLINE void store_s32(void* dst, size_t i, int32_t q31) {
+    ((int32_t*)dst)[i] = q31;
+}
+
+AUDIO_CONVERT_INLINE void store_f32(void* dst, size_t i, int32_t q31) {
+    ((float*)dst)[i] = (float)q31 * (1.0f / Q31_SCALE);
+}
+
+/* DC offset, then gain, saturating; the same steps as the vector
+ * path's vqsub, vqdmulh and vqshl, so both give identical bits */
+AUDIO_CONVERT_INLINE int32_t condition(const audio_convert_plan_t* plan,
+                                       uint8_t ch, int32_t x) {
+    int64_t t = saturate_q31((int64_t)x - plan->dc_offset[ch]);
+    int64_t m = (t * plan->gain_mantissa[ch]) >> 31;
+    int32_t shift = plan->gain_shift[ch];
+
+    return (shift >= 0) ? saturate_q31(m << shift) : (int32_t)(m >> -shift);
+}
+
+#if defined(AUDIO_CONVERT_HELIUM)
+/* Helium: each vector is four adjacent channels of one frame, so the
+ * plan's per-channel arrays load straight into lanes */
+#define HELIUM_FRAMES_TO_S16(load) \
+    for (size_t i = 0; i < samples_per_channel; i++) { \
+        for (uint8_t c = 0; c < channels; c += 4) { \
+            size_t k = i * channels + c; \
+            int32x4_t x = (load); \
+            x = vqsubq_s32(x, vld1q_s32(&plan->dc_offset[c])); \
+            x = vqdmulhq_s32(x, vld1q_s32(&plan->gain_mantissa[c])); \
+            x = vqshlq_s32(x, vld1q_s32(&plan->gain_shift[c])); \
+            vstrhq_s32(&out[k], vshrq_n_s32(x, 16)); \
+        } \
+    }
+
+static void frames_to_s16_helium(const audio_convert_plan_t* plan, const void* src,
+                                 audio_format_t src_format, int16_t* out,
+                                 size_t samples_per_channel) {
+    uint8_t channels = plan->channels;
+
+    if (src_format == AUDIO_FORMAT_S16_LE) {
+        const int16_t* in = (const int16_t*)src;
+        HELIUM_FRAMES_TO_S16(vshlq_n_s32(vldrhq_s32(&in[k]), 16))
+    } else if (src_format == AUDIO_FORMAT_S24_LE) {
+        const int32_t* in = (const int32_t*)src;
+        HELIUM_FRAMES_TO_S16(vshlq_n_s32(vld1q_s32(&in[k]), 8))
+    } else {
+        const int32_t* in = (const int32_t*)src;
+        HELIUM_FRAMES_TO_S16(vld1q_s32(&in[k]))
+    }
+}
+#endif
+
+/* One pass over the buffer for a known format pair */
+AUDIO_CONVERT_INLINE void convert_frames(const audio_convert_plan_t* plan,
+                                         const void* src, void* const* dst,
+                                         size_t samples_per_channel,
+                                         audio_format_t src_format,
+                                         audio_format_t dst_format,
+                                         int32_t (*load)(const void*, size_t),
+                                         void (*store)(void*, size_t, int32_t)) {
+    uint8_t channels = plan->channels;
+
+#if defined(AUDIO_CONVERT_HELIUM)
+    if (dst_format == AUDIO_FORMAT_S16_LE && src_format != AUDIO_FORMAT_F32_LE &&
+        !plan->deinterleave && (channels & 3) == 0) {
+        frames_to_s16_helium(plan, src, src_format, (int16_t*)dst[0], samples_per_channel);
+        return;
+    }
+#else
+    (void)src_format;
+    (void)dst_format;
+#endif
+
+    if (plan->deinterleave) {
+        for (size_t i = 0; i < samples_per_channel; i++) {
+            for (uint8_t ch = 0; ch < channels; ch++) {
+                int32_t x = load(src, i * channels + ch);
+                store(dst[ch], i, plan->conditioned ? condition(plan, ch, x) : x);
+            }
+        }
+        return;
+    }
+
+    void* out = dst[0];
+    size_t total = samples_per_channel * channels;
+    if (!plan->conditioned) {
+        for (size_t k = 0; k < total; k++) {
+            store(out, k, load(src, k));
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < samples_per_channel; i++) {
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            size_t k = i * channels + ch;
+            store(out, k, condition(plan, ch, load(src, k)));
+        }
+    }
+}
+
+/* Kernels, one per format pair */
+#define AUDIO_CONVERT_FORMATS(X, from, FROM) \
+    X(from, FROM, s16, S16) X(from, FROM, s24, S24) \
+    X(from, FROM, s32, S32) X(from, FROM, f32, F32)
+
+#define AUDIO_CONVERT_PAIRS(X) \
+    AUDIO_CONVERT_FORMATS(X, s16, S16) AUDIO_CONVERT_FORMATS(X, s24, S24) \
+    AUDIO_CONVERT_FORMATS(X, s32, S32) AUDIO_CONVERT_FORMATS(X, f32, F32)
+
+#define AUDIO_CONVERT_DEFINE_KERNEL(from, FROM, to, TO) \
+    static void convert_##from##_##to(const audio_convert_plan_t* plan, const void* src, \
+                                      void* const* dst, size_t samples_per_channel) { \
+        convert_frames(plan, src, dst, samples_per_channel, \
+                       AUDIO_FORMAT_##FROM##_LE, AUDIO_FORMAT_##TO##_LE, \
+                       load_##from, store_##to); \
+    }
+
+#define AUDIO_CONVERT_KERNEL_ENTRY(from, FROM, to, TO) convert_##from##_##to,
+
+AUDIO_CONVERT_PAIRS(AUDIO_CONVERT_DEFINE_KERNEL)
+
+/* Indexed [src_format * AUDIO_FORMAT_COUNT + dst_format] */
+static const convert_kernel_t kernel_table[AUDIO_FORMAT_COUNT * AUDIO_FORMAT_COUNT] = {
+    AUDIO_CONVERT_PAIRS(AUDIO_CONVERT_KERNEL_ENTRY)
+};
+
+static bool format_valid(audio_format_t format) {
+    return (unsigned)format < AUDIO_FORMAT_COUNT;
+}
+
+static size_t sample_bytes(audio_format_t format) {
+    return (format == AUDIO_FORMAT_S16_LE) ? sizeof(int16_t) : sizeof(int32_t);
+}
+
+/* Recompute whether the plan is a plain conversion */
+static void update_conditioned(audio_convert_plan_t* plan) {
+    plan->conditioned = false;
+    for (uint8_t ch = 0; ch < plan->channels; ch++) {
+        if (plan->dc_offset[ch] != 0 ||
+            plan->gain_mantissa[ch] != UNITY_MANTISSA ||
+            plan->gain_shift[ch] != UNITY_SHIFT) {
+            plan->conditioned = true;
+        }
+    }
+}
+
+/* Start a conversion plan */
+audio_error_t audio_convert_plan_init(audio_convert_plan_t* plan,
+                                      uint8_t channels,
+                                      bool deinterleave) {
+    if (!plan || channels == 0 || channels > AUDIO_MAX_CHANNELS) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+
+    memset(plan, 0, sizeof(audio_convert_plan_t));
+    plan->channels = channels;
+    plan->deinterleave = deinterleave;
+    for (uint8_t ch = 0; ch < AUDIO_MAX_CHANNELS; ch++) {
+        plan->gain_mantissa[ch] = UNITY_MANTISSA;
+        plan->gain_shift[ch] = UNITY_SHIFT;
+    }
+
+    return AUDIO_OK;
+}
+
+/* Set a channel's gain */
+audio_error_t audio_convert_plan_set_gain(audio_convert_plan_t* plan,
+                                          uint8_t channel,
+                                          float gain_db) {
+    if (!plan || channel >= plan->channels || !isfinite(gain_db)) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+
+    gain_db = fminf(fmaxf(gain_db, -MAX_GAIN_DB), MAX_GAIN_DB);
+
+    int exponent;
+    float mantissa = frexpf(powf(10.0f, gain_db / 20.0f), &exponent);
+    int64_t q31 = llrintf(mantissa * Q31_SCALE);
+
+    if (exponent > MAX_GAIN_SHIFT) exponent = MAX_GAIN_SHIFT;
+    if (exponent < -MAX_GAIN_SHIFT) exponent = -MAX_GAIN_SHIFT;
+    plan->gain_mantissa[channel] = saturate_q31(q31);
+    plan->gain_shift[channel] = exponent;
+
+    update_conditioned(plan);
+    return AUDIO_OK;
+}
+
+/* Set a channel's DC offset */
+audio_error_t audio_convert_plan_set_dc(audio_convert_plan_t* plan,
+                                        uint8_t channel,
+                                        float dc_offset) {
+    if (!plan || channel >= plan->channels ||
+        !(dc_offset >= -1.0f && dc_offset <= 1.0f)) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+
+    plan->dc_offset[channel] = saturate_q31(llrintf(dc_offset * Q31_SCALE));
+
+    update_conditioned(plan);
+    return AUDIO_OK;
+}
+
+/* Convert, condition and lay out in one pass */
+audio_error_t audio_convert_fused(const audio_convert_plan_t* plan,
+                                  const void* src,
+                                  audio_format_t src_format,
+                                  void* const* dst,
+                                  audio_format_t dst_format,
+                                  size_t samples_per_channel) {
+    if (!plan || !src || !dst || plan->channels == 0 ||
+        plan->channels > AUDIO_MAX_CHANNELS ||
+        !format_valid(src_format) || !format_valid(dst_format)) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+
+    uint8_t lines = plan->deinterleave ? plan->channels : 1;
+    for (uint8_t i = 0; i < lines; i++) {
+        if (!dst[i]) {
+            return AUDIO_ERR_INVALID_PARAM;
+        }
+    }
+
+    kernel_table[src_format * AUDIO_FORMAT_COUNT + dst_format](plan, src, dst,
+                                                                samples_per_channel);
+    return AUDIO_OK;
+}
+
+/* Convert audio format */
+audio_error_t audio_convert_format(const void* src,
+                                  audio_format_t src_format,
+                                  void* dst,
+                                  audio_format_t dst_format,
+                                  size_t samples) {
+    audio_convert_plan_t plan;
+    audio_convert_plan_init(&plan, 1, false);
+
+    void* const lines[1] = { dst };
+    return audio_convert_fused(&plan, src, src_format, lines, dst_format, samples);
+}
+
+/* Layout kernels: whole samples move unchanged, so only the container
+ * width matters and S24 and F32 take the 32-bit lanes */
+#if defined(AUDIO_CONVERT_HELIUM)
+/* Helium: a stereo pair moves 8 or 4 frames per vld2/vst2; returns the
+ * frames done, the tail is left to the scalar loop */
+static size_t interleave2_s16_helium(const int16_t* left, const int16_t* right,
+                                     int16_t* out, size_t samples_per_channel) {
+    size_t i = 0;
+    for (; i + 8 <= samples_per_channel; i += 8) {
+        int16x8x2_t v = { { vld1q_s16(&left[i]), vld1q_s16(&right[i]) } };
+        vst2q_s16(&out[2 * i], v);
+    }
+    return i;
+}
+
+static size_t interleave2_s32_helium(const int32_t* left, const int32_t* right,
+                                     int32_t* out, size_t samples_per_channel) {
+    size_t i = 0;
+    for (; i + 4 <= samples_per_channel; i += 4) {
+        int32x4x2_t v = { { vld1q_s32(&left[i]), vld1q_s32(&right[i]) } };
+        vst2q_s32(&out[2 * i], v);
+    }
+    return i;
+}
+
+static size_t deinterleave2_s16_helium(const int16_t* in, int16_t* left,
+                                       int16_t* right, size_t samples_per_channel) {
+    size_t i = 0;
+    for (; i + 8 <= samples_per_channel; i += 8) {
+        int16x8x2_t v = vld2q_s16(&in[2 * i]);
+        vst1q_s16(&left[i], v.val[0]);
+        vst1q_s16(&right[i], v.val[1]);
+    }
+    return i;
+}
+
+static size_t deinterleave2_s32_helium(const int32_t* in, int32_t* left,
+                                       int32_t* right, size_t samples_per_channel) {
+    size_t i = 0;
+    for (; i + 4 <= samples_per_channel; i += 4) {
+        int32x4x2_t v = vld2q_s32(&in[2 * i]);
+        vst1q_s32(&left[i], v.val[0]);
+        vst1q_s32(&right[i], v.val[1]);
+    }
+    return i;
+}
+#endif
+
+static void interleave_s16(const void** src, int16_t* out, uint8_t channels,
+                           size_t samples_per_channel) {
+    size_t start = 0;
+#if defined(AUDIO_CONVERT_HELIUM)
+    if (channels == 2) {
+        start = interleave2_s16_helium((const int16_t*)src[0], (const int16_t*)src[1],
+                                       out, samples_per_channel);
+    }
+#endif
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        const int16_t* in = (const int16_t*)src[ch];
+        for (size_t i = start; i < samples_per_channel; i++) {
+            out[i * channels + ch] = in[i];
+        }
+    }
+}
+
+static void interleave_s32(const void** src, int32_t* out, uint8_t channels,
+                           size_t samples_per_channel) {
+    size_t start = 0;
+#if defined(AUDIO_CONVERT_HELIUM)
+    if (channels == 2) {
+        start = interleave2_s32_helium((const int32_t*)src[0], (const int32_t*)src[1],
+                                       out, samples_per_channel);
+    }
+#endif
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        const int32_t* in = (const int32_t*)src[ch];
+        for (size_t i = start; i < samples_per_channel; i++) {
+            out[i * channels + ch] = in[i];
+        }
+    }
+}
+
+static void deinterleave_s16(const int16_t* in, void** dst, uint8_t channels,
+                             size_t samples_per_channel) {
+    size_t start = 0;
+#if defined(AUDIO_CONVERT_HELIUM)
+    if (channels == 2) {
+        start = deinterleave2_s16_helium(in, (int16_t*)dst[0], (int16_t*)dst[1],
+                                         samples_per_channel);
+    }
+#endif
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        int16_t* out = (int16_t*)dst[ch];
+        for (size_t i = start; i < samples_per_channel; i++) {
+            out[i] = in[i * channels + ch];
+        }
+    }
+}
+
+static void deinterleave_s32(const int32_t* in, void** dst, uint8_t channels,
+                             size_t samples_per_channel) {
+    size_t start = 0;
+#if defined(AUDIO_CONVERT_HELIUM)
+    if (channels == 2) {
+        start = deinterleave2_s32_helium(in, (int32_t*)dst[0], (int32_t*)dst[1],
+                                         samples_per_channel);
+    }
+#endif
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        int32_t* out = (int32_t*)dst[ch];
+        for (size_t i = start; i < samples_per_channel; i++) {
+            out[i] = in[i * channels + ch];
+        }
+    }
+}
+
+/* Interleave audio channels */
+audio_error_t audio_interleave(const void** src,
+                               void* dst,
+                               uint8_t channels,
+                               size_t samples_per_channel,
+                               audio_format_t format) {
+    if (!src || !dst || channels == 0 || channels > AUDIO_MAX_CHANNELS ||
+        !format_valid(format)) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        if (!src[ch]) {
+            return AUDIO_ERR_INVALID_PARAM;
+        }
+    }
+
+    if (sample_bytes(format) == sizeof(int16_t)) {
+        interleave_s16(src, (int16_t*)dst, channels, samples_per_channel);
+    } else {
+        interleave_s32(src, (int32_t*)dst, channels, samples_per_channel);
+    }
+    return AUDIO_OK;
+}
+
+/* Deinterleave audio channels */
+audio_error_t audio_deinterleave(const void* src,
+                                void** dst,
+                                uint8_t channels,
+                                size_t samples_per_channel,
+                                audio_format_t format) {
+    if (!src || !dst || channels == 0 || channels > AUDIO_MAX_CHANNELS ||
+        !format_valid(format)) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        if (!dst[ch]) {
+            return AUDIO_ERR_INVALID_PARAM;
+        }
+    }
+
+    if (sample_bytes(format) == sizeof(int16_t)) {
+        deinterleave_s16((const int16_t*)src, dst, channels, samples_per_channel);
+    } else {
+        deinterleave_s32((const int32_t*)src, dst, channels, samples_per_channel);
+    }
+    return AUDIO_OK;
+}
@@ -28,7 +28,7 @@ typedef enum {
 /* Audio Formats */
 typedef enum {
     AUDIO_FORMAT_S16_LE = 0,    // 16-bit signed little-endian
-    AUDIO_FORMAT_S24_LE,        // 24-bit signed little-endian
+    AUDIO_FORMAT_S24_LE,        // 24-bit signed little-endian, low 3 bytes of a 32-bit word
     AUDIO_FORMAT_S32_LE,        // 32-bit signed little-endian
     AUDIO_FORMAT_F32_LE         // 32-bit float little-endian
 } audio_format_t;
@@ -52,6 +52,18 @@ typedef enum {
 /* Buffer Configuration */
 #define AUDIO_BUFFER_COUNT      4   // Number of DMA buffers
 #define AUDIO_BUFFER_SIZE_MS    20  // Buffer size in milliseconds
+#define AUDIO_LOW_LATENCY_BUFFER_COUNT  8
+#define AUDIO_LOW_LATENCY_BUFFER_MS     5
+#define AUDIO_LOW_POWER_BUFFER_COUNT    4
+#define AUDIO_LOW_POWER_BUFFER_MS       40
+#define AUDIO_MAX_BUFFER_COUNT          8   // Most buffers any latency mode uses
+
+/* Capture Latency Modes */
+typedef enum {
+    AUDIO_LATENCY_BALANCED = 0, // AUDIO_BUFFER_COUNT periods of AUDIO_BUFFER_SIZE_MS
+    AUDIO_LATENCY_LOW,          // Short periods, for barge-in and stop words
+    AUDIO_LATENCY_LOW_POWER     // Long periods and fewer wakeups, for idle listening
+} audio_latency_mode_t;
 
 /* Microphone Array Geometry */
 typedef struct {
@@ -106,6 +118,9 @@ typedef struct {
     bool enable_agc;            // Automatic gain control
     bool enable_noise_gate;
     float gain_db;              // Manual gain in dB
+    
+    /* Capture latency */
+    audio_latency_mode_t latency_mode;  // Mode at start
 } audio_config_t;
 
 /* Audio Statistics */
@@ -117,6 +132,9 @@ typedef struct {
     float peak_level_db[AUDIO_MAX_CHANNELS];
     uint32_t clipping_count[AUDIO_MAX_CHANNELS];
     float dc_offset[AUDIO_MAX_CHANNELS];
+    uint32_t buffer_underruns;  // Reads that found no period ready in time
+    uint32_t latency_switches;  // Latency modes applied since start
+    uint16_t period_samples;    // Samples per channel in the current period
 } audio_stats_t;
 
 /* Audio Buffer */
@@ -130,6 +148,34 @@ typedef struct {
     bool is_ready;              // Buffer ready flag
 } audio_buffer_t;
 
+/* Fused Conversion Plan
+ *
+ * Per-channel conditioning in the conversion kernels' common domain:
+ * samples scaled to Q31 full scale. Gains are a Q31 mantissa in
+ * [0.5, 1) and a power-of-two shift. Build with audio_convert_plan_init()
+ * and the setters rather than by hand. */
+typedef struct {
+    uint8_t channels;                       // Interleaved source channels
+    bool deinterleave;                      // One output line per channel
+    bool conditioned;                       // Any gain or DC offset to apply
+    int32_t gain_mantissa[AUDIO_MAX_CHANNELS];
+    int32_t gain_shift[AUDIO_MAX_CHANNELS];
+    int32_t dc_offset[AUDIO_MAX_CHANNELS];  // Q31 full scale
+} audio_convert_plan_t;
+
+/* Latency Mode Switch
+ *
+ * Driver-independent part of audio_driver_set_latency_mode(): any task
+ * requests a mode, and the capture side applies it at the first period
+ * boundary aligned to the new period. Initialize with
+ * audio_latency_switch_init(). */
+typedef struct {
+    audio_latency_mode_t mode;          // Mode of the periods being captured
+    audio_latency_mode_t requested;     // Written by audio_latency_switch_request()
+    uint16_t period_samples;            // Samples per channel in mode
+    uint32_t sample_rate;               // Hz
+} audio_latency_switch_t;
+
 /* Audio Driver Handle */
 typedef struct audio_driver audio_driver_t;
 
@@ -229,6 +275,78 @@ audio_error_t audio_driver_set_noise_gate(audio_driver_t* driver,
                                          uint32_t attack_ms,
                                          uint32_t release_ms);
 
+/**
+ * @brief Change the capture latency mode
+ * @param driver Driver handle
+ * @param mode New mode
+ * @return AUDIO_OK or error code
+ *
+ * Safe to call from any task while capturing. Periods already queued
+ * to DMA finish at their old size. The new size starts at the first
+ * period boundary where samples_captured is a multiple of the new
+ * period, so boundaries stay on whole periods of every mode counted
+ * from the start of capture. No samples are dropped or repeated,
+ * samples_captured and buffer timestamps run on unbroken, and
+ * consumers see only a change of samples_per_channel. A later call
+ * replaces a pending one.
+ *
+ * The default, for drivers without latency control, rejects every mode
+ * with AUDIO_ERR_CONFIG, and the voice core keeps its current mode.
+ * Drivers that support it override the default with one that calls
+ * audio_latency_switch_request().
+ */
+audio_error_t audio_driver_set_latency_mode(audio_driver_t* driver,
+                                           audio_latency_mode_t mode);
+
+/**
+ * @brief Period and buffer count of a latency mode
+ * @param mode Latency mode
+ * @param sample_rate Sample rate in Hz
+ * @param period_samples Samples per channel per period
+ * @param buffer_count DMA buffers, at most AUDIO_MAX_BUFFER_COUNT
+ * @return AUDIO_OK or error code
+ */
+audio_error_t audio_latency_geometry(audio_latency_mode_t mode,
+                                     uint32_t sample_rate,
+                                     uint16_t* period_samples,
+                                     uint8_t* buffer_count);
+
+/**
+ * @brief Start a latency mode switch in a mode
+ * @param sw Switch to initialize
+ * @param mode Mode at start of capture
+ * @param sample_rate Sample rate in Hz
+ * @return AUDIO_OK or error code
+ */
+audio_error_t audio_latency_switch_init(audio_latency_switch_t* sw,
+                                        audio_latency_mode_t mode,
+                                        uint32_t sample_rate);
+
+/**
+ * @brief Request a latency mode
+ * @param sw Latency mode switch
+ * @param mode New mode
+ * @return AUDIO_OK or error code
+ *
+ * Safe from any task; a later request replaces a pending one. Drivers
+ * implement audio_driver_set_latency_mode() with this.
+ */
+audio_error_t audio_latency_switch_request(audio_latency_switch_t* sw,
+                                           audio_latency_mode_t mode);
+
+/**
+ * @brief Apply a pending mode at a period boundary
+ * @param sw Latency mode switch
+ * @param samples_captured Samples per channel captured before the boundary
+ * @return true if the mode changed
+ *
+ * Call from the capture side, ISR included, before starting each
+ * period, then size the period from sw->period_samples. The pending
+ * mode applies once samples_captured is a multiple of its period.
+ */
+bool audio_latency_switch_boundary(audio_latency_switch_t* sw,
+                                   uint64_t samples_captured);
+
 /* Utility Functions */
 
 /**
@@ -328,6 +446,71 @@ audio_error_t audio_deinterleave(const void* src,
                                 size_t samples_per_channel,
                                 audio_format_t format);
 
+/**
+ * @brief Start a conversion plan: unity gain, no DC offset, interleaved
+ * @param plan Plan to initialize
+ * @param channels Interleaved source channels (1 to AUDIO_MAX_CHANNELS)
+ * @param deinterleave Write one line per channel instead of interleaved
+ * @return AUDIO_OK or error code
+ */
+audio_error_t audio_convert_plan_init(audio_convert_plan_t* plan,
+                                      uint8_t channels,
+                                      bool deinterleave);
+
+/**
+ * @brief Set a channel's gain
+ * @param plan Conversion plan
+ * @param channel Channel index
+ * @param gain_db Gain in decibels, as for audio_driver_set_channel_gain()
+ * @return AUDIO_OK or error code
+ */
+audio_error_t audio_convert_plan_set_gain(audio_convert_plan_t* plan,
+                                          uint8_t channel,
+                                          float gain_db);
+
+/**
+ * @brief Set a channel's DC offset
+ * @param plan Conversion plan
+ * @param channel Channel index
+ * @param dc_offset Offset as a fraction of full scale, as measured by
+ *        audio_driver_calibrate_dc()
+ * @return AUDIO_OK or error code
+ */
+audio_error_t audio_convert_plan_set_dc(audio_convert_plan_t* plan,
+                                        uint8_t channel,
+                                        float dc_offset);
+
+/**
+ * @brief Convert, condition and optionally deinterleave in one pass
+ * @param plan Conversion plan
+ * @param src Interleaved source buffer
+ * @param src_format Source format
+ * @param dst Output: dst[0] is the interleaved buffer, or with
+ *        plan->deinterleave dst[ch] is channel ch's line
+ * @param dst_format Destination format
+ * @param samples_per_channel Samples per channel
+ * @return AUDIO_OK or error code
+ *
+ * Each sample has its channel's DC offset subtracted, then its gain
+ * applied, saturating at full scale, before it is stored in dst_format.
+ * A DMA buffer goes straight to the interleaved S16 frames the voice
+ * core consumes, with one read and one write per sample. Narrowing
+ * truncates toward minus infinity, and F32 is clipped to [-1, 1).
+ * Interleaved output may overwrite the source in place when its samples
+ * are no wider. Drivers keep a plan in step with
+ * audio_driver_set_gain(), audio_driver_set_channel_gain() and
+ * audio_driver_calibrate_dc(), and run it once per DMA buffer. On cores
+ * with Helium, four channels at a time are converted with vector
+ * instructions when the output is interleaved S16 and the channel count
+ * is a multiple of four.
+ */
+audio_error_t audio_convert_fused(const audio_convert_plan_t* plan,
+                                  const void* src,
+                                  audio_format_t src_format,
+                                  void* const* dst,
+                                  audio_format_t dst_format,
+                                  size_t samples_per_channel);
+
 /* Platform-specific initialization */
 
 /**
@@ -0,0 +1,100 @@
+/**
+ * @file audio_latency.c
+ * @brief W.I.T. Capture Latency Mode Geometry and Switching
+ */
+
+#include "audio_driver.h"
+
+/* Period and buffer count of a latency mode */
+audio_error_t audio_latency_geometry(audio_latency_mode_t mode,
+                                     uint32_t sample_rate,
+                                     uint16_t* period_samples,
+                                     uint8_t* buffer_count) {
+    if (!period_samples || !buffer_count || sample_rate == 0) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+
+    uint32_t period_ms;
+    switch (mode) {
+        case AUDIO_LATENCY_BALANCED:
+            period_ms = AUDIO_BUFFER_SIZE_MS;
+            *buffer_count = AUDIO_BUFFER_COUNT;
+            break;
+        case AUDIO_LATENCY_LOW:
+            period_ms = AUDIO_LOW_LATENCY_BUFFER_MS;
+            *buffer_count = AUDIO_LOW_LATENCY_BUFFER_COUNT;
+            break;
+        case AUDIO_LATENCY_LOW_POWER:
+            period_ms = AUDIO_LOW_POWER_BUFFER_MS;
+            *buffer_count = AUDIO_LOW_POWER_BUFFER_COUNT;
+            break;
+        default:
+            return AUDIO_ERR_INVALID_PARAM;
+    }
+
+    uint32_t samples = sample_rate / 1000 * period_ms;
+    if (samples == 0 || samples > UINT16_MAX) {
+        return AUDIO_ERR_CONFIG;
+    }
+
+    *period_samples = (uint16_t)samples;
+    return AUDIO_OK;
+}
+
+/* Start in a mode, nothing pending */
+audio_error_t audio_latency_switch_init(audio_latency_switch_t* sw,
+                                        audio_latency_mode_t mode,
+                                        uint32_t sample_rate) {
+    uint8_t count;
+    if (!sw) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+    audio_error_t err = audio_latency_geometry(mode, sample_rate, &sw->period_samples, &count);
+    if (err != AUDIO_OK) {
+        return err;
+    }
+    sw->mode = mode;
+    sw->requested = mode;
+    sw->sample_rate = sample_rate;
+    return AUDIO_OK;
+}
+
+/* Any task; the capture side picks it up at a boundary */
+audio_error_t audio_latency_switch_request(audio_latency_switch_t* sw,
+                                           audio_latency_mode_t mode) {
+    uint16_t period;
+    uint8_t count;
+    if (!sw || audio_latency_geometry(mode, sw->sample_rate, &period, &count) != AUDIO_OK) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+    __atomic_store_n(&sw->requested, mode, __ATOMIC_RELEASE);
+    return AUDIO_OK;
+}
+
+/* Boundaries stay on whole periods of every mode from the start of capture */
+bool audio_latency_switch_boundary(audio_latency_switch_t* sw,
+                                   uint64_t samples_captured) {
+    audio_latency_mode_t requested = __atomic_load_n(&sw->requested, __ATOMIC_ACQUIRE);
+    if (requested == sw->mode) {
+        return false;
+    }
+
+    uint16_t period;
+    uint8_t count;
+    if (audio_latency_geometry(requested, sw->sample_rate, &period, &count) != AUDIO_OK ||
+        samples_captured % period != 0) {
+        return false;
+    }
+    sw->mode = requested;
+    sw->period_samples = period;
+    return true;
+}
+
+/* Drivers without latency control keep this; see audio_driver.h */
+__attribute__((weak))
+audio_error_t audio_driver_set_latency_mode(audio_driver_t* driver,
+                                           audio_latency_mode_t mode) {
+    (void)driver;
+    (void)mode;
+    return AUDIO_ERR_CONFIG;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file FreeRTOS.h
+ * @brief W.I.T. Host FreeRTOS Shim
+ *
+ * Minimal pthread-backed stand-in for the FreeRTOS kernel API used by
+ * the voice pipeline, for host builds only. Time is virtual: the tick
+ * count only moves when the host calls shim_tick_advance(), which also
+ * runs expired software timers, so replays are deterministic and run
+ * as fast as the CPU allows. Blocking waits with a finite timeout use
+ * wall-clock milliseconds.
+ */
+
+#ifndef WIT_HOST_FREERTOS_H
+#define WIT_HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Kernel configuration */
+#define configTICK_RATE_HZ                  1000
+#define configSUPPORT_STATIC_ALLOCATION     1
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+
+/* Basic types */
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdFALSE                 0
+#define pdTRUE                  1
+#define pdFAIL                  0
+#define pdPASS                  1
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFu)
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define tskIDLE_PRIORITY        0
+#define tskNO_AFFINITY          0x7FFFFFFF
+
+/* Static object storage; the shim allocates internally and ignores it */
+typedef struct { void* reserved; } StaticTask_t;
+typedef struct { void* reserved; } StaticQueue_t;
+typedef struct { void* reserved; } StaticTimer_t;
+typedef StaticQueue_t StaticSemaphore_t;
+
+/* Critical sections: one global recursive lock */
+void shim_enter_critical(void);
+void shim_exit_critical(void);
+#define portENTER_CRITICAL(mux)         shim_enter_critical()
+#define portEXIT_CRITICAL(mux)          shim_exit_critical()
+#define taskENTER_CRITICAL()            shim_enter_critical()
+#define taskEXIT_CRITICAL()             shim_exit_critical()
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZE(mux)         ((void)(mux))
+
+/* Heap */
+#define pvPortMalloc(size)      malloc(size)
+#define vPortFree(ptr)          free(ptr)
+
+/**
+ * @brief Advance virtual time and run expired timers
+ * @param ticks Ticks to advance
+ *
+ * Timer callbacks run on the calling thread, as the timer service
+ * task would on target.
+ */
+void shim_tick_advance(TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_HOST_FREERTOS_H */
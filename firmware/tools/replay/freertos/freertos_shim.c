@@ -0,0 +1,490 @@
+/**
+ * @file freertos_shim.c
+ * @brief W.I.T. Host FreeRTOS Shim Implementation
+ */
+
+#define _GNU_SOURCE
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+/* Internal Constants */
+#define SHIM_MAX_TIMERS         32
+
+struct shim_task {
+    pthread_t thread;
+    TaskFunction_t code;
+    void* param;
+    pthread_mutex_t notify_lock;
+    pthread_cond_t notify_cond;
+    uint32_t notify_count;
+};
+
+struct shim_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t* storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t count;
+    UBaseType_t head;
+};
+
+struct shim_timer {
+    TickType_t period;
+    TickType_t expiry;
+    bool auto_reload;
+    bool active;
+    void* timer_id;
+    TimerCallbackFunction_t callback;
+};
+
+static pthread_mutex_t critical_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static pthread_mutex_t timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t tick_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tick_cond = PTHREAD_COND_INITIALIZER;
+static TickType_t tick_count;
+static struct shim_timer* timers[SHIM_MAX_TIMERS];
+static __thread struct shim_task* current_task;
+
+/* Critical sections */
+
+void shim_enter_critical(void) {
+    pthread_mutex_lock(&critical_lock);
+}
+
+void shim_exit_critical(void) {
+    pthread_mutex_unlock(&critical_lock);
+}
+
+/* Absolute wall-clock deadline for a tick timeout */
+static struct timespec deadline_after(TickType_t ticks) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000u + (uint64_t)ts.tv_nsec;
+    ts.tv_sec += (time_t)(ns / 1000000000u);
+    ts.tv_nsec = (long)(ns % 1000000000u);
+    return ts;
+}
+
+/* Wait on a condition; false on timeout */
+static bool wait_cond(pthread_cond_t* cond, pthread_mutex_t* lock,
+                      TickType_t ticks, const struct timespec* deadline) {
+    if (ticks == 0) {
+        return false;
+    }
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+static void unlock_cleanup(void* lock) {
+    pthread_mutex_unlock((pthread_mutex_t*)lock);
+}
+
+/* Tasks */
+
+static void* task_entry(void* arg) {
+    struct shim_task* task = (struct shim_task*)arg;
+    current_task = task;
+    task->code(task->param);
+    return NULL;
+}
+
+static struct shim_task* task_start(TaskFunction_t code, void* param) {
+    struct shim_task* task = (struct shim_task*)calloc(1, sizeof(struct shim_task));
+    if (!task) {
+        return NULL;
+    }
+
+    task->code = code;
+    task->param = param;
+    pthread_mutex_init(&task->notify_lock, NULL);
+    pthread_cond_init(&task->notify_cond, NULL);
+
+    if (pthread_create(&task->thread, NULL, task_entry, task) != 0) {
+        free(task);
+        return NULL;
+    }
+    return task;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stack_depth,
+                       void* param, UBaseType_t priority, TaskHandle_t* handle) {
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    struct shim_task* task = task_start(code, param);
+    if (handle) {
+        *handle = task;
+    }
+    return task ? pdPASS : pdFAIL;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t code, const char* name, uint32_t stack_depth,
+                               void* param, UBaseType_t priority, StackType_t* stack,
+                               StaticTask_t* task_buffer) {
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    (void)stack;
+    (void)task_buffer;
+    return task_start(code, param);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stack_depth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core_id) {
+    (void)core_id;
+    return xTaskCreate(code, name, stack_depth, param, priority, handle);
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char* name,
+                                           uint32_t stack_depth, void* param,
+                                           UBaseType_t priority, StackType_t* stack,
+                                           StaticTask_t* task_buffer, BaseType_t core_id) {
+    (void)core_id;
+    return xTaskCreateStatic(code, name, stack_depth, param, priority, stack, task_buffer);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (!task || task == current_task) {
+        pthread_exit(NULL);
+    }
+
+    /* Blocking calls are cancellation points */
+    pthread_cancel(task->thread);
+    pthread_join(task->thread, NULL);
+    pthread_mutex_destroy(&task->notify_lock);
+    pthread_cond_destroy(&task->notify_cond);
+    free(task);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    pthread_mutex_lock(&tick_lock);
+    pthread_cleanup_push(unlock_cleanup, &tick_lock);
+    TickType_t target = tick_count + ticks;
+    while ((int32_t)(tick_count - target) < 0) {
+        pthread_cond_wait(&tick_cond, &tick_lock);
+    }
+    pthread_cleanup_pop(1);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    pthread_mutex_lock(&tick_lock);
+    TickType_t now = tick_count;
+    pthread_mutex_unlock(&tick_lock);
+    return now;
+}
+
+TickType_t xTaskGetTickCountFromISR(void) {
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return current_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    pthread_mutex_lock(&task->notify_lock);
+    task->notify_count++;
+    pthread_cond_signal(&task->notify_cond);
+    pthread_mutex_unlock(&task->notify_lock);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    struct shim_task* task = current_task;
+    if (!task) {
+        return 0;
+    }
+
+    struct timespec deadline = deadline_after(ticks);
+    uint32_t value;
+
+    pthread_mutex_lock(&task->notify_lock);
+    pthread_cleanup_push(unlock_cleanup, &task->notify_lock);
+    while (task->notify_count == 0 &&
+           wait_cond(&task->notify_cond, &task->notify_lock, ticks, &deadline)) {
+    }
+    value = task->notify_count;
+    if (value > 0) {
+        task->notify_count = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_cleanup_pop(1);
+    return value;
+}
+
+/* Queues */
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    if (length == 0) {
+        return NULL;
+    }
+
+    struct shim_queue* queue = (struct shim_queue*)calloc(1, sizeof(struct shim_queue));
+    if (!queue) {
+        return NULL;
+    }
+
+    if (item_size > 0) {
+        queue->storage = (uint8_t*)malloc(length * item_size);
+        if (!queue->storage) {
+            free(queue);
+            return NULL;
+        }
+    }
+
+    queue->length = length;
+    queue->item_size = item_size;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+    return queue;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size,
+                                 uint8_t* storage, StaticQueue_t* queue_buffer) {
+    (void)storage;
+    (void)queue_buffer;
+    return xQueueCreate(length, item_size);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    struct timespec deadline = deadline_after(ticks);
+    volatile BaseType_t result = pdFAIL;
+
+    pthread_mutex_lock(&queue->lock);
+    pthread_cleanup_push(unlock_cleanup, &queue->lock);
+    while (queue->count == queue->length &&
+           wait_cond(&queue->not_full, &queue->lock, ticks, &deadline)) {
+    }
+    if (queue->count < queue->length) {
+        UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        if (queue->item_size > 0) {
+            memcpy(&queue->storage[tail * queue->item_size], item, queue->item_size);
+        }
+        queue->count++;
+        pthread_cond_signal(&queue->not_empty);
+        result = pdPASS;
+    }
+    pthread_cleanup_pop(1);
+    return result;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken) {
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    return xQueueSend(queue, item, 0);
+}
+
+/* Receive or peek the head item */
+static BaseType_t queue_take(QueueHandle_t queue, void* item, TickType_t ticks,
+                             bool remove) {
+    struct timespec deadline = deadline_after(ticks);
+    volatile BaseType_t result = pdFAIL;
+
+    pthread_mutex_lock(&queue->lock);
+    pthread_cleanup_push(unlock_cleanup, &queue->lock);
+    while (queue->count == 0 &&
+           wait_cond(&queue->not_empty, &queue->lock, ticks, &deadline)) {
+    }
+    if (queue->count > 0) {
+        if (item && queue->item_size > 0) {
+            memcpy(item, &queue->storage[queue->head * queue->item_size], queue->item_size);
+        }
+        if (remove) {
+            queue->head = (queue->head + 1) % queue->length;
+            queue->count--;
+            pthread_cond_signal(&queue->not_full);
+        }
+        result = pdPASS;
+    }
+    pthread_cleanup_pop(1);
+    return result;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    return queue_take(queue, item, ticks, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticks) {
+    return queue_take(queue, item, ticks, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t spaces = queue->length - queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return spaces;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->count = 0;
+    queue->head = 0;
+    pthread_cond_broadcast(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    if (!queue) return;
+
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_cond_destroy(&queue->not_full);
+    free(queue->storage);
+    free(queue);
+}
+
+/* Semaphores */
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    SemaphoreHandle_t sem = xQueueCreate(1, 0);
+    if (sem) {
+        xSemaphoreGive(sem);
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer) {
+    (void)buffer;
+    return xSemaphoreCreateMutex();
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* buffer) {
+    (void)buffer;
+    return xSemaphoreCreateBinary();
+}
+
+/* Timers */
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, UBaseType_t auto_reload,
+                           void* timer_id, TimerCallbackFunction_t callback) {
+    (void)name;
+    struct shim_timer* timer = (struct shim_timer*)calloc(1, sizeof(struct shim_timer));
+    if (!timer) {
+        return NULL;
+    }
+
+    timer->period = period;
+    timer->auto_reload = auto_reload;
+    timer->timer_id = timer_id;
+    timer->callback = callback;
+
+    pthread_mutex_lock(&timer_lock);
+    for (int i = 0; i < SHIM_MAX_TIMERS; i++) {
+        if (!timers[i]) {
+            timers[i] = timer;
+            pthread_mutex_unlock(&timer_lock);
+            return timer;
+        }
+    }
+    pthread_mutex_unlock(&timer_lock);
+
+    free(timer);
+    return NULL;
+}
+
+TimerHandle_t xTimerCreateStatic(const char* name, TickType_t period, UBaseType_t auto_reload,
+                                 void* timer_id, TimerCallbackFunction_t callback,
+                                 StaticTimer_t* timer_buffer) {
+    (void)timer_buffer;
+    return xTimerCreate(name, period, auto_reload, timer_id, callback);
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks) {
+    (void)ticks;
+    pthread_mutex_lock(&timer_lock);
+    timer->expiry = xTaskGetTickCount() + timer->period;
+    timer->active = true;
+    pthread_mutex_unlock(&timer_lock);
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks) {
+    (void)ticks;
+    pthread_mutex_lock(&timer_lock);
+    timer->active = false;
+    pthread_mutex_unlock(&timer_lock);
+    return pdPASS;
+}
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks) {
+    return xTimerStart(timer, ticks);
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks) {
+    pthread_mutex_lock(&timer_lock);
+    timer->period = period;
+    pthread_mutex_unlock(&timer_lock);
+    return xTimerStart(timer, ticks);
+}
+
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t ticks) {
+    (void)ticks;
+    pthread_mutex_lock(&timer_lock);
+    for (int i = 0; i < SHIM_MAX_TIMERS; i++) {
+        if (timers[i] == timer) {
+            timers[i] = NULL;
+        }
+    }
+    pthread_mutex_unlock(&timer_lock);
+    free(timer);
+    return pdPASS;
+}
+
+void* pvTimerGetTimerID(TimerHandle_t timer) {
+    return timer->timer_id;
+}
+
+/* Virtual time */
+
+void shim_tick_advance(TickType_t ticks) {
+    pthread_mutex_lock(&tick_lock);
+    tick_count += ticks;
+    TickType_t now = tick_count;
+    pthread_cond_broadcast(&tick_cond);
+    pthread_mutex_unlock(&tick_lock);
+
+    /* Fire expired timers outside the lock, as the timer task would */
+    for (int i = 0; i < SHIM_MAX_TIMERS; i++) {
+        pthread_mutex_lock(&timer_lock);
+        struct shim_timer* timer = timers[i];
+        bool fire = timer && timer->active && (int32_t)(now - timer->expiry) >= 0;
+        if (fire) {
+            if (timer->auto_reload) {
+                timer->expiry += timer->period;
+            } else {
+                timer->active = false;
+            }
+        }
+        pthread_mutex_unlock(&timer_lock);
+
+        if (fire) {
+            timer->callback(timer);
+        }
+    }
+}
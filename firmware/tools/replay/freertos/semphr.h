@@ -0,0 +1,32 @@
+/**
+ * @file semphr.h
+ * @brief W.I.T. Host FreeRTOS Shim - Semaphores
+ *
+ * Semaphores are zero-size queues, as in the kernel.
+ */
+
+#ifndef WIT_HOST_SEMPHR_H
+#define WIT_HOST_SEMPHR_H
+
+#include "queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* buffer);
+
+#define xSemaphoreTake(sem, ticks)      xQueueReceive(sem, NULL, ticks)
+#define xSemaphoreGive(sem)             xQueueSend(sem, NULL, 0)
+#define vSemaphoreDelete(sem)           vQueueDelete(sem)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_HOST_SEMPHR_H */
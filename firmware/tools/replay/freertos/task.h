@@ -0,0 +1,44 @@
+/**
+ * @file task.h
+ * @brief W.I.T. Host FreeRTOS Shim - Tasks
+ */
+
+#ifndef WIT_HOST_TASK_H
+#define WIT_HOST_TASK_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shim_task* TaskHandle_t;
+typedef void (*TaskFunction_t)(void* param);
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stack_depth,
+                       void* param, UBaseType_t priority, TaskHandle_t* handle);
+TaskHandle_t xTaskCreateStatic(TaskFunction_t code, const char* name, uint32_t stack_depth,
+                               void* param, UBaseType_t priority, StackType_t* stack,
+                               StaticTask_t* task_buffer);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stack_depth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core_id);
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char* name,
+                                           uint32_t stack_depth, void* param,
+                                           UBaseType_t priority, StackType_t* stack,
+                                           StaticTask_t* task_buffer, BaseType_t core_id);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+/* Direct-to-task notifications (counting semantics) */
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_HOST_TASK_H */
@@ -0,0 +1,34 @@
+/**
+ * @file timers.h
+ * @brief W.I.T. Host FreeRTOS Shim - Software Timers
+ */
+
+#ifndef WIT_HOST_TIMERS_H
+#define WIT_HOST_TIMERS_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shim_timer* TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t timer);
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, UBaseType_t auto_reload,
+                           void* timer_id, TimerCallbackFunction_t callback);
+TimerHandle_t xTimerCreateStatic(const char* name, TickType_t period, UBaseType_t auto_reload,
+                                 void* timer_id, TimerCallbackFunction_t callback,
+                                 StaticTimer_t* timer_buffer);
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks);
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks);
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t ticks);
+void* pvTimerGetTimerID(TimerHandle_t timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIT_HOST_TIMERS_H */
@@ -0,0 +1,1121 @@
+/**
+ * @file voice_replay.c
+ * @brief W.I.T. Host Replay Benchmark for the Voice Pipeline
+ *
+ * Feeds a multichannel WAV file through voice_process_frame() on the
+ * host, using the firmware sources unchanged on top of the FreeRTOS
+ * shim. Reports throughput, per-stage timing and per-frame VAD/wake
+ * decisions, optionally writes recordings out, and compares decisions
+ * against a golden CSV so DSP and performance regressions show up per
+ * commit. Per-frame levels and MFCC features can be written and compared
+ * against a reference, to check a fixed-point build against float.
+ * With -L the audio arrives through voice_process_buffer() instead, in
+ * periods from a fake capture driver that follows the latency modes the
+ * pipeline asks for. With -M further WAV files are captured as more
+ * arrays sharing one worker pool and one wake stage.
+ */
+
+#define _GNU_SOURCE
+#include "voice_core.h"
+#include "voice_pipeline.h"
+#include "wake_word.h"
+#include "wake_features.h"
+#include "voice_beamform.h"
+#include "voice_dsp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Configuration */
+#define REPLAY_MIC_RADIUS_M     0.035f  // Default circular array radius
+#define REPLAY_MAX_RECORDING    (VOICE_SAMPLE_RATE * 60 * sizeof(int16_t))
+#define REPLAY_LEVEL_TOL_DB     0.25f   // Level error accepted by -c
+#define REPLAY_FEATURE_TOL      0.25f   // MFCC error accepted by -c
+#define REPLAY_C0_TOL           0.5f    // c0 error accepted by -c; it sums every band's
+#define REPLAY_LEVELS           3       // energy, noise floor, beam
+
+static const char* const stage_names[VOICE_STAGE_COUNT] = {
+    "beamform", "vad", "doa", "denoise", "wake", "record", "callback", "commit", "frame"
+};
+
+static const char* const stream_names[VOICE_STREAM_COUNT] = {
+    "raw", "mono", "features"
+};
+
+static const char* const state_names[] = {
+    "idle", "listening", "wake", "recording", "processing", "error"
+};
+
+/* Per-frame decision */
+typedef struct {
+    uint32_t timestamp_ms;
+    int vad;
+    int wake;
+    int state;
+} replay_decision_t;
+
+/* Per-frame levels (dB) and newest feature frame */
+typedef struct {
+    float level[REPLAY_LEVELS];
+    float features[WAKE_WORD_FEATURE_DIM];
+} replay_levels_t;
+
+/* WAV input */
+typedef struct {
+    FILE* file;
+    uint16_t channels;
+    uint32_t sample_rate;
+    uint32_t data_bytes;
+} replay_wav_t;
+
+/* Recorded audio as the consumer receives it */
+typedef struct {
+    uint8_t* data;
+    size_t bytes;
+    size_t chunks;
+    size_t payload_bytes;
+    bool streaming;
+} replay_sink_t;
+
+/* Decisions taken as frames finish (-L, where periods hold several) */
+typedef struct {
+    voice_context_t* ctx;
+    replay_decision_t* decisions;
+    size_t capacity;
+    size_t count;
+    uint32_t prev_vad;
+    uint32_t prev_wake;
+    replay_sink_t* sink;                // Recordings collected per frame
+} replay_tap_t;
+
+/* Subscriber draining one stream on its own thread (-B) */
+typedef struct {
+    voice_subscriber_t* sub;
+    uint32_t pause_us;              // Sleep after each read, to make it lag
+    atomic_bool stop;
+    uint64_t received;              // Positions read intact
+    pthread_t thread;
+} replay_reader_t;
+
+/* Fake capture driver (-L): DMA periods cut from the WAV stream */
+struct audio_driver {
+    audio_buffer_t buffers[AUDIO_MAX_BUFFER_COUNT];
+    audio_buffer_t* free_list[AUDIO_MAX_BUFFER_COUNT];
+    int free_count;
+    pthread_mutex_t lock;
+    sem_t free_buffers;
+    audio_buffer_t* filling;            // Period being captured
+    uint16_t fill;
+    audio_latency_switch_t latency;     // Requested by the processing task
+    uint64_t samples_captured;
+    uint64_t samples_accepted;          // Samples the voice core took
+    uint64_t frames_queued;             // Whole frames among them
+    size_t periods[AUDIO_LATENCY_LOW_POWER + 1];
+    audio_stats_t stats;
+};
+
+static sem_t frame_done;
+
+/* Buffers come back from the voice core, on either task */
+audio_error_t audio_driver_return_buffer(audio_driver_t* driver,
+                                        audio_buffer_t* buffer) {
+    if (!driver) {
+        return AUDIO_OK;
+    }
+    pthread_mutex_lock(&driver->lock);
+    driver->free_list[driver->free_count++] = buffer;
+    pthread_mutex_unlock(&driver->lock);
+    sem_post(&driver->free_buffers);
+    return AUDIO_OK;
+}
+
+/* Takes effect at the next period boundary aligned to the new period */
+audio_error_t audio_driver_set_latency_mode(audio_driver_t* driver,
+                                           audio_latency_mode_t mode) {
+    if (!driver) {
+        return AUDIO_ERR_INVALID_PARAM;
+    }
+    return audio_latency_switch_request(&driver->latency, mode);
+}
+
+static bool replay_driver_init(audio_driver_t* driver, audio_latency_mode_t mode) {
+    memset(driver, 0, sizeof(audio_driver_t));
+    if (audio_latency_switch_init(&driver->latency, mode, VOICE_SAMPLE_RATE) != AUDIO_OK) {
+        return false;
+    }
+    for (int i = 0; i < AUDIO_MAX_BUFFER_COUNT; i++) {
+        /* Sized for the longest period */
+        audio_buffer_t* buffer = &driver->buffers[i];
+        buffer->data = calloc(VOICE_SAMPLE_RATE / 1000 * AUDIO_LOW_POWER_BUFFER_MS * VOICE_CHANNELS,
+                              sizeof(int16_t));
+        if (!buffer->data) {
+            return false;
+        }
+        buffer->channels = VOICE_CHANNELS;
+        buffer->format = AUDIO_FORMAT_S16_LE;
+        driver->free_list[driver->free_count++] = buffer;
+    }
+    pthread_mutex_init(&driver->lock, NULL);
+    sem_init(&driver->free_buffers, 0, AUDIO_MAX_BUFFER_COUNT);
+    driver->stats.period_samples = driver->latency.period_samples;
+    return true;
+}
+
+static void replay_driver_deinit(audio_driver_t* driver) {
+    for (int i = 0; i < AUDIO_MAX_BUFFER_COUNT; i++) {
+        free(driver->buffers[i].data);
+    }
+    pthread_mutex_destroy(&driver->lock);
+    sem_destroy(&driver->free_buffers);
+}
+
+/* Start a period, switching mode first if the boundary allows */
+static void replay_driver_start_period(audio_driver_t* driver) {
+    if (audio_latency_switch_boundary(&driver->latency, driver->samples_captured)) {
+        driver->stats.period_samples = driver->latency.period_samples;
+        driver->stats.latency_switches++;
+    }
+
+    sem_wait(&driver->free_buffers);
+    pthread_mutex_lock(&driver->lock);
+    driver->filling = driver->free_list[--driver->free_count];
+    pthread_mutex_unlock(&driver->lock);
+    driver->filling->samples_per_channel = driver->latency.period_samples;
+    driver->filling->timestamp_us = driver->samples_captured * 1000000 / VOICE_SAMPLE_RATE;
+    driver->fill = 0;
+}
+
+/* Capture samples; every full period goes to the voice core */
+static void replay_driver_capture(audio_driver_t* driver, voice_context_t* ctx,
+                                  const int16_t* samples, uint32_t count) {
+    while (count > 0) {
+        if (!driver->filling) {
+            replay_driver_start_period(driver);
+        }
+
+        uint32_t take = driver->latency.period_samples - driver->fill;
+        if (take > count) {
+            take = count;
+        }
+        memcpy((int16_t*)driver->filling->data + driver->fill * VOICE_CHANNELS, samples,
+               take * VOICE_CHANNELS * sizeof(int16_t));
+        driver->fill += take;
+        driver->samples_captured += take;
+        driver->stats.samples_captured += take;
+        samples += take * VOICE_CHANNELS;
+        count -= take;
+
+        if (driver->fill == driver->latency.period_samples) {
+            audio_buffer_t* buffer = driver->filling;
+            driver->filling = NULL;
+            driver->periods[driver->latency.mode]++;
+            if (voice_process_buffer(ctx, driver, buffer) == VOICE_OK) {
+                driver->samples_accepted += driver->latency.period_samples;
+                driver->frames_queued = driver->samples_accepted / VOICE_FRAME_SIZE;
+            } else {
+                driver->stats.buffer_overruns++;
+                audio_driver_return_buffer(driver, buffer);
+            }
+        }
+    }
+}
+
+/* Drain streamed chunks, or fetch a buffered recording once it ends */
+static void collect_recording(voice_context_t* ctx, replay_sink_t* sink, int state) {
+    const voice_recording_chunk_t* chunk;
+    while (sink->streaming && voice_recording_acquire(ctx, &chunk, 0) == VOICE_OK && chunk) {
+        size_t bytes = chunk->num_samples * sizeof(int16_t);
+        if (sink->bytes + bytes <= REPLAY_MAX_RECORDING) {
+            if (chunk->codec == VOICE_CODEC_IMA_ADPCM) {
+                /* Decode packet by packet, as the uplink receiver would */
+                const uint8_t* packet = chunk->data;
+                int16_t* pcm = (int16_t*)(sink->data + sink->bytes);
+                for (uint32_t p = 0; p < chunk->num_packets; p++) {
+                    pcm += voice_adpcm_decode(packet, chunk->packet_bytes[p],
+                                              pcm, VOICE_FRAME_SIZE);
+                    packet += chunk->packet_bytes[p];
+                }
+            } else {
+                memcpy(sink->data + sink->bytes, chunk->samples, bytes);
+            }
+            sink->bytes += bytes;
+        }
+        sink->payload_bytes += chunk->data_bytes;
+        sink->chunks++;
+        voice_recording_release(ctx);
+    }
+
+    if (!sink->streaming && state == VOICE_STATE_PROCESSING) {
+        size_t written = 0;
+        voice_get_recording(ctx, sink->data + sink->bytes,
+                            REPLAY_MAX_RECORDING - sink->bytes, &written);
+        sink->bytes += written;
+    }
+}
+
+/* Audio callback runs once per processed frame */
+static void on_frame(const int16_t* samples, size_t num_samples, int channels,
+                     void* user_data) {
+    (void)samples;
+    (void)num_samples;
+    (void)channels;
+    replay_tap_t* tap = (replay_tap_t*)user_data;
+    if (tap && tap->count < tap->capacity) {
+        voice_stats_t stats;
+        voice_get_stats(tap->ctx, &stats);
+        replay_decision_t* d = &tap->decisions[tap->count++];
+        d->timestamp_ms = (uint32_t)((tap->count - 1) * 1000 / (VOICE_SAMPLE_RATE / VOICE_FRAME_SIZE));
+        d->vad = (int)(stats.vad_activations - tap->prev_vad);
+        d->wake = (int)(stats.wake_detections - tap->prev_wake);
+        d->state = (int)voice_get_state(tap->ctx);
+        tap->prev_vad = stats.vad_activations;
+        tap->prev_wake = stats.wake_detections;
+
+        /* Consumer work on the frame it follows, as in a serial run */
+        collect_recording(tap->ctx, tap->sink, d->state);
+    }
+    sem_post(&frame_done);
+}
+
+static uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* Open a PCM16 WAV and position at its data chunk */
+static bool wav_open(replay_wav_t* wav, const char* path) {
+    uint8_t header[12];
+    uint8_t chunk[8];
+    uint8_t fmt[16];
+    bool have_fmt = false;
+
+    memset(wav, 0, sizeof(replay_wav_t));
+    wav->file = fopen(path, "rb");
+    if (!wav->file) {
+        return false;
+    }
+
+    if (fread(header, 1, 12, wav->file) != 12 ||
+        memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        goto error;
+    }
+
+    while (fread(chunk, 1, 8, wav->file) == 8) {
+        uint32_t size = read_le32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            if (fread(fmt, 1, 16, wav->file) != 16) {
+                goto error;
+            }
+            /* PCM, 16 bits */
+            if (read_le16(fmt) != 1 || read_le16(fmt + 14) != 16) {
+                goto error;
+            }
+            wav->channels = read_le16(fmt + 2);
+            wav->sample_rate = read_le32(fmt + 4);
+            have_fmt = true;
+            fseek(wav->file, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            wav->data_bytes = size;
+            return have_fmt;
+        } else {
+            fseek(wav->file, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+error:
+    fclose(wav->file);
+    wav->file = NULL;
+    return false;
+}
+
+/* Write a mono PCM16 WAV */
+static bool wav_write_mono(const char* path, const uint8_t* data, size_t bytes) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    uint32_t rate = VOICE_SAMPLE_RATE;
+    uint32_t byte_rate = rate * sizeof(int16_t);
+    uint32_t riff_size = 36 + (uint32_t)bytes;
+    uint32_t fmt_size = 16;
+    uint16_t format = 1, channels = 1, block = sizeof(int16_t), bits = 16;
+    uint32_t data_size = (uint32_t)bytes;
+
+    fwrite("RIFF", 1, 4, file);
+    fwrite(&riff_size, 4, 1, file);
+    fwrite("WAVEfmt ", 1, 8, file);
+    fwrite(&fmt_size, 4, 1, file);
+    fwrite(&format, 2, 1, file);
+    fwrite(&channels, 2, 1, file);
+    fwrite(&rate, 4, 1, file);
+    fwrite(&byte_rate, 4, 1, file);
+    fwrite(&block, 2, 1, file);
+    fwrite(&bits, 2, 1, file);
+    fwrite("data", 1, 4, file);
+    fwrite(&data_size, 4, 1, file);
+    fwrite(data, 1, bytes, file);
+
+    return fclose(file) == 0;
+}
+
+/* Compare decisions against a golden CSV; returns mismatching frames */
+static long compare_golden(const char* path, const replay_decision_t* decisions,
+                           size_t frames) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "cannot open golden file %s\n", path);
+        return -1;
+    }
+
+    char line[128];
+    size_t row = 0;
+    long mismatches = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        unsigned frame, ts;
+        int vad, wake;
+        char state[16];
+        if (sscanf(line, "%u,%u,%d,%d,%15s", &frame, &ts, &vad, &wake, state) != 5) {
+            continue;   // Header or blank line
+        }
+
+        if (frame >= frames) {
+            mismatches++;
+            continue;
+        }
+
+        const replay_decision_t* d = &decisions[frame];
+        if (d->vad != vad || d->wake != wake ||
+            strcmp(state_names[d->state], state) != 0) {
+            if (mismatches < 10) {
+                fprintf(stderr, "frame %u: vad %d/%d wake %d/%d state %s/%s\n",
+                        frame, d->vad, vad, d->wake, wake,
+                        state_names[d->state], state);
+            }
+            mismatches++;
+        }
+        row++;
+    }
+    fclose(file);
+
+    /* Frames missing from the golden reference also count */
+    if (row < frames) {
+        mismatches += (long)(frames - row);
+    }
+    return mismatches;
+}
+
+/* Write per-frame levels and features */
+static bool write_levels(const char* path, const replay_levels_t* levels,
+                         size_t frames, uint32_t dim) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    fprintf(file, "frame,energy_db,noise_floor_db,beam_db");
+    for (uint32_t i = 0; i < dim; i++) {
+        fprintf(file, ",f%u", i);
+    }
+    fprintf(file, "\n");
+
+    for (size_t f = 0; f < frames; f++) {
+        fprintf(file, "%zu", f);
+        for (int i = 0; i < REPLAY_LEVELS; i++) {
+            fprintf(file, ",%.4f", levels[f].level[i]);
+        }
+        for (uint32_t i = 0; i < dim; i++) {
+            fprintf(file, ",%.5f", levels[f].features[i]);
+        }
+        fprintf(file, "\n");
+    }
+
+    return fclose(file) == 0;
+}
+
+/* Compare levels and features against a reference CSV; returns the
+ * number of values outside tolerance */
+static long compare_levels(const char* path, const replay_levels_t* levels,
+                           size_t frames, uint32_t dim) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "cannot open reference file %s\n", path);
+        return -1;
+    }
+
+    char line[1024];
+    float level_err[REPLAY_LEVELS] = { 0 };
+    float c0_err = 0.0f;
+    float feature_err = 0.0f;
+    size_t rows = 0;
+    long failures = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        char* p = line;
+        char* end;
+        unsigned long frame = strtoul(p, &end, 10);
+        if (end == p || *end != ',') {
+            continue;   // Header or blank line
+        }
+        if (frame >= frames) {
+            failures++;
+            continue;
+        }
+
+        const replay_levels_t* l = &levels[frame];
+        p = end + 1;
+        for (uint32_t i = 0; i < REPLAY_LEVELS + dim; i++) {
+            float ref = strtof(p, &end);
+            if (end == p) {
+                failures++;
+                break;
+            }
+            p = (*end == ',') ? end + 1 : end;
+
+            if (i < REPLAY_LEVELS) {
+                float err = fabsf(l->level[i] - ref);
+                level_err[i] = fmaxf(level_err[i], err);
+                failures += (err > REPLAY_LEVEL_TOL_DB);
+            } else if (i == REPLAY_LEVELS) {
+                float err = fabsf(l->features[0] - ref);
+                c0_err = fmaxf(c0_err, err);
+                failures += (err > REPLAY_C0_TOL);
+            } else {
+                float err = fabsf(l->features[i - REPLAY_LEVELS] - ref);
+                feature_err = fmaxf(feature_err, err);
+                failures += (err > REPLAY_FEATURE_TOL);
+            }
+        }
+        rows++;
+    }
+    fclose(file);
+
+    if (rows < frames) {
+        failures += (long)(frames - rows);
+    }
+
+    printf("\nmax error     energy %.3f dB, noise floor %.3f dB, beam %.3f dB, "
+           "c0 %.4f, features %.4f\n", level_err[0], level_err[1], level_err[2],
+           c0_err, feature_err);
+    return failures;
+}
+
+/* Read until stopped and nothing is left */
+static void* reader_main(void* param) {
+    replay_reader_t* reader = (replay_reader_t*)param;
+    voice_span_t spans[2];
+
+    while (1) {
+        bool stopping = atomic_load(&reader->stop);
+        size_t count = voice_subscriber_peek(reader->sub, spans, SIZE_MAX, 10);
+        if (count == 0) {
+            if (stopping) {
+                break;
+            }
+            continue;
+        }
+        if (voice_subscriber_release(reader->sub, count)) {
+            reader->received += count;
+        }
+        if (reader->pause_us > 0) {
+            usleep(reader->pause_us);
+        }
+    }
+    return NULL;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+        "usage: %s [options] input.wav\n"
+        "  -o FILE   write per-frame decisions (CSV)\n"
+        "  -g FILE   compare decisions against a golden CSV\n"
+        "  -r FILE   write recorded audio (mono WAV)\n"
+        "  -m FILE   load a RAW_NN wake model (repeatable)\n"
+        "  -t VALUE  wake model threshold (default 0.5)\n"
+        "  -a DEG    steer the beam to DEG\n"
+        "  -s X      fail below X times real time\n"
+        "  -f FILE   write per-frame levels and MFCC features (CSV)\n"
+        "  -c FILE   compare levels and features against a reference CSV\n"
+        "  -p        split pipeline: wake stage on its own task\n"
+        "  -w        gate wake inference on voice activity\n"
+        "  -S        stream recordings in chunks\n"
+        "  -e        stream recordings as IMA-ADPCM (implies -S)\n"
+        "  -P MS     start recordings with MS of pre-roll\n"
+        "  -n LEVEL  noise suppression level for recordings (0-1)\n"
+        "  -C MS     calibrate the noise over the first MS of input\n"
+        "  -N MS     track the VAD noise floor over an MS window\n"
+        "  -L        capture through a fake driver with adaptive latency modes\n"
+        "  -A        track the talker and steer the beam adaptively\n"
+        "  -M FILE   add an array captured in FILE, sharing a worker pool (repeatable)\n"
+        "  -W N      pool workers for -M (default 2)\n"
+        "  -B MS     subscribe to every stream, each reader pausing MS per read\n"
+        "  -T RATE   auto-tune wake thresholds to RATE false accepts per hour\n",
+        prog);
+}
+
+int main(int argc, char** argv) {
+    const char* decisions_path = NULL;
+    const char* golden_path = NULL;
+    const char* recording_path = NULL;
+    const char* levels_path = NULL;
+    const char* reference_path = NULL;
+    const char* models[WAKE_WORD_MAX_MODELS];
+    int num_models = 0;
+    float threshold = 0.5f;
+    float min_speed = 0.0f;
+    float steer = -1.0f;
+    bool split = false;
+    bool gating = false;
+    bool streaming = false;
+    bool adpcm = false;
+    uint32_t preroll_ms = 0;
+    float suppression = 0.0f;
+    uint32_t calibrate_ms = 0;
+    uint32_t tracking_ms = 0;
+    bool latency = false;
+    bool adaptive = false;
+    const char* array_paths[VOICE_POOL_MAX_MEMBERS];
+    int num_arrays = 1;
+    voice_pool_config_t pool_config = voice_pool_get_default_config();
+    int subscriber_pause_ms = -1;
+    float false_accepts_per_hour = 0.0f;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:g:r:m:t:a:s:f:c:pwSeP:n:C:N:LAM:W:B:T:")) != -1) {
+        switch (opt) {
+            case 'o': decisions_path = optarg; break;
+            case 'g': golden_path = optarg; break;
+            case 'r': recording_path = optarg; break;
+            case 'm':
+                if (num_models < WAKE_WORD_MAX_MODELS) {
+                    models[num_models++] = optarg;
+                }
+                break;
+            case 't': threshold = strtof(optarg, NULL); break;
+            case 'a': steer = strtof(optarg, NULL); break;
+            case 's': min_speed = strtof(optarg, NULL); break;
+            case 'f': levels_path = optarg; break;
+            case 'c': reference_path = optarg; break;
+            case 'p': split = true; break;
+            case 'w': gating = true; break;
+            case 'S': streaming = true; break;
+            case 'e': streaming = adpcm = true; break;
+            case 'P': preroll_ms = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'n': suppression = strtof(optarg, NULL); break;
+            case 'C': calibrate_ms = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'N': tracking_ms = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'L': latency = true; break;
+            case 'A': adaptive = true; break;
+            case 'M':
+                if (num_arrays < VOICE_POOL_MAX_MEMBERS) {
+                    array_paths[num_arrays++] = optarg;
+                }
+                break;
+            case 'W': pool_config.num_workers = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'B': subscriber_pause_ms = atoi(optarg); break;
+            case 'T': false_accepts_per_hour = strtof(optarg, NULL); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (latency && (split || levels_path || reference_path)) {
+        fprintf(stderr, "-L cannot be combined with -p, -f or -c\n");
+        return 2;
+    }
+    if (num_arrays > 1 && (latency || levels_path || reference_path)) {
+        fprintf(stderr, "-M cannot be combined with -L, -f or -c\n");
+        return 2;
+    }
+
+    /* The first input is the lead array */
+    replay_wav_t wavs[VOICE_POOL_MAX_MEMBERS];
+    array_paths[0] = argv[optind];
+    for (int a = 0; a < num_arrays; a++) {
+        if (!wav_open(&wavs[a], array_paths[a])) {
+            fprintf(stderr, "cannot read PCM16 WAV %s\n", array_paths[a]);
+            return 2;
+        }
+        if (wavs[a].channels != VOICE_CHANNELS || wavs[a].sample_rate != VOICE_SAMPLE_RATE) {
+            fprintf(stderr, "expected %d channels at %d Hz, got %u at %u Hz\n",
+                    VOICE_CHANNELS, VOICE_SAMPLE_RATE, wavs[a].channels, wavs[a].sample_rate);
+            return 2;
+        }
+    }
+
+    /* Circular array, microphone 0 on the x axis */
+    voice_config_t config;
+    memset(&config, 0, sizeof(config));
+    for (int i = 0; i < VOICE_CHANNELS; i++) {
+        float angle = 2.0f * (float)M_PI * i / VOICE_CHANNELS;
+        config.beamform.mic_positions[i][0] = REPLAY_MIC_RADIUS_M * cosf(angle);
+        config.beamform.mic_positions[i][1] = REPLAY_MIC_RADIUS_M * sinf(angle);
+    }
+
+    voice_pipeline_config_t pipeline = voice_get_default_pipeline_config();
+    pipeline.split = split;
+    pipeline.wake_gating = gating;
+    pipeline.stream_recording = streaming;
+    pipeline.recording_encoder = adpcm ? &voice_adpcm_encoder : NULL;
+    pipeline.recording_preroll_ms = preroll_ms;
+    pipeline.noise_tracking_ms = tracking_ms;
+    pipeline.latency_control = latency;
+    pipeline.wake_false_accepts_per_hour = false_accepts_per_hour;
+    if (subscriber_pause_ms >= 0) {
+        pipeline.subscriber_streams = VOICE_STREAM_BIT(VOICE_STREAM_MONO) |
+                                      VOICE_STREAM_BIT(VOICE_STREAM_FEATURES);
+    }
+    voice_pool_t* pool = NULL;
+    if (num_arrays > 1) {
+        pool = voice_pool_create(&pool_config);
+        if (!pool) {
+            fprintf(stderr, "voice_pool_create failed\n");
+            return 1;
+        }
+        pipeline.pool = pool;
+    }
+
+    voice_context_t* arrays[VOICE_POOL_MAX_MEMBERS];
+    for (int a = 0; a < num_arrays; a++) {
+        arrays[a] = voice_init_pipeline(&config, &pipeline);
+        if (!arrays[a]) {
+            fprintf(stderr, "voice_init_pipeline failed\n");
+            return 1;
+        }
+    }
+    voice_context_t* ctx = arrays[0];
+
+    sem_init(&frame_done, 0, 0);
+    replay_tap_t tap = { .ctx = ctx };
+    audio_driver_t driver;
+    if (latency && !replay_driver_init(&driver, AUDIO_LATENCY_BALANCED)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int a = 0; a < num_arrays; a++) {
+        voice_register_audio_callback(arrays[a], on_frame, latency ? &tap : NULL);
+        if (steer >= 0.0f) {
+            voice_set_beam_direction(arrays[a], steer);
+        }
+        if (adaptive) {
+            voice_set_adaptive_beam(arrays[a], true);
+        }
+        if (voice_set_noise_suppression(arrays[a], suppression) != VOICE_OK) {
+            fprintf(stderr, "noise suppression level must be 0-1\n");
+            return 1;
+        }
+        if (calibrate_ms > 0 && voice_calibrate_noise(arrays[a], calibrate_ms) != VOICE_OK) {
+            fprintf(stderr, "noise calibration needs at least 100 ms\n");
+            return 1;
+        }
+    }
+
+    /* Readers of the lead's streams, off the DSP tasks */
+    replay_reader_t readers[VOICE_STREAM_COUNT];
+    int num_readers = 0;
+    if (subscriber_pause_ms >= 0) {
+        for (int s = 0; s < VOICE_STREAM_COUNT; s++) {
+            replay_reader_t* reader = &readers[num_readers];
+            reader->sub = voice_subscribe(ctx, (voice_stream_t)s);
+            if (!reader->sub) {
+                fprintf(stderr, "cannot subscribe to the %s stream\n", stream_names[s]);
+                return 1;
+            }
+            reader->pause_us = (uint32_t)subscriber_pause_ms * 1000u;
+            atomic_init(&reader->stop, false);
+            reader->received = 0;
+            pthread_create(&reader->thread, NULL, reader_main, reader);
+            num_readers++;
+        }
+    }
+
+    wake_engine_t* engine = voice_get_wake_engine(ctx);
+    wake_model_mapper_t mappers[WAKE_WORD_MAX_MODELS];
+    for (int i = 0; i < num_models; i++) {
+        mappers[i] = wake_file_mapper(models[i]);
+        wake_model_info_t info = {
+            .name = models[i],
+            .format = WAKE_MODEL_RAW_NN,
+            .threshold = threshold
+        };
+        if (wake_engine_load_model_mapped(engine, &info, &mappers[i]) != WAKE_OK) {
+            fprintf(stderr, "cannot load model %s\n", models[i]);
+            return 1;
+        }
+    }
+
+    /* Side chain on the same kernels: beam level and features per frame */
+    voice_beamformer_t beamformer;
+    float mic_xy[VOICE_CHANNELS][2];
+    for (int i = 0; i < VOICE_CHANNELS; i++) {
+        mic_xy[i][0] = config.beamform.mic_positions[i][0];
+        mic_xy[i][1] = config.beamform.mic_positions[i][1];
+    }
+    voice_beamform_init(&beamformer, mic_xy);
+    if (steer > 0.0f) {
+        voice_beamform_steer(&beamformer, steer);
+        voice_beamform_enable(&beamformer, true);
+    }
+    wake_feature_config_t feature_config = wake_get_default_feature_config();
+    wake_frontend_t frontend;
+    if (wake_frontend_init(&frontend, &feature_config, feature_config.frame_stride_ms) != WAKE_OK) {
+        fprintf(stderr, "wake_frontend_init failed\n");
+        return 1;
+    }
+
+    size_t frame_bytes = VOICE_FRAME_SIZE * VOICE_CHANNELS * sizeof(int16_t);
+    size_t total_frames = wavs[0].data_bytes / frame_bytes;
+    replay_decision_t* decisions =
+        (replay_decision_t*)calloc(total_frames ? total_frames : 1, sizeof(replay_decision_t));
+    replay_levels_t* levels =
+        (replay_levels_t*)calloc(total_frames ? total_frames : 1, sizeof(replay_levels_t));
+    replay_sink_t sink = {
+        .data = (uint8_t*)malloc(REPLAY_MAX_RECORDING),
+        .streaming = streaming
+    };
+    if (!decisions || !levels || !sink.data) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    tap.decisions = decisions;
+    tap.capacity = total_frames;
+    tap.sink = &sink;
+
+    voice_frame_t frame;
+    voice_frame_t extra;
+    voice_stats_t stats;
+    uint32_t prev_vad[VOICE_POOL_MAX_MEMBERS] = { 0 };
+    uint32_t prev_wake[VOICE_POOL_MAX_MEMBERS] = { 0 };
+    size_t frames = 0;
+    uint64_t frames_done = 0;
+    double start = now_seconds();
+
+    while (frames < total_frames &&
+           fread(frame.samples, 1, frame_bytes, wavs[0].file) == frame_bytes) {
+        frame.timestamp_ms = (uint32_t)(frames * 1000 / (VOICE_SAMPLE_RATE / VOICE_FRAME_SIZE));
+        frame.vad_active = false;
+
+        if (latency) {
+            /* Frames of a period are in flight together; each takes its
+             * decision as it finishes */
+            replay_driver_capture(&driver, ctx, frame.samples, VOICE_FRAME_SIZE);
+            for (; frames_done < driver.frames_queued; frames_done++) {
+                sem_wait(&frame_done);
+            }
+        } else {
+            /* One frame per array in flight keeps decisions in step with
+             * the input */
+            if (voice_process_frame(ctx, &frame) != VOICE_OK) {
+                fprintf(stderr, "frame %zu rejected\n", frames);
+                break;
+            }
+            int queued = 1;
+            for (; queued < num_arrays; queued++) {
+                if (fread(extra.samples, 1, frame_bytes, wavs[queued].file) != frame_bytes) {
+                    break;
+                }
+                extra.timestamp_ms = frame.timestamp_ms;
+                extra.vad_active = false;
+                if (voice_process_frame(arrays[queued], &extra) != VOICE_OK) {
+                    fprintf(stderr, "frame %zu rejected by array %d\n", frames, queued);
+                    break;
+                }
+            }
+            for (int a = 0; a < queued; a++) {
+                sem_wait(&frame_done);
+            }
+            if (queued < num_arrays) {
+                break;
+            }
+        }
+
+        /* Split pipeline or pool: let the wake stage drain before
+         * sampling state */
+        if (split || pool) {
+            uint32_t depth;
+            do {
+                sched_yield();
+                depth = 0;
+                for (int a = 0; a < num_arrays; a++) {
+                    voice_stats_ext_t queue;
+                    voice_get_stats_ext(arrays[a], &queue);
+                    depth += queue.wake_queue_depth;
+                }
+            } while (depth > 0);
+        }
+
+        /* Across arrays: any VAD, every detection, and the state of an
+         * array past listening */
+        replay_decision_t* d = &decisions[frames];
+        if (!latency) {
+            voice_get_stats(ctx, &stats);
+            d->timestamp_ms = frame.timestamp_ms;
+            d->vad = 0;
+            d->wake = 0;
+            d->state = (int)voice_get_state(ctx);
+            for (int a = 0; a < num_arrays; a++) {
+                voice_stats_t array_stats;
+                voice_get_stats(arrays[a], &array_stats);
+                d->vad |= (int)(array_stats.vad_activations - prev_vad[a]);
+                d->wake += (int)(array_stats.wake_detections - prev_wake[a]);
+                prev_vad[a] = array_stats.vad_activations;
+                prev_wake[a] = array_stats.wake_detections;
+
+                voice_state_t state = voice_get_state(arrays[a]);
+                if (state != VOICE_STATE_IDLE && state != VOICE_STATE_LISTENING) {
+                    d->state = (int)state;
+                }
+            }
+        }
+
+        if (levels_path || reference_path) {
+            replay_levels_t* l = &levels[frames];
+            int16_t beam[VOICE_FRAME_SIZE];
+            uint64_t beam_squares;
+            voice_beamform_process(&beamformer, frame.samples, beam);
+            voice_dsp_sum_squares(beam, VOICE_FRAME_SIZE, 1, &beam_squares);
+
+            l->level[0] = stats.avg_energy_db;
+            l->level[1] = stats.noise_floor_db;
+            l->level[2] = VOICE_DB_TO_FLOAT(voice_dsp_level_db(beam_squares, VOICE_FRAME_SIZE));
+
+            /* Features of microphone 0, so both paths see the same input;
+             * the one-frame window's last row is the newest frame */
+            int16_t mic[VOICE_FRAME_SIZE];
+            wake_feature_view_t view;
+            for (int i = 0; i < VOICE_FRAME_SIZE; i++) {
+                mic[i] = frame.samples[i * VOICE_CHANNELS];
+            }
+            wake_frontend_push(&frontend, mic, VOICE_FRAME_SIZE);
+            if (wake_frontend_window(&frontend, &view)) {
+                memcpy(l->features, &view.data[(view.frames - 1) * view.stride],
+                       view.dim * sizeof(float));
+            }
+        }
+
+        if (!latency) {
+            for (int a = 0; a < num_arrays; a++) {
+                collect_recording(arrays[a], &sink, (int)voice_get_state(arrays[a]));
+            }
+        }
+
+        /* Virtual time follows the audio */
+        shim_tick_advance(pdMS_TO_TICKS(1000 * VOICE_FRAME_SIZE / VOICE_SAMPLE_RATE));
+        frames++;
+    }
+
+    /* A partial period at the end of the input is never delivered */
+    if (latency) {
+        frames = (size_t)frames_done;
+    }
+
+    double elapsed = now_seconds() - start;
+    for (int r = 0; r < num_readers; r++) {
+        atomic_store(&readers[r].stop, true);
+        pthread_join(readers[r].thread, NULL);
+    }
+    double audio_seconds = (double)frames * VOICE_FRAME_SIZE / VOICE_SAMPLE_RATE;
+    double speed = elapsed > 0.0 ? audio_seconds / elapsed : 0.0;
+
+    voice_stats_ext_t ext;
+    voice_get_stats_ext(ctx, &ext);
+
+    printf("frames        %zu (%.2f s audio)\n", frames, audio_seconds);
+    printf("throughput    %.0f frames/s, %.1fx real time\n",
+           elapsed > 0.0 ? frames / elapsed : 0.0, speed);
+    printf("cpu usage     %.1f%% of a %.0f us frame budget\n",
+           ext.base.cpu_usage_percent, ext.frame_budget_us);
+    voice_dsp_kernels_t kernels;
+    voice_dsp_select_kernels(&kernels, VOICE_CHANNELS, VOICE_FRAME_SIZE);
+    printf("kernels       %u ch x %u samples, %s\n", kernels.channels,
+           kernels.frame_size, kernels.specialized ? "specialized" : "generic");
+    printf("vad frames    %u\n", ext.base.vad_activations);
+    printf("wake          %u\n", ext.base.wake_detections);
+    voice_trace_t trace;
+    voice_get_trace(ctx, &trace);
+    if (trace.trace_id > 0) {
+        printf("last trace    #%u at %u ms, decided %u ms after queueing, ", trace.trace_id,
+               trace.audio_ms, trace.wake_ms - trace.queued_ms);
+        if (trace.recording) {
+            printf("still recording\n");
+        } else {
+            printf("recorded for %u ms\n", trace.recording_stop_ms - trace.recording_start_ms);
+        }
+    }
+    printf("overruns      %u, queue high water %u/%u\n",
+           ext.base.buffer_overruns, ext.frame_queue_high_water, ext.frame_queue_length);
+    printf("wake gate     %u off, %u features, %u inference, %u backfills\n",
+           ext.wake_gate_frames[WAKE_GATE_OFF], ext.wake_gate_frames[WAKE_GATE_FEATURES],
+           ext.wake_gate_frames[WAKE_GATE_FULL], ext.wake_backfills);
+    printf("noise floor   %.1f dB, %u calibrations, channels", ext.base.noise_floor_db,
+           ext.noise_calibrations);
+    for (int i = 0; i < VOICE_CHANNELS; i++) {
+        printf(" %.1f", ext.channel_floor_db[i]);
+    }
+    printf("\n");
+    if (false_accepts_per_hour > 0.0f) {
+        wake_tuning_stats_t tuning;
+        wake_engine_get_tuning_stats(voice_get_wake_engine(ctx), &tuning);
+        printf("tuning        band %u at %.1f dB, %u retunes, %u skipped, %u false accepts, "
+               "threshold/pooling", tuning.band, tuning.noise_floor_db, tuning.retunes,
+               tuning.skipped, tuning.false_accepts);
+        for (int m = 0; m < num_models; m++) {
+            printf(" %.2f/%u", tuning.threshold[m], tuning.pooling[m]);
+        }
+        printf("\n");
+    }
+    if (adaptive) {
+        printf("beam          %.0f deg after %u moves, confidence %.2f\n",
+               ext.beam_angle_deg, ext.beam_steers, ext.doa_confidence);
+    }
+    if (latency) {
+        printf("latency       %u switches asked, %u applied, periods %zu low, %zu balanced, "
+               "%zu low-power, %u rejected\n", ext.latency_switches, driver.stats.latency_switches,
+               driver.periods[AUDIO_LATENCY_LOW], driver.periods[AUDIO_LATENCY_BALANCED],
+               driver.periods[AUDIO_LATENCY_LOW_POWER], driver.stats.buffer_overruns);
+    }
+    if (split) {
+        printf("wake queue    high water %u/%u, %u dropped\n", ext.wake_queue_high_water,
+               ext.wake_queue_length, ext.wake_queue_drops);
+    }
+    if (pool) {
+        voice_pool_stats_t pool_stats;
+        voice_pool_get_stats(pool, &pool_stats);
+        printf("pool          %u arrays, %u workers, %u periods (%u partial), "
+               "%u wake passes, %u switches, wins", pool_stats.members,
+               pool_config.num_workers, pool_stats.slots, pool_stats.partial_slots,
+               pool_stats.wake_passes, pool_stats.source_switches);
+        for (uint32_t a = 0; a < pool_stats.members; a++) {
+            printf(" %u", pool_stats.wins[a]);
+        }
+        printf("\n");
+        for (int a = 1; a < num_arrays; a++) {
+            voice_stats_ext_t array_ext;
+            voice_get_stats_ext(arrays[a], &array_ext);
+            printf("array %d       %u vad frames, %u wake, noise floor %.1f dB\n", a,
+                   array_ext.base.vad_activations, array_ext.base.wake_detections,
+                   array_ext.base.noise_floor_db);
+        }
+    }
+    if (num_readers > 0) {
+        printf("subscribers   ");
+        for (int r = 0; r < num_readers; r++) {
+            voice_subscriber_stats_t sub_stats;
+            voice_subscriber_get_stats(readers[r].sub, &sub_stats);
+            printf("%s%s %llu read, %u lost (%u overruns)", r ? "; " : "",
+                   stream_names[sub_stats.stream], (unsigned long long)readers[r].received,
+                   sub_stats.dropped, sub_stats.overruns);
+        }
+        printf("\n");
+    }
+    printf("recording     %zu bytes", sink.bytes);
+    if (streaming) {
+        printf(" in %zu chunks, %zu bytes payload", sink.chunks, sink.payload_bytes);
+    }
+    printf("\n");
+    printf("\n%-10s %10s %10s %10s %10s %8s\n",
+           "stage", "min us", "avg us", "p99 us", "max us", "count");
+    for (int i = 0; i < VOICE_STAGE_COUNT; i++) {
+        const voice_stage_stats_t* s = &ext.stages[i];
+        printf("%-10s %10.2f %10.2f %10.2f %10.2f %8u\n", stage_names[i],
+               s->min_us, s->avg_us, s->p99_us, s->max_us, s->count);
+    }
+
+    int status = 0;
+
+    if (decisions_path) {
+        FILE* out = fopen(decisions_path, "w");
+        if (out) {
+            fprintf(out, "frame,timestamp_ms,vad,wake,state\n");
+            for (size_t i = 0; i < frames; i++) {
+                fprintf(out, "%zu,%u,%d,%d,%s\n", i, decisions[i].timestamp_ms,
+                        decisions[i].vad, decisions[i].wake,
+                        state_names[decisions[i].state]);
+            }
+            fclose(out);
+        } else {
+            fprintf(stderr, "cannot write %s\n", decisions_path);
+            status = 1;
+        }
+    }
+
+    if (recording_path && !wav_write_mono(recording_path, sink.data, sink.bytes)) {
+        fprintf(stderr, "cannot write %s\n", recording_path);
+        status = 1;
+    }
+
+    if (levels_path && !write_levels(levels_path, levels, frames, frontend.dim)) {
+        fprintf(stderr, "cannot write %s\n", levels_path);
+        status = 1;
+    }
+
+    if (reference_path) {
+        long failures = compare_levels(reference_path, levels, frames, frontend.dim);
+        printf("reference     %s\n", failures == 0 ? "match" : "MISMATCH");
+        if (failures != 0) {
+            printf("out of range  %ld values\n", failures);
+            status = 1;
+        }
+    }
+
+    if (golden_path) {
+        long mismatches = compare_golden(golden_path, decisions, frames);
+        printf("\ngolden        %s\n", mismatches == 0 ? "match" : "MISMATCH");
+        if (mismatches != 0) {
+            printf("mismatches    %ld frames\n", mismatches);
+            status = 1;
+        }
+    }
+
+    if (min_speed > 0.0f && speed < min_speed) {
+        printf("speed         %.1fx below required %.1fx\n", speed, min_speed);
+        status = 1;
+    }
+
+    for (int r = 0; r < num_readers; r++) {
+        voice_unsubscribe(readers[r].sub);
+    }
+
+    /* The pool stops before its members */
+    voice_pool_deinit(pool);
+    for (int a = 0; a < num_arrays; a++) {
+        voice_deinit(arrays[a]);
+    }
+    if (latency) {
+        replay_driver_deinit(&driver);
+    }
+    wake_frontend_deinit(&frontend);
+    for (int a = 0; a < num_arrays; a++) {
+        fclose(wavs[a].file);
+    }
+    free(decisions);
+    free(levels);
+    free(sink.data);
+    return status;
+}
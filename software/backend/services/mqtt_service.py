@@ -16,6 +16,8 @@ from aiomqtt import Client, MqttError
 from contextlib import asynccontextmanager
 from dataclasses import dataclass, field
 
+from .voice_telemetry import is_telemetry_topic, decode_payload
+
 # Configure logging
 logger = logging.getLogger(__name__)
 
@@ -198,13 +200,19 @@ class MQTTService:
         """Process incoming message"""
         try:
             topic = str(message.topic)
-            payload = message.payload.decode('utf-8')
             
-            # Try to parse as JSON
-            try:
-                data = json.loads(payload)
-            except json.JSONDecodeError:
-                data = payload
+            # Batched voice telemetry is binary; everything else is text
+            if is_telemetry_topic(topic):
+                data = decode_payload(message.payload)
+                payload = f"<telemetry frame, {len(message.payload)} bytes>"
+            else:
+                payload = message.payload.decode('utf-8')
+                
+                # Try to parse as JSON
+                try:
+                    data = json.loads(payload)
+                except json.JSONDecodeError:
+                    data = payload
                 
             self.stats["messages_received"] += 1
             
@@ -16,6 +16,8 @@ import aiohttp
 from aiohttp import web
 import weakref
 
+from .voice_telemetry import is_telemetry_topic, decode_payload
+
 logger = logging.getLogger(__name__)
 
 
@@ -195,7 +197,7 @@ class MQTTService:
                         
                         # Decode payload
                         topic = message.topic
-                        payload = self._decode_payload(message.payload)
+                        payload = self._decode_payload(topic, message.payload)
                         
                         # Process message
                         await self._process_message(topic, payload)
@@ -266,8 +268,10 @@ class MQTTService:
             retain=True
         )
         
-    def _decode_payload(self, payload: bytes) -> Any:
-        """Decode message payload"""
+    def _decode_payload(self, topic, payload: bytes) -> Any:
+        """Decode message payload; telemetry topics carry binary frames"""
+        if is_telemetry_topic(topic):
+            return decode_payload(payload)
         try:
             return json.loads(payload.decode())
         except json.JSONDecodeError:
@@ -0,0 +1,130 @@
+"""
+W.I.T. Voice Telemetry Decoder
+
+Decodes the batched binary telemetry frames voice terminals publish on
+wit/voice/telemetry/<device_id> (TelemetryBatch in
+firmware/core/voice/voice_processor.py). All values are little-endian:
+
+  header  "WVT", version u8, flags u8, device id (u8 length + UTF-8),
+          window start f64 (unix s), samples u16, events u16,
+          total commands u32, average latency f32 (ms)
+  sample  offset u16 (ms), noise level i16 (0.01 dB),
+          signal quality u8 (1/255), VAD confidence u8 (1/255),
+          flags u8 (1 = speech, 2 = listening)
+  event   offset u16 (ms), type (u8 length + UTF-8),
+          data (u16 length + JSON)
+"""
+import json
+import logging
+import struct
+from typing import Any, Dict, Union
+
+TOPIC = "wit/voice/telemetry/+"
+MAGIC = b"WVT"
+VERSION = 1
+
+SPEECH = 0x01
+LISTENING = 0x02
+
+_PREFIX = struct.Struct("<3sBBB")
+_WINDOW = struct.Struct("<dHHIf")
+_SAMPLE = struct.Struct("<HhBBB")
+_EVENT = struct.Struct("<HB")
+_LENGTH = struct.Struct("<H")
+
+logger = logging.getLogger(__name__)
+
+
+class TelemetryError(ValueError):
+    """Malformed or unsupported telemetry frame"""
+
+
+def is_telemetry_topic(topic) -> bool:
+    """Check whether a topic carries telemetry frames (matches TOPIC)"""
+    parts = str(topic).split("/")
+    return len(parts) == 4 and parts[:3] == TOPIC.split("/")[:3] and parts[3] != ""
+
+
+def is_telemetry_frame(payload: bytes) -> bool:
+    """Check whether a payload is a binary telemetry frame"""
+    return isinstance(payload, (bytes, bytearray)) and payload[:3] == MAGIC
+
+
+def decode_frame(payload: bytes) -> Dict[str, Any]:
+    """
+    Decode a telemetry frame
+
+    Samples come back in the same shape as the JSON voice_metrics event,
+    with absolute timestamps; events as {"type", "timestamp", "data"}.
+    """
+    try:
+        magic, version, _flags, id_len = _PREFIX.unpack_from(payload, 0)
+        if magic != MAGIC:
+            raise TelemetryError("not a telemetry frame")
+        if version != VERSION:
+            raise TelemetryError(f"unsupported telemetry version {version}")
+        offset = _PREFIX.size
+
+        device_id = bytes(payload[offset:offset + id_len]).decode("utf-8")
+        offset += id_len
+
+        start, num_samples, num_events, total_commands, avg_latency = \
+            _WINDOW.unpack_from(payload, offset)
+        offset += _WINDOW.size
+
+        samples = []
+        for _ in range(num_samples):
+            dt_ms, noise, quality, vad, flags = _SAMPLE.unpack_from(payload, offset)
+            offset += _SAMPLE.size
+            samples.append({
+                "noise_level_db": noise / 100.0,
+                "signal_quality": quality / 255.0,
+                "is_speech": bool(flags & SPEECH),
+                "vad_confidence": vad / 255.0,
+                "is_listening": bool(flags & LISTENING),
+                "timestamp": start + dt_ms / 1000.0
+            })
+
+        events = []
+        for _ in range(num_events):
+            dt_ms, name_len = _EVENT.unpack_from(payload, offset)
+            offset += _EVENT.size
+            name = bytes(payload[offset:offset + name_len]).decode("utf-8")
+            offset += name_len
+            (data_len,) = _LENGTH.unpack_from(payload, offset)
+            offset += _LENGTH.size
+            data = json.loads(bytes(payload[offset:offset + data_len]).decode("utf-8"))
+            offset += data_len
+            events.append({
+                "type": name,
+                "timestamp": start + dt_ms / 1000.0,
+                "data": data
+            })
+    except (struct.error, UnicodeDecodeError, json.JSONDecodeError) as e:
+        raise TelemetryError(f"truncated or corrupt telemetry frame: {e}") from e
+
+    if offset != len(payload):
+        raise TelemetryError("trailing bytes after telemetry frame")
+
+    return {
+        "device_id": device_id,
+        "timestamp": start,
+        "total_commands": total_commands,
+        "avg_latency_ms": avg_latency,
+        "samples": samples,
+        "events": events
+    }
+
+
+def decode_payload(payload: bytes) -> Union[Dict[str, Any], bytes]:
+    """
+    Decode a telemetry frame for delivery to subscribers
+
+    A malformed frame is logged and passed through as its raw bytes, so
+    one bad terminal cannot stop a service's message loop.
+    """
+    try:
+        return decode_frame(payload)
+    except TelemetryError as e:
+        logger.warning(f"Passing malformed telemetry frame through raw: {e}")
+        return payload
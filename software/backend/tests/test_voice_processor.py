@@ -0,0 +1,164 @@
+# software/backend/tests/test_voice_processor.py
+"""
+Test the terminal-side voice processor (firmware/core/voice/voice_processor.py)
+"""
+import pytest
+
+import sys
+import os
+sys.path.insert(0, os.path.join(
+    os.path.dirname(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))),
+    "firmware", "core", "voice"))
+
+np = pytest.importorskip("numpy")
+for module in ("pyaudio", "webrtcvad", "speech_recognition", "asyncio_mqtt"):
+    pytest.importorskip(module)
+
+import voice_processor as vp
+
+
+class StrictVad:
+    """
+    Accepts only the frame lengths webrtcvad accepts, sized from len(buf);
+    anything louder than 500 is speech
+    """
+
+    def __init__(self):
+        self.frames = []
+
+    def is_speech(self, buf, sample_rate):
+        samples = len(buf) // 2
+        if samples * 1000 not in (10 * sample_rate, 20 * sample_rate, 30 * sample_rate):
+            raise ValueError("Error while processing frame")
+        self.frames.append(samples)
+        return bool(np.abs(np.frombuffer(buf, dtype=np.int16)).max() > 500)
+
+
+class RecordingRecognizer(vp.StreamingRecognizer):
+    """Keeps the audio it is fed and recognizes nothing"""
+
+    def __init__(self):
+        self.audio = []
+        self.finished = False
+
+    def reset(self):
+        self.audio = []
+
+    def accept(self, audio):
+        self.audio.append(audio.copy())
+
+    def finish(self):
+        self.finished = True
+
+
+@pytest.fixture
+def processor(monkeypatch):
+    """Processor without an audio device"""
+    monkeypatch.setattr(vp.pyaudio, "PyAudio", lambda: None)
+    processor = vp.WITVoiceProcessor({"device_id": "terminal-01",
+                                      "end_of_utterance_silence": 0.3})
+    processor.vad = StrictVad()
+    return processor
+
+
+def capture(processor, level, slices):
+    """Deliver slices VAD slices of a constant level"""
+    chunk = np.full(processor.vad_slice * slices, level, dtype=np.int16)
+    processor._audio_callback(chunk.tobytes(), len(chunk), None, 0)
+
+
+class TestVoiceProcessor:
+    """Test audio analysis in the voice processor"""
+
+    def test_vad_gets_whole_slices(self, processor):
+        capture(processor, 1000, 2)
+
+        assert processor.vad.frames == [processor.vad_slice] * 2
+        assert processor.metrics.is_speech
+        assert processor.metrics.vad_confidence == pytest.approx(0.2)
+
+    @pytest.mark.asyncio
+    async def test_streams_command_from_wake_position(self, processor):
+        recognizer = processor.asr = RecordingRecognizer()
+
+        async def no_timeout():
+            pass
+
+        def detect_once(audio_chunk):
+            processor.is_running = False  # One pass of the detection loop
+            return True
+
+        processor._listening_timeout = no_timeout
+        processor._detect_wake_word = detect_once
+        processor.is_running = True
+
+        capture(processor, 1000, 10)  # Wake word
+        await processor._wake_word_detection_loop()
+        assert processor.is_listening
+
+        # The command starts before the recognizer's first pass
+        capture(processor, 2000, 6)
+        capture(processor, 0, 11)
+        await processor._stream_from_ring()
+
+        fed = np.concatenate(recognizer.audio)
+        assert len(fed) == processor.vad_slice * 17
+        assert fed[0] == 2000 and fed[-1] == 0
+        # 330 ms of silence ends the utterance well before the timeout
+        assert recognizer.finished
+        assert not processor.is_listening
+
+
+class TestLatencyTelemetry:
+    """Test utterance traces and the latency histogram"""
+
+    def test_stages_from_milestones(self):
+        trace = vp.UtteranceTrace("t1", capture=10.0, wake=10.2, speech_end=11.0,
+                                  upload=11.05, asr=11.3, route=11.31)
+        stages = trace.stages_ms()
+
+        assert stages["dsp"] == pytest.approx(200.0)
+        assert stages["listen"] == pytest.approx(800.0)
+        assert stages["upload"] == pytest.approx(50.0)
+        assert stages["recognition"] == pytest.approx(250.0)
+        assert stages["routing"] == pytest.approx(10.0)
+        assert stages["total"] == pytest.approx(1310.0)
+
+    def test_device_stages_take_precedence(self):
+        trace = vp.UtteranceTrace("t2", capture=10.0, wake=10.2, route=11.0,
+                                  device_ms={"dsp": 120.0})
+        stages = trace.stages_ms()
+
+        assert stages["dsp"] == pytest.approx(120.0)
+        assert "listen" not in stages
+        assert stages["total"] == pytest.approx(1000.0)
+
+    def test_total_sums_reached_stages(self):
+        # No capture or route milestone: the total adds up what was timed
+        trace = vp.UtteranceTrace("t3", wake=1.0, speech_end=1.5, upload=1.4,
+                                  device_ms={"dsp": 30.0})
+        stages = trace.stages_ms()
+
+        assert stages["listen"] == pytest.approx(500.0)
+        assert stages["upload"] == 0.0  # Clamped, clocks disagree
+        assert stages["total"] == pytest.approx(530.0)
+
+    def test_percentile_is_bucket_edge(self):
+        histogram = vp.LatencyHistogram()
+        for ms in (5, 15, 15, 40, 3000):
+            histogram.add({"asr": ms})
+
+        assert histogram.count == 5
+        assert histogram.percentile("asr", 0.0) == 10.0
+        assert histogram.percentile("asr", 0.5) == 20.0
+        # The bucket edge never reports more than was seen
+        assert histogram.percentile("asr", 0.9) == 3000.0
+
+    def test_percentile_past_last_bound(self):
+        histogram = vp.LatencyHistogram()
+        histogram.add({"route": 7.0, "dsp": 7.0})
+        histogram.add({"route": 8000.0})
+
+        assert histogram.percentile("dsp", 0.5) == 7.0
+        assert histogram.percentile("route", 0.5) == 10.0
+        assert histogram.percentile("route", 0.99) == 8000.0
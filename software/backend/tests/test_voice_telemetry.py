@@ -0,0 +1,145 @@
+# software/backend/tests/test_voice_telemetry.py
+"""
+Test decoding of batched voice telemetry frames
+"""
+import json
+import struct
+import pytest
+
+import sys
+import os
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from services.voice_telemetry import (
+    decode_frame, decode_payload, is_telemetry_frame, is_telemetry_topic, TelemetryError,
+    SPEECH, LISTENING
+)
+
+FIRMWARE_VOICE = os.path.join(
+    os.path.dirname(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))),
+    "firmware", "core", "voice")
+
+
+def build_frame(device_id=b"terminal-01", start=1700000000.5, samples=(), events=(),
+                total_commands=3, avg_latency=120.0, version=1):
+    """Frame as TelemetryBatch.encode() lays it out"""
+    frame = struct.pack("<3sBBB", b"WVT", version, 0, len(device_id)) + device_id
+    frame += struct.pack("<dHHIf", start, len(samples), len(events),
+                         total_commands, avg_latency)
+    for sample in samples:
+        frame += struct.pack("<HhBBB", *sample)
+    for dt_ms, name, data in events:
+        body = json.dumps(data).encode()
+        frame += struct.pack("<HB", dt_ms, len(name)) + name
+        frame += struct.pack("<H", len(body)) + body
+    return frame
+
+
+class TestVoiceTelemetry:
+    """Test the binary telemetry frame decoder"""
+
+    def test_detects_frames(self):
+        assert is_telemetry_frame(build_frame())
+        assert not is_telemetry_frame(b'{"noise_level_db": -40}')
+        assert not is_telemetry_frame("WVT")
+
+    def test_detects_topics(self):
+        assert is_telemetry_topic("wit/voice/telemetry/terminal-01")
+        assert not is_telemetry_topic("wit/voice/telemetry")
+        assert not is_telemetry_topic("wit/voice/telemetry/terminal-01/extra")
+        assert not is_telemetry_topic("wit/voice/events/terminal-01")
+        assert not is_telemetry_topic("wit/telemetry/terminal-01")
+
+    def test_decodes_samples_and_events(self):
+        frame = build_frame(
+            samples=[(0, -4250, 255, 0, 0), (1000, -3000, 128, 255, SPEECH | LISTENING)],
+            events=[(1500, b"wake_word_detected", {"confidence": 0.95})]
+        )
+        decoded = decode_frame(frame)
+
+        assert decoded["device_id"] == "terminal-01"
+        assert decoded["total_commands"] == 3
+        assert decoded["avg_latency_ms"] == pytest.approx(120.0)
+
+        first, second = decoded["samples"]
+        assert first["noise_level_db"] == pytest.approx(-42.5)
+        assert first["signal_quality"] == pytest.approx(1.0)
+        assert not first["is_speech"] and not first["is_listening"]
+        assert second["timestamp"] == pytest.approx(1700000001.5)
+        assert second["vad_confidence"] == pytest.approx(1.0)
+        assert second["is_speech"] and second["is_listening"]
+
+        (event,) = decoded["events"]
+        assert event["type"] == "wake_word_detected"
+        assert event["timestamp"] == pytest.approx(1700000002.0)
+        assert event["data"] == {"confidence": 0.95}
+
+    def test_rejects_bad_frames(self):
+        frame = build_frame(samples=[(0, -4000, 10, 20, 0)])
+        with pytest.raises(TelemetryError):
+            decode_frame(frame[:-1])
+        with pytest.raises(TelemetryError):
+            decode_frame(frame + b"\x00")
+        with pytest.raises(TelemetryError):
+            decode_frame(build_frame(version=2))
+
+    def test_passes_bad_frames_through(self, caplog):
+        frame = build_frame()
+        assert decode_payload(frame)["device_id"] == "terminal-01"
+        with caplog.at_level("WARNING"):
+            assert decode_payload(frame[:-1]) == frame[:-1]
+        assert "malformed telemetry frame" in caplog.text
+
+
+@pytest.fixture
+def voice_processor():
+    """The terminal-side encoder, when its dependencies are installed"""
+    pytest.importorskip("numpy")
+    for module in ("pyaudio", "webrtcvad", "speech_recognition", "asyncio_mqtt"):
+        pytest.importorskip(module)
+    sys.path.insert(0, FIRMWARE_VOICE)
+    try:
+        import voice_processor
+    finally:
+        sys.path.remove(FIRMWARE_VOICE)
+    return voice_processor
+
+
+class TestTelemetryRoundTrip:
+    """Decode frames built by TelemetryBatch.encode()"""
+
+    def test_round_trip(self, voice_processor):
+        vp = voice_processor
+        batch = vp.TelemetryBatch("terminal-01")
+        batch.add_sample(vp.AudioMetrics(-42.5, 1.0, False, 0.0), False, 1700000000.5)
+        batch.add_sample(vp.AudioMetrics(-30.0, 0.5, True, 1.0), True, 1700000001.5)
+        batch.add_event("wake_word_detected", {"confidence": 0.95}, 1700000002.0)
+        frame = batch.encode(total_commands=3, avg_latency_ms=120.0)
+
+        assert is_telemetry_frame(frame)
+        assert len(batch) == 0
+        decoded = decode_frame(frame)
+
+        assert decoded["device_id"] == "terminal-01"
+        assert decoded["timestamp"] == pytest.approx(1700000000.5)
+        assert decoded["total_commands"] == 3
+        assert decoded["avg_latency_ms"] == pytest.approx(120.0)
+
+        first, second = decoded["samples"]
+        assert first["noise_level_db"] == pytest.approx(-42.5)
+        assert not first["is_speech"] and not first["is_listening"]
+        assert second["timestamp"] == pytest.approx(1700000001.5)
+        assert second["signal_quality"] == pytest.approx(0.5, abs=1 / 255)
+        assert second["is_speech"] and second["is_listening"]
+
+        (event,) = decoded["events"]
+        assert event["type"] == "wake_word_detected"
+        assert event["timestamp"] == pytest.approx(1700000002.0)
+        assert event["data"] == {"confidence": 0.95}
+
+    def test_long_device_id_keeps_whole_characters(self, voice_processor):
+        # 128 two-byte characters: a byte cut at 255 would split the last
+        batch = voice_processor.TelemetryBatch("\u00e9" * 128)
+        decoded = decode_frame(batch.encode(total_commands=0, avg_latency_ms=0.0))
+
+        assert decoded["device_id"] == "\u00e9" * 127